@@ -1,7 +1,31 @@
 #define ANKERL_NANOBENCH_IMPLEMENT
 #include <ilias/platform.hpp>
 #include <ilias/task.hpp>
+#include <ilias/sync/mpmc.hpp>
+#include <ilias/sync/mpsc.hpp>
+#include <ilias/sync/spsc.hpp>
+#include <ilias/sync/broadcast.hpp>
+#include <ilias/sync/rwlock.hpp>
+#include <ilias/sync/mutex.hpp>
+#include <ilias/sync/notify.hpp>
+#include <ilias/sync/event.hpp>
+#include <ilias/net/udp.hpp>
+#include <ilias/net/tcp.hpp>
+#include <ilias/net/dns.hpp>
+#include <ilias/fs/file.hpp>
 #include <nanobench.h>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <array>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <thread>
 
 auto nop() -> ilias::Task<void> {
     co_return;
@@ -11,6 +35,696 @@ auto yield() -> ilias::Task<void> {
     co_await ilias::this_coro::yield();
 }
 
+#if defined(ILIAS_TASK_LOCAL)
+auto taskLocal() -> ilias::Task<void> {
+    static ilias::TaskLocal<int> locals[8];
+    for (auto &local : locals) {
+        co_await local.set(42);
+    }
+    ankerl::nanobench::Bench {}.run("TaskLocal lookup", [&] {
+        ankerl::nanobench::doNotOptimizeAway(locals[7].get());
+    });
+
+    // The map based approach, keyed by the slot
+    auto map = std::unordered_map<size_t, std::shared_ptr<void> > {};
+    for (auto &local : locals) {
+        map.emplace(local.slot(), std::make_shared<int>(42));
+    }
+    ankerl::nanobench::Bench {}.run("unordered_map lookup", [&] {
+        auto it = map.find(locals[7].slot());
+        ankerl::nanobench::doNotOptimizeAway(it->second.get());
+    });
+}
+#endif // defined(ILIAS_TASK_LOCAL)
+
+auto busy() -> ilias::Task<void> {
+    while (true) { // NOTE: Don't put the co_await in the condition, gcc 12 miscompiles it
+        auto stop = co_await ilias::this_coro::isStopRequested();
+        if (stop) {
+            co_return;
+        }
+        co_await ilias::this_coro::yield();
+    }
+}
+
+auto yieldWith(ilias::Priority priority) -> ilias::Task<void> {
+    co_await ilias::this_coro::setPriority(priority);
+    co_await ilias::this_coro::yield();
+}
+
+// The latency of yield, while the executor is full of busy tasks at the load priority
+// NOTE: The blocking wait() only returns after the queue drained, so we measure it inside a task
+auto mixedLoad(ilias::Priority load) -> ilias::Task<void> {
+    auto handles = std::vector<ilias::WaitHandle<void> > {};
+    for (int i = 0; i < 32; i++) {
+        handles.emplace_back(ilias::spawn(busy(), {.priority = load}));
+    }
+    auto name = std::string {load == ilias::Priority::Normal ? "normal load" : "background load"};
+    for (auto priority : {ilias::Priority::Normal, ilias::Priority::High}) {
+        constexpr auto N = 10000;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; i++) {
+            co_await yieldWith(priority);
+        }
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+        std::printf("| %12.2f ns/op | Yield at %s with %s\n", ns, priority == ilias::Priority::High ? "High" : "Normal", name.c_str());
+    }
+    for (auto &handle : handles) {
+        handle.stop();
+    }
+    for (auto &handle : handles) {
+        co_await std::move(handle);
+    }
+}
+
+// The cost of moving the coroutine between two executors (round trip = 2 hops)
+auto hop() -> ilias::Task<void> {
+    auto &home = co_await ilias::this_coro::executor();
+    auto loop = ilias::EventLoop {};
+    auto source = std::stop_source {};
+    auto thread = std::thread([&]() {
+        loop.install();
+        loop.run(source.get_token());
+        loop.uninstall();
+    });
+
+    constexpr auto N = 100000;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        co_await ilias::this_coro::switchTo(loop);
+        co_await ilias::this_coro::switchTo(home);
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (N * 2);
+    std::printf("| %12.2f ns/op | Switch executor (%.0f hops/s)\n", ns, 1e9 / ns);
+
+    // Many tasks move at once, by the batch
+    constexpr auto M = 64;
+    auto batch = ilias::SwitchBatch {loop};
+    auto back = ilias::SwitchBatch {home};
+    auto worker = [&]() -> ilias::Task<void> {
+        for (int i = 0; i < N / M; i++) {
+            co_await ilias::this_coro::switchTo(batch);
+            co_await ilias::this_coro::switchTo(back);
+        }
+    };
+    auto tasks = std::vector<ilias::Task<void> > {};
+    for (int i = 0; i < M; i++) {
+        tasks.emplace_back(worker());
+    }
+    begin = std::chrono::steady_clock::now();
+    co_await ilias::whenAll(std::move(tasks));
+    ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / ((N / M) * M * 2);
+    std::printf("| %12.2f ns/op | Switch executor in batch of %d (%.0f hops/s)\n", ns, M, 1e9 / ns);
+
+    source.request_stop();
+    thread.join();
+}
+
+// The throughput of the mpmc channel, half of the threads send, the others receive
+auto mpmcScaling() -> void {
+    constexpr auto N = 1 << 20;
+    for (auto threads : {2, 4, 8, 16, 32}) {
+        auto [sender, receiver] = ilias::mpmc::channel<size_t>(1024);
+        auto workers = std::vector<std::thread> {};
+        auto producers = threads / 2;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < producers; i++) {
+            workers.emplace_back([sender, producers]() {
+                for (size_t j = 0; j < N / producers; j++) {
+                    (void) sender.blockingSend(j);
+                }
+            });
+            workers.emplace_back([receiver]() mutable {
+                while (receiver.blockingRecv()) {}
+            });
+        }
+        sender.close();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+        std::printf("| %12.2f ns/op | Mpmc channel with %d threads (%.0f items/s)\n", ns, threads, 1e9 / ns);
+    }
+}
+
+// The throughput of one producer thread to one consumer thread
+auto pipeline() -> void {
+    constexpr auto N = 1 << 22;
+    auto report = [](auto begin, const char *name) {
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+        std::printf("| %12.2f ns/op | %s (%.0f items/s)\n", ns, name, 1e9 / ns);
+    };
+    {
+        auto [sender, receiver] = ilias::mpsc::channel<size_t>(1024);
+        auto begin = std::chrono::steady_clock::now();
+        auto thread = std::thread([&]() {
+            for (size_t i = 0; i < N; i++) {
+                (void) sender.blockingSend(i);
+            }
+            sender.close();
+        });
+        while (receiver.blockingRecv()) {}
+        thread.join();
+        report(begin, "Mpsc channel pipeline");
+    }
+    {
+        auto [sender, receiver] = ilias::spsc::channel<size_t>(1024);
+        auto begin = std::chrono::steady_clock::now();
+        auto thread = std::thread([&]() {
+            for (size_t i = 0; i < N; i++) {
+                (void) sender.blockingSend(i);
+            }
+            sender.close();
+        });
+        while (receiver.blockingRecv()) {}
+        thread.join();
+        report(begin, "Spsc channel pipeline");
+    }
+}
+
+// Deliver each item to 1k subscribers, by the broadcast channel, or one mpsc channel per subscriber
+auto fanout() -> ilias::Task<void> {
+    constexpr auto Subscribers = 1000;
+    constexpr auto N = 1000;
+    auto report = [](auto begin, const char *name) {
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (N * Subscribers);
+        std::printf("| %12.2f ns/op | %s to %d subscribers (%.0f deliveries/s)\n", ns, name, Subscribers, 1e9 / ns);
+    };
+    {
+        auto [sender, receiver] = ilias::broadcast::channel<size_t>(N);
+        auto group = ilias::TaskGroup<void> {};
+        for (int i = 0; i < Subscribers; i++) {
+            group.spawn([](auto receiver) -> ilias::Task<void> {
+                while (true) {
+                    auto res = co_await receiver.recv();
+                    if (!res) {
+                        co_return;
+                    }
+                }
+            }(receiver));
+        }
+        receiver.close();
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < N; i++) {
+            (void) sender.send(i);
+        }
+        sender.close();
+        co_await group.waitAll();
+        report(begin, "Broadcast channel");
+    }
+    {
+        auto senders = std::vector<ilias::mpsc::Sender<size_t> > {};
+        auto group = ilias::TaskGroup<void> {};
+        for (int i = 0; i < Subscribers; i++) {
+            auto [sender, receiver] = ilias::mpsc::channel<size_t>(N);
+            senders.emplace_back(std::move(sender));
+            group.spawn([](auto receiver) -> ilias::Task<void> {
+                while (co_await receiver.recv()) {}
+            }(std::move(receiver)));
+        }
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < N; i++) {
+            for (auto &sender : senders) {
+                (void) sender.trySend(i);
+            }
+        }
+        senders.clear();
+        co_await group.waitAll();
+        report(begin, "Mpsc channel per subscriber");
+    }
+}
+
+// The items/s of the batch api, the producer runs on another thread, batch 1 uses the single item api
+template <typename Sender, typename Receiver>
+auto batchThroughput(Sender sender, Receiver receiver, size_t batch, const char *name) -> ilias::Task<void> {
+    constexpr size_t N = 1 << 20;
+    auto begin = std::chrono::steady_clock::now();
+    auto thread = std::thread([&, sender = std::move(sender)]() mutable {
+        auto loop = ilias::EventLoop {};
+        loop.install();
+        [&]() -> ilias::Task<void> {
+            auto items = std::vector<size_t>(batch);
+            for (size_t i = 0; i < N; i += batch) {
+                if (batch == 1) {
+                    (void) co_await sender.send(i);
+                }
+                else {
+                    co_await sender.sendMany(items);
+                }
+            }
+            sender.close();
+        }().wait();
+        loop.uninstall();
+    });
+    auto out = std::vector<size_t> {};
+    while (true) {
+        size_t n = 0;
+        if (batch == 1) {
+            auto item = co_await receiver.recv();
+            n = item ? 1 : 0;
+        }
+        else {
+            out.clear();
+            n = co_await receiver.recvMany(out, batch);
+        }
+        if (n == 0) {
+            break;
+        }
+    }
+    thread.join();
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+    std::printf("| %12.2f ns/op | %s with batch %zu (%.0f items/s)\n", ns, name, batch, 1e9 / ns);
+}
+
+auto batching() -> ilias::Task<void> {
+    for (size_t batch : {1, 16, 256}) {
+        auto [sender, receiver] = ilias::mpsc::channel<size_t>(1024);
+        co_await batchThroughput(std::move(sender), std::move(receiver), batch, "Mpsc channel");
+    }
+    for (size_t batch : {1, 16, 256}) {
+        auto [sender, receiver] = ilias::mpmc::channel<size_t>(1024);
+        co_await batchThroughput(std::move(sender), std::move(receiver), batch, "Mpmc channel");
+    }
+}
+
+// The read-heavy workload, 1 write per 1000 ops, the lookup is done under the lock
+auto readHeavy() -> void {
+    constexpr auto N = 1 << 18;
+    auto table = std::unordered_map<int, int> {};
+    for (int i = 0; i < 1024; i++) {
+        table[i] = i;
+    }
+    auto run = [&](int threads, const char *name, auto read, auto write) {
+        auto workers = std::vector<std::thread> {};
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([&, i]() {
+                for (int j = 0; j < N / threads; j++) {
+                    if (j % 1000 == 0) {
+                        write(j);
+                        continue;
+                    }
+                    read((i + j) & 1023);
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+        std::printf("| %12.2f ns/op | %s with %d threads (%.0f ops/s)\n", ns, name, threads, 1e9 / ns);
+    };
+    for (auto threads : {1, 4, 16}) {
+        auto mutex = ilias::Mutex {};
+        run(threads, "Read-heavy Mutex",
+            [&](int key) {
+                auto _ = mutex.blockingLock();
+                ankerl::nanobench::doNotOptimizeAway(table.find(key));
+            },
+            [&](int key) {
+                auto _ = mutex.blockingLock();
+                table[key & 1023] = key;
+            }
+        );
+        auto rwmutex = ilias::RwMutex {};
+        run(threads, "Read-heavy RwMutex",
+            [&](int key) {
+                auto _ = rwmutex.blockingRead();
+                ankerl::nanobench::doNotOptimizeAway(table.find(key));
+            },
+            [&](int key) {
+                auto _ = rwmutex.blockingWrite();
+                table[key & 1023] = key;
+            }
+        );
+    }
+}
+
+// The mutex contended by 1k waiters (4 threads x 256 tasks), the lock is held across a yield, so the others queue up
+auto contendedMutex(ilias::sync::Fairness fairness, const char *name) -> void {
+    constexpr auto Threads = 4;
+    constexpr auto Tasks = 256;
+    constexpr auto Rounds = 16;
+    auto mutex = ilias::Mutex {fairness};
+    auto latencies = std::vector<std::vector<double> >(Threads);
+    auto workers = std::vector<std::thread> {};
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < Threads; i++) {
+        workers.emplace_back([&, i]() {
+            auto loop = ilias::EventLoop {};
+            loop.install();
+            auto worker = [&]() -> ilias::Task<void> {
+                for (int j = 0; j < Rounds; j++) {
+                    auto start = std::chrono::steady_clock::now();
+                    auto guard = co_await mutex.lock();
+                    latencies[i].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                    co_await ilias::this_coro::yield();
+                }
+            };
+            auto tasks = std::vector<ilias::Task<void> > {};
+            for (int j = 0; j < Tasks; j++) {
+                tasks.emplace_back(worker());
+            }
+            [&]() -> ilias::Task<void> {
+                co_await ilias::whenAll(std::move(tasks));
+            }().wait();
+            loop.uninstall();
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (Threads * Tasks * Rounds);
+    auto all = std::vector<double> {};
+    for (auto &vec : latencies) {
+        all.insert(all.end(), vec.begin(), vec.end());
+    }
+    std::sort(all.begin(), all.end());
+    std::printf("| %12.2f ns/op | Contended %s mutex with %d waiters (p50 %.0f us, p99 %.0f us, max %.0f us)\n",
+        ns, name, Threads * Tasks, all[all.size() / 2], all[all.size() * 99 / 100], all.back()
+    );
+}
+
+// The producer / consumer signal, the producer thread publishes the count and signals, the consumer drains on each wakeup
+template <typename Signal>
+auto signal(const char *name, Signal &sig, auto notify, auto wait) -> ilias::Task<void> {
+    constexpr auto N = 1 << 20;
+    auto produced = std::atomic<int> {0};
+    auto begin = std::chrono::steady_clock::now();
+    auto thread = std::thread([&]() {
+        for (int i = 0; i < N; i++) {
+            produced.fetch_add(1, std::memory_order_release);
+            notify(sig);
+        }
+    });
+    auto consumed = 0;
+    auto wakeups = 0;
+    while (consumed < N) {
+        co_await wait(sig);
+        consumed = produced.load(std::memory_order_acquire);
+        wakeups += 1;
+    }
+    thread.join();
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+    std::printf("| %12.2f ns/op | Signal by %s (%.0f items/s, %d wakeups)\n", ns, name, 1e9 / ns, wakeups);
+}
+
+auto signals() -> ilias::Task<void> {
+    auto event = ilias::Event {ilias::Event::AutoClear};
+    co_await signal("Event", event, [](ilias::Event &e) { e.set(); }, [](ilias::Event &e) { return e.wait(); });
+    auto notify = ilias::Notify {};
+    co_await signal("Notify", notify, [](ilias::Notify &n) { n.notifyOne(); }, [](ilias::Notify &n) { return n.notified(); });
+}
+
+// The loopback udp pps, each round sends a window of datagrams then receives them back, per datagram or batched
+auto udpRoundTrips(bool batched) -> ilias::Task<void> {
+    constexpr size_t N = 1 << 18;
+    constexpr size_t Window = ilias::UdpSocket::MaxBatch;
+    auto receiver = (co_await ilias::UdpSocket::bind("127.0.0.1:0")).value();
+    auto sender = (co_await ilias::UdpSocket::bind("127.0.0.1:0")).value();
+    auto endpoint = receiver.localEndpoint().value();
+    auto payload = std::array<std::byte, 64> {};
+    auto storage = std::vector<std::array<std::byte, 64> >(Window);
+    auto packets = std::vector<ilias::UdpPacket>(Window, ilias::UdpPacket {payload, endpoint});
+    auto buffers = std::vector<ilias::UdpPacketBuffer>(Window);
+    for (size_t i = 0; i < Window; i++) {
+        buffers[i].buffer = ilias::makeBuffer(storage[i]);
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < N; round += Window) {
+        for (size_t sent = 0; sent < Window; ) {
+            if (!batched) {
+                (void) co_await sender.sendto(payload, endpoint);
+                sent += 1;
+                continue;
+            }
+            sent += (co_await sender.sendMany(std::span(packets).subspan(sent))).value();
+        }
+        for (size_t received = 0; received < Window; ) {
+            if (!batched) {
+                (void) co_await receiver.recvfrom(buffers[0].buffer);
+                received += 1;
+                continue;
+            }
+            received += (co_await receiver.recvMany(std::span(buffers).subspan(received))).value();
+        }
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+    std::printf("| %12.2f ns/op | Udp loopback %s (%.0f pps)\n", ns, batched ? "sendMany / recvMany" : "sendto / recvfrom", 1e9 / ns);
+}
+
+#if defined(UDP_SEGMENT) && defined(UDP_GRO)
+// The loopback udp throughput of equal sized datagrams, per datagram sendto / recvfrom or one GSO send / GRO recv per round
+auto udpSegments(bool offload) -> ilias::Task<void> {
+    constexpr size_t N = 1 << 18;
+    constexpr size_t Segment = 1200;
+    constexpr size_t Window = 32;
+    auto receiver = (co_await ilias::UdpSocket::bind("127.0.0.1:0")).value();
+    auto sender = (co_await ilias::UdpSocket::bind("127.0.0.1:0")).value();
+    auto endpoint = receiver.localEndpoint().value();
+    if (offload) {
+        receiver.setOption(ilias::sockopt::UdpGro(true)).value();
+    }
+    auto payload = std::vector<std::byte>(Segment * Window);
+    auto buffer = std::vector<std::byte>(65536);
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < N; round += Window) {
+        if (offload) {
+            (co_await sender.sendSegments(payload, Segment, endpoint)).value();
+        }
+        for (size_t i = 0; !offload && i < Window; i++) {
+            (void) co_await sender.sendto(std::span(payload).first(Segment), endpoint);
+        }
+        for (size_t received = 0; received < payload.size(); ) {
+            if (offload) {
+                received += (co_await receiver.recvSegments(buffer)).value().size;
+                continue;
+            }
+            received += (co_await receiver.recvfrom(buffer)).value().first;
+        }
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+    std::printf("| %12.2f ns/op | Udp loopback %s (%.0f MB/s)\n", ns, offload ? "GSO / GRO" : "sendto / recvfrom", Segment * 1e3 / ns);
+}
+#endif // defined(UDP_SEGMENT) && defined(UDP_GRO)
+
+// The loopback tcp relay throughput, writer => (proxy copy) => reader, by the buffered copy or the splice copy
+auto tcpRelay(bool splice) -> ilias::Task<void> {
+    constexpr size_t N = size_t(1) << 30;
+    auto frontend = (co_await ilias::TcpListener::bind("127.0.0.1:0")).value();
+    auto backend = (co_await ilias::TcpListener::bind("127.0.0.1:0")).value();
+    auto writer = (co_await ilias::TcpStream::connect(frontend.localEndpoint().value())).value();
+    auto [in, _] = (co_await frontend.accept()).value();
+    auto out = (co_await ilias::TcpStream::connect(backend.localEndpoint().value())).value();
+    auto [reader, _2] = (co_await backend.accept()).value();
+    auto begin = std::chrono::steady_clock::now();
+    auto produce = ilias::spawn([&]() -> ilias::Task<void> {
+        auto chunk = std::vector<std::byte>(256 * 1024);
+        for (size_t i = 0; i < N; i += chunk.size()) {
+            (void) co_await writer.writeAll(chunk);
+        }
+        (void) co_await writer.shutdown();
+    });
+    auto consume = ilias::spawn([&]() -> ilias::Task<void> {
+        auto buffer = std::vector<std::byte>(256 * 1024);
+        while (true) {
+            auto n = co_await reader.read(buffer);
+            if (!n || *n == 0) {
+                break;
+            }
+        }
+    });
+    auto copied = splice ? co_await ilias::io::copy(out, in) : co_await ilias::io::copyBuffered(out, in);
+    (void) co_await out.shutdown();
+    co_await std::move(produce);
+    co_await std::move(consume);
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("| %12.2f GB/s  | Tcp loopback relay by %s (%zu bytes)\n", N / secs / 1e9, splice ? "splice" : "buffered copy", copied.value_or(0));
+}
+
+// The large file served to a loopback tcp peer, by pread + write or sendFile, the cpu time includes the peer
+auto fileTransfer(bool sendFile) -> ilias::Task<void> {
+    constexpr size_t Size = 256 * 1024 * 1024;
+    constexpr size_t Rounds = 4;
+    auto path = std::filesystem::temp_directory_path() / "ilias_benchmark_sendfile.bin";
+    std::ofstream(path, std::ios::binary).seekp(Size - 1).put('\0');
+    auto file = (co_await ilias::File::open(path)).value();
+    auto listener = (co_await ilias::TcpListener::bind("127.0.0.1:0")).value();
+    auto sender = (co_await ilias::TcpStream::connect(listener.localEndpoint().value())).value();
+    auto [peer, _] = (co_await listener.accept()).value();
+    auto consume = ilias::spawn([&]() -> ilias::Task<void> {
+        auto buffer = std::vector<std::byte>(256 * 1024);
+        while (true) {
+            auto n = co_await peer.read(buffer);
+            if (!n || *n == 0) {
+                break;
+            }
+        }
+    });
+    auto cpu = std::clock();
+    auto begin = std::chrono::steady_clock::now();
+    auto buffer = std::vector<std::byte>(256 * 1024);
+    for (size_t round = 0; round < Rounds; round++) {
+        if (sendFile) {
+            (void) co_await sender.sendFile(file, 0, Size);
+            continue;
+        }
+        for (size_t offset = 0; offset < Size; offset += buffer.size()) {
+            auto n = (co_await file.pread(buffer, offset)).value();
+            (void) co_await sender.writeAll(std::span(buffer).first(n));
+        }
+    }
+    (void) co_await sender.shutdown();
+    co_await std::move(consume);
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    auto cpuSecs = double(std::clock() - cpu) / CLOCKS_PER_SEC;
+    auto gb = Size * Rounds / 1e9;
+    std::printf("| %12.2f GB/s  | File to tcp loopback by %s (%.3f cpu s/GB)\n", gb / secs, sendFile ? "sendFile" : "pread + write", cpuSecs / gb);
+    file.close();
+    std::filesystem::remove(path);
+}
+
+// The connections accepted per second, one accept per wake vs acceptMany draining the backlog, the clients connect in bursts
+auto connectionRate(bool many) -> ilias::Task<void> {
+    constexpr size_t N = 10000;
+    constexpr size_t Burst = 64;
+    auto listener = (co_await ilias::TcpListener::bind("127.0.0.1:0", 1024)).value();
+    auto endpoint = listener.localEndpoint().value();
+    auto accepted = size_t(0);
+    auto server = ilias::spawn([&]() -> ilias::Task<void> {
+        while (accepted < N) {
+            if (many) {
+                auto clients = co_await listener.acceptMany(Burst);
+                accepted += clients ? clients->size() : 0;
+            }
+            else {
+                auto client = co_await listener.accept();
+                accepted += client ? 1 : 0;
+            }
+        }
+    });
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; i += Burst) {
+        auto burst = std::vector<ilias::TcpStream> {};
+        for (size_t j = 0; j < Burst && i + j < N; j++) {
+            burst.emplace_back((co_await ilias::TcpStream::connect(endpoint)).value());
+        }
+        co_await ilias::this_coro::yield(); // Let the server drain the burst
+    }
+    co_await std::move(server);
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("| %12.0f conn/s | Tcp loopback accept by %s\n", N / secs, many ? "acceptMany" : "accept");
+}
+
+// The request latency on a new connection, connect then write vs the payload in the SYN by TCP Fast Open (one round trip saved),
+// the server side fast open needs the net.ipv4.tcp_fastopen sysctl bit 0x2, otherwise both take the same path
+auto fastOpen(bool enabled) -> ilias::Task<void> {
+    constexpr size_t N = 10000;
+    static constexpr size_t Size = 64;
+    auto listener = (co_await ilias::TcpBuilder {AF_INET}.option(ilias::sockopt::TcpFastOpen(256)).bind("127.0.0.1:0", 1024)).value();
+    auto endpoint = listener.localEndpoint().value();
+    auto server = ilias::spawn([&]() -> ilias::Task<void> {
+        auto buffer = std::array<std::byte, Size> {};
+        for (size_t i = 0; i < N; i++) {
+            auto client = (co_await listener.accept()).value();
+            (void) co_await client.first.readAll(buffer);
+            (void) co_await client.first.writeAll(buffer);
+        }
+    });
+    auto request = std::array<std::byte, Size> {};
+    auto response = std::array<std::byte, Size> {};
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; i++) {
+        auto stream = ilias::TcpStream {};
+        if (enabled) {
+            stream = (co_await ilias::TcpBuilder {AF_INET}.connect(endpoint, request)).value();
+        }
+        else {
+            stream = (co_await ilias::TcpBuilder {AF_INET}.connect(endpoint)).value();
+            (void) co_await stream.writeAll(request);
+        }
+        (void) co_await stream.readAll(response);
+    }
+    co_await std::move(server);
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / N;
+    std::printf("| %12.2f ns/op | Tcp loopback request on a new connection by %s\n", ns, enabled ? "fast open" : "connect + write");
+}
+
+// The lookups per second, getaddrinfo (by the hosts, so no network is involved) vs the native resolver (by the hosts or a loopback server)
+auto dnsLookups() -> ilias::Task<void> {
+    constexpr size_t N = 20000;
+    auto server = (co_await ilias::UdpSocket::bind("127.0.0.1:0")).value();
+    auto responder = ilias::spawn([&]() -> ilias::Task<void> { // Answer any query with 127.0.0.1
+        auto buf = std::array<uint8_t, 1500> {};
+        while (true) {
+            auto res = co_await server.recvfrom(ilias::makeBuffer(buf));
+            if (!res) {
+                break;
+            }
+            auto [n, from] = *res;
+            auto reply = std::vector<uint8_t>(buf.begin(), buf.begin() + n - 11); // Drop the OPT record
+            reply[2] = 0x81;
+            reply[3] = 0x80;
+            reply[7] = 1;
+            reply[11] = 0;
+            auto record = std::array<uint8_t, 16> {0xC0, 0x0C, 0, 1, 0, 1, 0, 0, 0, 60, 0, 4, 127, 0, 0, 1};
+            reply.insert(reply.end(), record.begin(), record.end());
+            (void) co_await server.sendto(ilias::makeBuffer(reply), from);
+        }
+    });
+    auto run = [&](const char *name, auto fn) -> ilias::Task<void> {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < N; i++) {
+            auto ok = co_await fn();
+            if (!ok) {
+                std::printf("%s failed\n", name);
+                co_return;
+            }
+        }
+        auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::printf("| %12.2f us/op | Dns lookup by %s (%.0f lookups/s)\n", secs * 1e6 / N, name, N / secs);
+    };
+    auto hints = ilias::addrinfo_t {};
+    hints.ai_family = AF_INET;
+    co_await run("getaddrinfo (hosts)", [&]() -> ilias::Task<bool> {
+        co_return bool(co_await ilias::AddressInfo::fromHostname("localhost", {}, hints));
+    });
+    auto config = ilias::DnsResolver::systemConfig();
+    config.nameservers = {server.localEndpoint().value()};
+    auto resolver = ilias::DnsResolver {config};
+    co_await run("DnsResolver (hosts)", [&]() -> ilias::Task<bool> {
+        co_return bool(co_await resolver.resolve("localhost", AF_INET));
+    });
+    co_await run("DnsResolver (loopback server)", [&]() -> ilias::Task<bool> {
+        co_return bool(co_await resolver.resolve("bench.test.", AF_INET));
+    });
+    responder.stop();
+    co_await std::move(responder);
+}
+
+auto network() -> void {
+    auto thread = std::thread([]() { // The main loop has no io, run it on a platform context
+        auto ctxt = ilias::PlatformContext {};
+        ctxt.install();
+        udpRoundTrips(false).wait();
+        udpRoundTrips(true).wait();
+#if defined(UDP_SEGMENT) && defined(UDP_GRO)
+        udpSegments(false).wait();
+        udpSegments(true).wait();
+#endif // defined(UDP_SEGMENT) && defined(UDP_GRO)
+        tcpRelay(false).wait();
+        tcpRelay(true).wait();
+        fileTransfer(false).wait();
+        fileTransfer(true).wait();
+        dnsLookups().wait();
+        connectionRate(false).wait();
+        connectionRate(true).wait();
+        fastOpen(false).wait();
+        fastOpen(true).wait();
+    });
+    thread.join();
+}
+
 auto main(int argc, char** argv) -> int {
     ilias::EventLoop ctxt;
     ctxt.install();
@@ -28,4 +742,20 @@ auto main(int argc, char** argv) -> int {
     ankerl::nanobench::Bench {}.run("Create and yield task", [&] {
         yield().wait();
     });
+
+#if defined(ILIAS_TASK_LOCAL)
+    taskLocal().wait();
+#endif // defined(ILIAS_TASK_LOCAL)
+    mixedLoad(ilias::Priority::Normal).wait();
+    mixedLoad(ilias::Priority::Background).wait();
+    hop().wait();
+    mpmcScaling();
+    pipeline();
+    fanout().wait();
+    batching().wait();
+    readHeavy();
+    contendedMutex(ilias::sync::Fairness::Barging, "barging");
+    contendedMutex(ilias::sync::Fairness::Fifo, "fifo");
+    signals().wait();
+    network();
 }
\ No newline at end of file
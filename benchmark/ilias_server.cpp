@@ -1,9 +1,11 @@
 #include <ilias/platform.hpp>
+#include <ilias/sharded.hpp>
 #include <ilias/task.hpp>
 #include <ilias/net.hpp>
 #include <iostream>
 #include <string>
 #include <array>
+#include <cstdlib>
 
 using namespace ilias;
 
@@ -47,11 +49,38 @@ auto doAccept(TcpListener &listener) -> IoTask<void> {
     co_return {};
 }
 
-void ilias_main() {
-    auto listener = (co_await TcpListener::bind("127.0.0.1:8081")).value(); 
+auto acceptAll(TcpListener listener) -> Task<void> {
     auto vector = std::vector<IoTask<void> > {};
     for (int i = 0; i < 32; ++i) {
         vector.emplace_back(doAccept(listener));
     }
     co_await whenAll(std::move(vector));
 }
+
+// Usage: ilias_server [--shards N], N = 0 on one shard per cpu
+auto main(int argc, char **argv) -> int {
+    auto sharded = false;
+    auto shards = size_t {0};
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--shards") {
+            sharded = true;
+            shards = (i + 1 < argc) ? std::strtoul(argv[++i], nullptr, 10) : 0;
+        }
+    }
+    if (sharded) { // Thread-per-core, each shard has its own listener on the same port
+        auto runtime = ShardedRuntime { {.shards = shards, .cpuSteering = true} };
+        std::cout << "Running on " << runtime.size() << " shards" << std::endl;
+        runtime.run([](Shard &shard) -> Task<void> {
+            auto listener = (co_await shard.bind("127.0.0.1:8081")).value();
+            co_await acceptAll(std::move(listener));
+        });
+        return 0;
+    }
+    PlatformContext context;
+    context.install();
+    [&]() -> Task<void> {
+        auto listener = (co_await TcpListener::bind("127.0.0.1:8081")).value();
+        co_await acceptAll(std::move(listener));
+    }().wait();
+    return 0;
+}
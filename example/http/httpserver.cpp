@@ -38,16 +38,21 @@ auto statusString(int statusCode) -> const char * {
     }
 }
 
-auto sendReply(BufStream<TcpStream> &stream, int statusCode, std::span<const std::byte> content) -> IoTask<void> {
+auto sendHeaders(BufStream<TcpStream> &stream, int statusCode, uint64_t contentLength) -> IoTask<void> {
     char headers[1024] {0};
     ::sprintf(headers, 
-        "HTTP/1.1 %d %s\r\nContent-Length: %d\r\nConnection: keep-alive\r\nServer: ILIAS\r\n\r\n", 
+        "HTTP/1.1 %d %s\r\nContent-Length: %llu\r\nConnection: keep-alive\r\nServer: ILIAS\r\n\r\n", 
         statusCode, 
         statusString(statusCode), 
-        int(content.size())
+        (unsigned long long) contentLength
     );
     auto buffer = std::string_view {headers};
     ILIAS_CO_TRYV(co_await stream.writeAll(makeBuffer(buffer)));
+    co_return {};
+}
+
+auto sendReply(BufStream<TcpStream> &stream, int statusCode, std::span<const std::byte> content) -> IoTask<void> {
+    ILIAS_CO_TRYV(co_await sendHeaders(stream, statusCode, content.size()));
     ILIAS_CO_TRYV(co_await stream.writeAll(content));
     co_return {};
 }
@@ -116,17 +121,22 @@ auto handleFilesytem(BufStream<TcpStream> &client, std::string_view pathString)
         co_return co_await sendReply(client, 200, html);
     }
     else {
-        // Read file
+        // Send file, without reading it into the user space
         auto file = co_await File::open(path);
         if (!file) {
             co_return co_await sendReply(client, 500, "<html>Internal Server Error</html>");
         }
-        auto size = (co_await file->size()).value();
-        auto buffer = std::vector<std::byte>(size, std::byte{0});
-        if (auto val = co_await file->readAll(buffer); !val || *val != buffer.size()) {
+        auto size = co_await file->size();
+        if (!size) {
             co_return co_await sendReply(client, 500, "<html>Internal Server Error</html>");
         }
-        co_return co_await sendReply(client, 200, buffer);
+        ILIAS_CO_TRYV(co_await sendHeaders(client, 200, *size));
+        ILIAS_CO_TRYV(co_await client.flush()); // The body is sent to the socket directly, flush the headers first
+        ILIAS_CO_TRY(auto sent, co_await client.nextLayer().sendFile(*file, 0, *size));
+        if (sent != *size) { // The file is truncated while sending, the connection can't be reused
+            co_return Err(IoError::UnexpectedEOF);
+        }
+        co_return {};
     }
 }
 
@@ -6,6 +6,8 @@
 
 ILIAS_NS_BEGIN
 
+class IoContext;
+
 /**
  * @brief The webui for the console
  * 
@@ -32,6 +34,15 @@ public:
      * @return std::string_view 
      */
     auto endpoint() const -> std::string_view;
+
+    /**
+     * @brief Add the io context to the metrics panel (/api/metrics) of the webui (thread safe)
+     * @note The context must outlive the webui, the one in the installed thread is added by install()
+     * 
+     * @param name The display name, like "shard-0"
+     * @param ctxt 
+     */
+    auto addContext(std::string_view name, IoContext &ctxt) -> void;
 private:
     struct Impl;
     std::unique_ptr<Impl> d;
@@ -44,6 +55,7 @@ inline TracingWebUi::TracingWebUi(std::string_view) {}
 inline TracingWebUi::~TracingWebUi() {}
 inline auto TracingWebUi::install() -> bool { return false; }
 inline auto TracingWebUi::endpoint() const -> std::string_view { return {}; }
+inline auto TracingWebUi::addContext(std::string_view, IoContext &) -> void {}
 #endif
 
 ILIAS_NS_END
\ No newline at end of file
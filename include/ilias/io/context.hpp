@@ -11,6 +11,7 @@
 #pragma once
 
 #include <ilias/runtime/executor.hpp>
+#include <ilias/runtime/metrics.hpp>
 #include <ilias/task/task.hpp>
 #include <ilias/io/traits.hpp>
 #include <ilias/io/error.hpp>
@@ -27,6 +28,8 @@ class MsgHdr;
 class IoContext;
 class EndpointView;
 class MutableMsgHdr;
+struct MMsgHdr;
+struct MutableMMsgHdr;
 class MutableEndpointView;
 
 /**
@@ -52,6 +55,7 @@ public:
         Unknown,  //< Unknown type, let the backend decide by os api
         Pollable, //< Unknown type, but a pollable object, such as a timer, eventfd, etc.
         User,     //< User defined type, used for custom more type for backend
+        Accepted, //< Socket returned by the accept of the same context, the backend trusts the flags it set (non-blocking, close-on-exec)
     };
 protected:
     IoDescriptor() = default;
@@ -116,7 +120,7 @@ public:
      * 
      * @param fd The fd must be a listening socket
      * @param remoteEndpoint The endpoint of the remote, if nullptr, the endpoint will be ignored
-     * @return IoTask<socket_t> 
+     * @return IoTask<socket_t> The socket, it can be added by addDescriptor with IoDescriptor::Accepted
      */
     virtual auto accept(IoDescriptor *fd, MutableEndpointView remoteEndpoint) -> IoTask<socket_t> = 0;
 
@@ -171,6 +175,77 @@ public:
      * @return IoTask<size_t> 
      */
     virtual auto recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> IoTask<size_t> = 0;
+
+    /**
+     * @brief Send multiple messages to a socket in one go (like sendmmsg)
+     * @note The default implementation sends them one by one by sendmsg
+     * 
+     * @param fd The fd must be a socket
+     * @param msgs The messages to send, the len of each sent message is set to the bytes sent
+     * @param flags The flags to use, like MSG_DONTWAIT
+     * @return IoTask<size_t> The num of the messages sent (at least one on success)
+     */
+    virtual auto sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t>;
+
+    /**
+     * @brief Receive multiple messages from a socket in one go (like recvmmsg)
+     * @note The default implementation only receives one message by recvmsg
+     * 
+     * @param fd The fd must be a socket
+     * @param msgs The messages to receive into, the len of each received message is set to the bytes received
+     * @param flags The flags to use, like MSG_DONTWAIT
+     * @return IoTask<size_t> The num of the messages received (at least one on success)
+     */
+    virtual auto recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t>;
+
+    /**
+     * @brief Move the data from the descriptor into the pipe in the kernel, without copying to the user space (like splice)
+     * @note The default implementation returns IoError::OperationNotSupported
+     * 
+     * @param fd The descriptor to read from (like a socket)
+     * @param pipe The write end of the pipe
+     * @param len The max bytes to move
+     * @return IoTask<size_t> The bytes moved (0 on EOF)
+     */
+    virtual auto spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t>;
+
+    /**
+     * @brief Move the data from the pipe into the descriptor in the kernel, without copying to the user space (like splice)
+     * @note The default implementation returns IoError::OperationNotSupported
+     * 
+     * @param fd The descriptor to write to (like a socket)
+     * @param pipe The read end of the pipe
+     * @param len The max bytes to move
+     * @return IoTask<size_t> The bytes moved
+     */
+    virtual auto spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t>;
+
+    /**
+     * @brief Send the content of the file to the socket in the kernel (like sendfile)
+     * @note The default implementation returns IoError::OperationNotSupported
+     * 
+     * @param fd The descriptor to send to (like a socket)
+     * @param file The file to send from, its offset is not changed
+     * @param offset The offset in the file
+     * @param len The max bytes to send
+     * @return IoTask<size_t> The bytes sent (0 on the end of the file)
+     */
+    virtual auto sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t>;
+
+    /**
+     * @brief Take a snapshot of the runtime metrics (thread safe)
+     * @note The default implementation only fills the queue stats
+     * 
+     * @return RuntimeMetrics 
+     */
+    virtual auto metrics() const -> RuntimeMetrics;
+
+    /**
+     * @brief Get the heartbeat of the loop, used by the Watchdog
+     * 
+     * @return runtime::Heartbeat * (nullptr on not supported)
+     */
+    virtual auto heartbeat() noexcept -> runtime::Heartbeat * { return nullptr; }
     
     /**
      * @brief Get the current thread io context
@@ -292,6 +367,26 @@ public:
         return context()->recvmsg(mDesc.get(), args...);
     }
 
+    auto sendmmsg(auto &&...args) const {
+        return context()->sendmmsg(mDesc.get(), args...);
+    }
+
+    auto recvmmsg(auto &&...args) const {
+        return context()->recvmmsg(mDesc.get(), args...);
+    }
+
+    auto spliceRead(auto &&...args) const {
+        return context()->spliceRead(mDesc.get(), args...);
+    }
+
+    auto spliceWrite(auto &&...args) const {
+        return context()->spliceWrite(mDesc.get(), args...);
+    }
+
+    auto sendfile(auto &&...args) const {
+        return context()->sendfile(mDesc.get(), args...);
+    }
+
     // Operators
     auto operator <=>(const IoHandle &other) const noexcept = default;
     auto operator =(IoHandle &&other) noexcept -> IoHandle & = default;
@@ -344,6 +439,7 @@ inline auto toString(IoDescriptor::Type type) -> std::string_view {
         case Type::Pipe: return "Pipe"; 
         case Type::Tty: return "Tty"; 
         case Type::Unknown: return "Unknown"; 
+        case Type::Accepted: return "Accepted"; 
         default: return "Unknown"; 
     }
 }
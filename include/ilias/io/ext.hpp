@@ -10,12 +10,16 @@
  */
 #pragma once
 
+#include <ilias/task/when_all.hpp> // whenAll
+#include <ilias/task/when_any.hpp> // whenAny
+#include <ilias/sync/event.hpp> // Event
 #include <ilias/task/task.hpp>
 #include <ilias/io/traits.hpp>
 #include <ilias/io/error.hpp>
 #include <ilias/buffer.hpp>
 #include <concepts>
 #include <cstddef>
+#include <utility> // std::pair
 #include <span>
 #include <bit>
 
@@ -64,6 +68,43 @@
 
 ILIAS_NS_BEGIN
 
+/**
+ * @brief The pipe pair used as the kernel buffer for splice, owned by one copy call and closed with it
+ * 
+ */
+class ILIAS_API SplicePipe {
+public:
+    static constexpr size_t Capacity = 1024 * 1024; //< The bytes moved per splice, the pipe is resized to it if possible
+
+    SplicePipe(SplicePipe &&other) noexcept;
+    ~SplicePipe();
+
+    auto reader() const noexcept -> fd_t { return mReader; }
+    auto writer() const noexcept -> fd_t { return mWriter; }
+
+    /**
+     * @brief Create a new pipe, the coroutine using it may resume on another thread, so it is not pooled per thread
+     * 
+     * @return IoResult<SplicePipe> (IoError::OperationNotSupported if the platform doesn't support splice)
+     */
+    static auto make() -> IoResult<SplicePipe>;
+
+    /**
+     * @brief Check the error of splice means the descriptor doesn't support it, then use the buffered copy instead
+     * 
+     * @param ec 
+     * @return true 
+     * @return false 
+     */
+    static auto isUnsupported(const std::error_code &ec) -> bool;
+private:
+    SplicePipe(fd_t reader, fd_t writer) noexcept : mReader(reader), mWriter(writer) {}
+
+    fd_t mReader;
+    fd_t mWriter;
+    bool mOwned = true;
+};
+
 // Utility functions for io traits
 namespace io {
 
@@ -259,7 +300,7 @@ inline auto getline(T &stream, std::string_view delim = "\n") -> IoTask<std::str
 
 
 /**
- * @brief Copy all data from src to dst
+ * @brief Copy all data from src to dst through a buffer in the user space
  * 
  * @note This function will read until EOF(0)
  * @tparam T 
@@ -269,7 +310,7 @@ inline auto getline(T &stream, std::string_view delim = "\n") -> IoTask<std::str
  * @return IoTask<size_t> The total number of bytes copied, or error if any read or write fails
  */
 template <Writable T, Readable U>
-inline auto copy(T &dst, U &src) -> IoTask<size_t> {
+inline auto copyBuffered(T &dst, U &src) -> IoTask<size_t> {
     std::byte buffer[1024 * 8]; // 8KB buffer, change the size if needed
     size_t written = 0;
     while (true) {
@@ -283,6 +324,105 @@ inline auto copy(T &dst, U &src) -> IoTask<size_t> {
     co_return written;
 }
 
+/**
+ * @brief Copy all data from src to dst
+ * 
+ * @note This function will read until EOF(0)
+ * @tparam T 
+ * @tparam U 
+ * @param dst The stream to write to
+ * @param src The stream to read from
+ * @return IoTask<size_t> The total number of bytes copied, or error if any read or write fails
+ */
+template <Writable T, Readable U>
+inline auto copy(T &dst, U &src) -> IoTask<size_t> {
+    return io::copyBuffered(dst, src);
+}
+
+/**
+ * @brief Copy all data from src to dst in the kernel (splice through a pipe created for this call), no copying to the user space
+ * 
+ * @note This function will read until EOF(0), it falls back to the buffered copy if the splice is not supported
+ * @note The pipe is resized to SplicePipe::Capacity (1 MiB) and held until the copy returns. The pipe buffers are charged to the user,
+ *       past /proc/sys/fs/pipe-user-pages-soft the resize silently fails and the new pipes only get 2 pages, so the throughput drops.
+ *       Use io::copyBuffered for a large number of long lived copies, or raise the limit.
+ * @tparam T 
+ * @tparam U 
+ * @param dst The stream to write to
+ * @param src The stream to read from
+ * @return IoTask<size_t> The total number of bytes copied, or error if any read or write fails
+ */
+template <Spliceable T, Spliceable U>
+inline auto copy(T &dst, U &src) -> IoTask<size_t> {
+    auto pipe = SplicePipe::make(); // Bound to this call
+    if (!pipe) {
+        co_return co_await io::copyBuffered(dst, src);
+    }
+    size_t written = 0;
+    while (true) {
+        auto readed = co_await src.spliceRead(pipe->writer(), SplicePipe::Capacity);
+        if (!readed && written == 0 && SplicePipe::isUnsupported(readed.error())) { // Nothing in the pipe, fallback
+            co_return co_await io::copyBuffered(dst, src);
+        }
+        if (!readed) {
+            co_return Err(readed.error());
+        }
+        if (*readed == 0) { // EOF
+            break;
+        }
+        for (auto left = *readed; left > 0; ) { // Drain the pipe, so it can be reused
+            ILIAS_CO_TRY(auto n, co_await dst.spliceWrite(pipe->reader(), left));
+            if (n == 0) {
+                co_return Err(IoError::WriteZero);
+            }
+            left -= n;
+        }
+        written += *readed;
+    }
+    co_return written;
+}
+
+/**
+ * @brief Copy the data in both directions until both sides reach EOF, the write side is shutdown after its EOF (like a L4 proxy)
+ * 
+ * @note The first error in one direction cancels the other one, so an idle peer doesn't keep the relay alive
+ * @note With the splice copy it holds two 1 MiB pipes per call (one per direction) until it returns, so a proxy with many
+ *       connections hits the pipe-user-pages-soft limit quickly (see io::copy), past it the relay still works with a lower throughput
+ * @tparam T 
+ * @tparam U 
+ * @param a The stream a
+ * @param b The stream b
+ * @return IoTask<std::pair<size_t, size_t> > The bytes copied from a to b and from b to a, or the first error
+ */
+template <Stream T, Stream U>
+inline auto copyBidirectional(T &a, U &b) -> IoTask<std::pair<size_t, size_t> > {
+    auto failed = Event {}; // Set by the direction failed first
+    auto copyAndShutdown = [](auto &dst, auto &src) -> IoTask<size_t> {
+        ILIAS_CO_TRY(auto n, co_await io::copy(dst, src));
+        ILIAS_CO_TRYV(co_await dst.shutdown());
+        co_return n;
+    };
+    auto oneWay = [&](auto &dst, auto &src) -> IoTask<size_t> {
+        auto [res, _] = co_await whenAny(copyAndShutdown(dst, src), failed.wait());
+        if (!res) { // The other direction failed, we are cancelled
+            co_return Err(IoError::Canceled);
+        }
+        if (!*res) {
+            failed.set();
+        }
+        co_return std::move(*res);
+    };
+    auto [aToB, bToA] = co_await whenAll(oneWay(b, a), oneWay(a, b));
+    for (auto *res : {&aToB, &bToA}) { // The real error first, not the cancellation caused by it
+        if (!*res && res->error() != IoError::Canceled) {
+            co_return Err(res->error());
+        }
+    }
+    ILIAS_CO_TRY(auto sent, std::move(aToB));
+    ILIAS_CO_TRY(auto received, std::move(bToA));
+    co_return std::pair {sent, received};
+}
+
 /**
  * @brief Get the lowest layer of the layered stream
  * 
@@ -146,6 +146,17 @@ concept BorrowFileDescriptor = requires(T &t) {
 template <typename T>
 concept Stream = Readable<T> && Writable<T>;
 
+/**
+ * @brief Concept for the streams that can move the data to / from a pipe in the kernel (splice), like TcpStream
+ * 
+ * @tparam T 
+ */
+template <typename T>
+concept Spliceable = Stream<T> && requires(T &t) {
+    { t.spliceRead(fd_t {}, size_t {}) }  -> IsIoAwaitable<size_t>;
+    { t.spliceWrite(fd_t {}, size_t {}) } -> IsIoAwaitable<size_t>;
+};
+
 /**
  * @brief Concept for types that can be read and written to a byte span and seek to a position.
  * 
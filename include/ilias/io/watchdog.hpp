@@ -0,0 +1,114 @@
+/**
+ * @file watchdog.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The loop stall detector, find the callback which blocks the io context thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/metrics.hpp> // Heartbeat
+#include <ilias/io/context.hpp>
+#include <condition_variable> // std::condition_variable
+#include <functional> // std::function
+#include <string_view> // std::string_view
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+#include <mutex> // std::mutex
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono
+
+ILIAS_NS_BEGIN
+
+/**
+ * @brief The report of a stalled loop
+ *
+ */
+struct StallReport {
+    std::string_view         name;       // The name of the loop given in Watchdog::watch()
+    std::chrono::nanoseconds duration;   // How long the callback runs (so far if not finished, approximate by the check interval)
+    bool                     finished;   // false on the stall detected (still running), true on the callback returned
+    runtime::Stacktrace      stacktrace; // The stacktrace of the coroutine when it left the loop after the stall (only on finished),
+                                         // empty if not captured (not in a coroutine or the coro trace disabled)
+};
+
+/**
+ * @brief The options of the Watchdog
+ *
+ */
+struct WatchdogOptions {
+    std::chrono::nanoseconds                  threshold = std::chrono::milliseconds(100); //< The callback runs longer than it is a stall
+    std::function<void (const StallReport &)> handler;   //< Called on the watchdog thread (don't watch / unwatch in it), empty on logging by ILIAS_WARN
+};
+
+/**
+ * @brief The opt-in watchdog, it checks the heartbeat of the watched loops in a background thread.
+ *
+ * When a callback runs longer than the threshold, the handler is called twice:
+ * - Once on detected (still running), so a loop stuck forever is still reported.
+ * - Once on the callback returned, with the stacktrace of the coroutine that stalled the loop (if coro trace enabled),
+ *   it is captured on the loop thread when the coroutine suspends or completes, so the top frame is the first co_await after the blocking code.
+ *
+ * @code
+ *  auto watchdog = Watchdog { {.threshold = 50ms} };
+ *  watchdog.watch(ctxt, "main");
+ * @endcode
+ */
+class ILIAS_API Watchdog {
+public:
+    explicit Watchdog(WatchdogOptions options = {});
+    Watchdog(const Watchdog &) = delete;
+    ~Watchdog();
+
+    /**
+     * @brief Start watching the io context (thread safe)
+     * @note The context must outlive the watch, call unwatch() before destroying it
+     *
+     * @param ctxt
+     * @param name The name used in the report
+     * @return true on success, false on the context doesn't support heartbeat
+     */
+    auto watch(IoContext &ctxt, std::string name) -> bool;
+
+    /**
+     * @brief Stop watching the io context (thread safe)
+     *
+     * @param ctxt
+     */
+    auto unwatch(IoContext &ctxt) -> void;
+
+    /**
+     * @brief Get the number of the stalls detected
+     *
+     * @return uint64_t
+     */
+    auto stalls() const noexcept -> uint64_t {
+        return mStalls.load(std::memory_order_relaxed);
+    }
+private:
+    struct Entry {
+        IoContext          *ctxt;
+        runtime::Heartbeat *heartbeat;
+        std::string         name;
+        uint64_t            stalled = 0; // The sequence of the stalled callback, 0 on none
+        runtime::Heartbeat::Clock::time_point since {}; // The begin of the stalled callback
+    };
+
+    auto main() -> void;
+    auto check(Entry &entry, runtime::Heartbeat::Clock::time_point now) -> void;
+    auto report(const StallReport &report) -> void;
+
+    WatchdogOptions         mOptions;
+    std::vector<Entry>      mEntries; // Protected by mMutex
+    std::mutex              mMutex;
+    std::condition_variable mCond;
+    bool                    mQuit = false;
+    std::atomic<uint64_t>   mStalls {0};
+    std::thread             mThread;
+};
+
+ILIAS_NS_END
@@ -12,11 +12,13 @@
 
 #include <ilias/net/address.hpp>
 #include <ilias/net/addrinfo.hpp>
+#include <ilias/net/dns.hpp>
 #include <ilias/net/endpoint.hpp>
 #include <ilias/net/sockopt.hpp>
 #include <ilias/net/sockfd.hpp>
 #include <ilias/net/system.hpp>
 #include <ilias/net/poller.hpp>
 #include <ilias/net/pipe.hpp>
+#include <ilias/net/pool.hpp>
 #include <ilias/net/tcp.hpp>
 #include <ilias/net/udp.hpp>
\ No newline at end of file
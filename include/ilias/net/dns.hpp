@@ -0,0 +1,211 @@
+/**
+ * @file dns.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The dns stub resolver, and the cache in front of the resolver with ttl, negative caching and in-flight request coalescing
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/net/addrinfo.hpp> // GaiError
+#include <ilias/net/endpoint.hpp>
+#include <ilias/net/address.hpp>
+#include <ilias/task/task.hpp>
+#include <ilias/io/error.hpp>
+#include <string_view>
+#include <string>
+#include <unordered_map> // std::unordered_map
+#include <functional> // std::function
+#include <optional> // std::optional
+#include <cstdint> // uint64_t
+#include <memory> // std::shared_ptr
+#include <chrono> // std::chrono
+#include <vector> // std::vector
+
+ILIAS_NS_BEGIN
+
+/**
+ * @brief The answer of the resolver
+ *
+ */
+struct DnsAnswer {
+    std::vector<IPAddress>                  addresses; //< The addresses of the name, in the order of the resolver
+    std::optional<std::chrono::nanoseconds> ttl;       //< The ttl reported by the resolver, nullopt to use the configured one
+};
+
+/**
+ * @brief The dns stub resolver, query the nameservers by UdpSocket (TcpStream on the truncated reply) on the event loop, no thread is used
+ *
+ * @code
+ *  auto resolver = DnsResolver {}; // By /etc/resolv.conf and /etc/hosts
+ *  auto endpoints = co_await resolver.lookup("example.com", 80);
+ *
+ *  // Use it behind the cache
+ *  auto cache = DnsCache({.resolver = [resolver](std::string_view name, int family) { return resolver.resolve(name, family); }});
+ * @endcode
+ *
+ */
+class ILIAS_API DnsResolver {
+public:
+    struct Config {
+        std::vector<IPEndpoint>  nameservers;                            //< The nameservers, tried in order
+        std::vector<std::string> search;                                 //< The search domains for the relative name
+        size_t                   ndots    = 1;                           //< The name with fewer dots is tried with the search domains first
+        size_t                   attempts = 2;                           //< The rounds over all the nameservers
+        std::chrono::nanoseconds timeout  = std::chrono::seconds(5);     //< The timeout of each query
+        std::unordered_map<std::string, std::vector<IPAddress> > hosts;  //< The static names (lowercase), checked before the query
+    };
+
+    /**
+     * @brief Construct the resolver by the system config (/etc/resolv.conf, /etc/hosts)
+     *
+     */
+    DnsResolver();
+    explicit DnsResolver(Config config);
+
+    /**
+     * @brief Resolve the name to the addresses, the ipv6 ones come first (the default policy of RFC 6724)
+     *
+     * @param name The hostname
+     * @param family The address family (AF_INET, AF_INET6 or AF_UNSPEC for both)
+     * @return IoTask<DnsAnswer> The addresses (not empty) with the min ttl of the records, GaiError::NotFound if the name doesn't exist,
+     *         GaiError::TryAgain if no nameserver answered
+     */
+    auto resolve(std::string_view name, int family = AF_UNSPEC) const -> IoTask<DnsAnswer>;
+
+    /**
+     * @brief Resolve the name to the endpoints with the port
+     *
+     * @param name The hostname
+     * @param port The port
+     * @param family The address family (AF_INET, AF_INET6 or AF_UNSPEC for both)
+     * @return IoTask<std::vector<IPEndpoint> >
+     */
+    auto lookup(std::string_view name, uint16_t port, int family = AF_UNSPEC) const -> IoTask<std::vector<IPEndpoint> >;
+
+    /**
+     * @brief Get the config of the resolver
+     *
+     * @return const Config &
+     */
+    auto config() const -> const Config & { return mConfig; }
+
+    /**
+     * @brief Parse the content of resolv.conf (nameserver, search, domain, options ndots / timeout / attempts) into the config
+     *
+     * @param content
+     * @param config
+     */
+    static auto parseResolvConf(std::string_view content, Config &config) -> void;
+
+    /**
+     * @brief Parse the content of hosts into the config
+     *
+     * @param content
+     * @param config
+     */
+    static auto parseHosts(std::string_view content, Config &config) -> void;
+
+    /**
+     * @brief Load the system config, the nameserver falls back to 127.0.0.1:53 if none
+     *
+     * @return Config
+     */
+    static auto systemConfig() -> Config;
+private:
+    auto query(std::string name, uint16_t type) const -> IoTask<DnsAnswer>;
+    auto queryName(std::string name, int family) const -> IoTask<DnsAnswer>;
+
+    Config mConfig;
+};
+
+/**
+ * @brief The dns cache, it is thread safe, the lookups of the same name share one query (coalescing)
+ *
+ * @code
+ *  auto addresses = co_await DnsCache::global().resolve("example.com");
+ * @endcode
+ *
+ */
+class ILIAS_API DnsCache {
+public:
+    /**
+     * @brief The resolver behind the cache, resolve the name in the family (AF_UNSPEC for both)
+     *
+     */
+    using Resolver = std::function<IoTask<DnsAnswer> (std::string_view name, int family)>;
+
+    struct Config {
+        size_t                   capacity    = 1024;                         //< The max num of the names cached, the least recently used one is evicted
+        std::chrono::nanoseconds ttl         = std::chrono::seconds(30);     //< The expiry of the answer if the resolver doesn't report one
+        std::chrono::nanoseconds maxTtl      = std::chrono::seconds(300);    //< The upper bound of the ttl reported by the resolver
+        std::chrono::nanoseconds negativeTtl = std::chrono::seconds(5);      //< The expiry of the name not found, zero to disable the negative caching
+        Resolver                 resolver;                                   //< The resolver, empty to use getaddrinfo (AddressInfo::fromHostname)
+    };
+
+    struct Stats {
+        uint64_t hits      = 0; //< The lookups answered by the cache (including the cached failure)
+        uint64_t misses    = 0; //< The lookups sent to the resolver
+        uint64_t coalesced = 0; //< The lookups joined the query in flight
+        size_t   size      = 0; //< The num of the names cached now
+    };
+
+    DnsCache();
+    explicit DnsCache(Config config);
+    DnsCache(const DnsCache &) = delete;
+    ~DnsCache();
+
+    /**
+     * @brief Resolve the name to the addresses, by the cache or the resolver, the ip literal is returned directly
+     *
+     * @param name The hostname
+     * @param family The address family (AF_INET, AF_INET6 or AF_UNSPEC for both)
+     * @return IoTask<std::vector<IPAddress> > The addresses (not empty), GaiError::NotFound if the name doesn't exist
+     */
+    auto resolve(std::string_view name, int family = AF_UNSPEC) -> IoTask<std::vector<IPAddress> >;
+
+    /**
+     * @brief Resolve the name to the endpoints with the port
+     *
+     * @param name The hostname
+     * @param port The port
+     * @param family The address family (AF_INET, AF_INET6 or AF_UNSPEC for both)
+     * @return IoTask<std::vector<IPEndpoint> >
+     */
+    auto lookup(std::string_view name, uint16_t port, int family = AF_UNSPEC) -> IoTask<std::vector<IPEndpoint> >;
+
+    /**
+     * @brief Drop the cached answers of the name
+     *
+     * @param name
+     */
+    auto invalidate(std::string_view name) -> void;
+
+    /**
+     * @brief Drop all the cached answers, the queries in flight are not affected
+     *
+     */
+    auto clear() -> void;
+
+    /**
+     * @brief Get the statistics of the cache
+     *
+     * @return Stats
+     */
+    auto stats() const -> Stats;
+
+    /**
+     * @brief Get the process wide cache, used by the connect by hostname
+     *
+     * @return DnsCache &
+     */
+    static auto global() -> DnsCache &;
+private:
+    struct Impl;
+    std::shared_ptr<Impl> d; // Shared with the queries in flight
+};
+
+ILIAS_NS_END
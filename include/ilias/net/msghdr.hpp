@@ -13,6 +13,9 @@
 #include <ilias/net/endpoint.hpp> // IPEndoint
 #include <ilias/net/system.hpp> // ILIAS_MSGHDR_T
 #include <ilias/io/vec.hpp> // IoVec
+#include <cstddef> // offsetof
+#include <cstring> // memcpy
+#include <optional> // std::optional
 #include <span>
 
 #if defined(_WIN32) // Redirect the names to the windows ones
@@ -66,6 +69,39 @@ public:
         msg_iovlen = buffers.size();
     }
 
+#if !defined(_WIN32)
+    /**
+     * @brief Set the control buffer (the ancillary data), like the one in ControlMsg
+     * 
+     * @param control 
+     */
+    auto setControl(Buffer control) noexcept -> void {
+        msg_control = const_cast<std::byte*>(control.data());
+        msg_controllen = control.size();
+    }
+
+    /**
+     * @brief Find the control message by the level and the type, then copy its data out
+     * 
+     * @tparam T The data type of the control message
+     * @param level The level, like SOL_UDP
+     * @param type The type, like UDP_GRO
+     * @return std::optional<T> (nullopt on not found)
+     */
+    template <typename T>
+    auto control(int level, int type) const noexcept -> std::optional<T> {
+        auto self = const_cast<msghdr_t*>(static_cast<const msghdr_t*>(this));
+        for (auto cmsg = CMSG_FIRSTHDR(self); cmsg != nullptr; cmsg = CMSG_NXTHDR(self, cmsg)) {
+            if (cmsg->cmsg_level == level && cmsg->cmsg_type == type && cmsg->cmsg_len >= CMSG_LEN(sizeof(T))) {
+                T value {};
+                std::memcpy(&value, CMSG_DATA(cmsg), sizeof(T));
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+#endif // !defined(_WIN32)
+
     /**
      * @brief Get the flags of the message on receive
      * 
@@ -103,10 +139,73 @@ public:
         msg_iovlen = buffers.size();
     }
 
+#if !defined(_WIN32)
+    auto setControl(MutableBuffer control) noexcept -> void {
+        msg_control = control.data();
+        msg_controllen = control.size();
+    }
+
+    // Inherit control from MsgHdr
+    using MsgHdr::control;
+#endif // !defined(_WIN32)
+
     // Inherit flags from MsgHdr
     using MsgHdr::flags;
 };
 
+/**
+ * @brief The const message for sendmmsg, the len is the bytes sent on return (layout compatible with mmsghdr on linux)
+ * 
+ */
+struct MMsgHdr {
+    MsgHdr       hdr;
+    unsigned int len = 0;
+};
+
+/**
+ * @brief The mutable message for recvmmsg, the len is the bytes received on return (layout compatible with mmsghdr on linux)
+ * 
+ */
+struct MutableMMsgHdr {
+    MutableMsgHdr hdr;
+    unsigned int  len = 0;
+};
+
+#if !defined(_WIN32)
+/**
+ * @brief The aligned buffer for one control message, used to send it or receive into it
+ * 
+ * @code
+ *  ControlMsg<uint16_t> control {SOL_UDP, UDP_SEGMENT, 1200};
+ *  msg.setControl(control.buffer());
+ * @endcode
+ * 
+ * @tparam T The data type of the control message
+ */
+template <typename T>
+class ControlMsg {
+public:
+    ControlMsg() = default;
+    ControlMsg(int level, int type, const T &value) noexcept {
+        auto cmsg = reinterpret_cast<::cmsghdr*>(mBuffer);
+        cmsg->cmsg_level = level;
+        cmsg->cmsg_type = type;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(T));
+        std::memcpy(CMSG_DATA(cmsg), &value, sizeof(T));
+    }
+
+    auto buffer() noexcept -> MutableBuffer { return mBuffer; }
+    auto buffer() const noexcept -> Buffer { return mBuffer; }
+private:
+    alignas(::cmsghdr) std::byte mBuffer[CMSG_SPACE(sizeof(T))] {};
+};
+#endif // !defined(_WIN32)
+
+#if defined(__linux__)
+static_assert(sizeof(MMsgHdr) == sizeof(::mmsghdr) && offsetof(MMsgHdr, len) == offsetof(::mmsghdr, msg_len));
+static_assert(sizeof(MutableMMsgHdr) == sizeof(::mmsghdr) && offsetof(MutableMMsgHdr, len) == offsetof(::mmsghdr, msg_len));
+#endif // __linux__
+
 ILIAS_NS_END
 
 #if defined(_WIN32)
@@ -0,0 +1,370 @@
+/**
+ * @file pool.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The client connection pool, reuse the connections (TcpStream, TlsStream, ...) to the same upstream
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/executor.hpp>
+#include <ilias/sync/semaphore.hpp>
+#include <ilias/task/spawn.hpp>
+#include <ilias/task/task.hpp>
+#include <ilias/net/endpoint.hpp>
+#include <ilias/net/system.hpp>
+#include <ilias/io/error.hpp>
+#include <unordered_map> // std::unordered_map
+#include <functional> // std::function
+#include <optional> // std::optional
+#include <cstdint> // uint64_t
+#include <memory> // std::shared_ptr
+#include <chrono> // std::chrono
+#include <deque> // std::deque
+
+ILIAS_NS_BEGIN
+
+template <typename T, typename Key, typename Hash>
+class ConnectionPool;
+
+namespace net {
+
+/**
+ * @brief The default health check of the idle connection, nothing should be readable on it,
+ *        the readable one got the EOF, the reset or the stale data, so it can't be reused
+ *
+ * @tparam T The connection, it has `socket()` or the `nextLayer()` (the TlsStream)
+ * @param conn
+ * @return true on it can be reused
+ */
+template <typename T>
+inline auto isIdleUsable(T &conn) -> bool {
+    if constexpr (requires { conn.socket().poll(POLLIN); }) {
+        auto events = conn.socket().poll(POLLIN);
+        return events && *events == 0;
+    }
+    else if constexpr (requires { conn.nextLayer(); }) {
+        return isIdleUsable(conn.nextLayer());
+    }
+    else {
+        return true; // Can't check it, let the request find it out
+    }
+}
+
+} // namespace net
+
+/**
+ * @brief The connection borrowed from the ConnectionPool, it goes back to the idle list when destroyed, unless discarded
+ *
+ * @tparam T The connection type
+ * @tparam Key The key of the upstream
+ * @tparam Hash The hash of the key
+ */
+template <typename T, typename Key, typename Hash>
+class PooledConnection {
+public:
+    PooledConnection(PooledConnection &&) = default;
+    ~PooledConnection() { recycle(); }
+
+    /**
+     * @brief Check the connection came from the idle list, the request on it may meet the close of the peer, retry on a new one
+     *
+     * @return true
+     * @return false
+     */
+    auto isReused() const noexcept -> bool { return mReused; }
+
+    /**
+     * @brief Don't give it back to the pool, call it on the error or the protocol state is unknown
+     *
+     */
+    auto discard() -> void { mConn.reset(); }
+
+    auto get() -> T & { return *mConn; }
+    auto operator *() -> T & { return *mConn; }
+    auto operator ->() -> T * { return &*mConn; }
+    explicit operator bool() const noexcept { return mConn.has_value(); }
+private:
+    using Pool = ConnectionPool<T, Key, Hash>;
+
+    PooledConnection(std::shared_ptr<typename Pool::State> pool, typename Pool::Host &host, T conn, SemaphorePermit permit, bool reused) :
+        mPool(std::move(pool)), mHost(&host), mConn(std::move(conn)), mPermit(std::move(permit)), mReused(reused) {}
+
+    // Put the connection back before the permit is released (member destruction), so the next waiter finds it idle
+    auto recycle() -> void {
+        if (mPool && mConn) {
+            Pool::release(mPool, *mHost, std::move(*mConn));
+            mConn.reset();
+        }
+    }
+
+    std::shared_ptr<typename Pool::State> mPool;
+    typename Pool::Host                  *mHost = nullptr;
+    std::optional<T>                      mConn;
+    SemaphorePermit                       mPermit; // The slot of the host
+    bool                                  mReused = false;
+friend Pool;
+};
+
+/**
+ * @brief The client connection pool, keep the idle connections per key (the upstream), limit the connections per key,
+ *        the tasks wait in order (FIFO) when the limit is reached.
+ *
+ * @note It is not thread safe, it is bound to the executor (single threaded) it was created on, and must be destroyed on it.
+ *       For the multi loop runtime, use one pool per loop (see ShardedConnectionPool)
+ *
+ * @code
+ *  auto pool = ConnectionPool<TcpStream> { {.maxPerHost = 16} };
+ *  auto conn = (co_await pool.acquire("127.0.0.1:8080")).value();
+ *  co_await conn->writeAll(request);
+ *  // ... read the response, conn.discard() on error
+ * @endcode
+ *
+ * @tparam T The connection type (TcpStream, TlsStream, ...)
+ * @tparam Key The key of the upstream, IPEndpoint by default, (host, port) for the TlsStream usually
+ * @tparam Hash The hash of the key
+ */
+template <typename T, typename Key = IPEndpoint, typename Hash = std::hash<Key> >
+class ConnectionPool {
+public:
+    using Connection = PooledConnection<T, Key, Hash>;
+    using Connector = std::function<IoTask<T> (const Key &)>;
+    using HealthCheck = std::function<bool (T &)>;
+
+    struct Config {
+        size_t                   maxPerHost  = 8;                          //< The max num of the connections (idle + in use) per key
+        size_t                   maxIdle     = 8;                          //< The max num of the idle connections per key, the extra ones are closed
+        std::chrono::nanoseconds idleTimeout = std::chrono::seconds(90);   //< The idle connection is closed after it, by the timer of the executor
+        Connector                connector;                                //< Make the new connection, `T::connect(key)` by default
+        HealthCheck              healthCheck;                              //< Check the idle connection before reuse, net::isIdleUsable by default
+    };
+
+    struct Stats {
+        uint64_t created = 0; //< The connections made by the connector
+        uint64_t reused  = 0; //< The connections taken from the idle list
+        uint64_t evicted = 0; //< The idle connections closed (timeout, unhealthy, over maxIdle)
+        size_t   idle    = 0; //< The idle connections now
+    };
+
+    ConnectionPool() : ConnectionPool(Config {}) {}
+    explicit ConnectionPool(Config config) : d(std::make_shared<State>()) {
+        if (!config.connector) {
+            if constexpr (requires (const Key &key) { T::connect(key); }) {
+                config.connector = [](const Key &key) -> IoTask<T> { return T::connect(key); };
+            }
+        }
+        if (!config.healthCheck) {
+            config.healthCheck = [](T &conn) { return net::isIdleUsable(conn); };
+        }
+        ILIAS_ASSERT(config.connector, "The connector is required for this connection type");
+        ILIAS_ASSERT(config.maxPerHost > 0);
+        d->config = std::move(config);
+        d->executor = runtime::Executor::currentThread();
+    }
+    ConnectionPool(const ConnectionPool &) = delete;
+    ~ConnectionPool() {
+        clear();
+        if (d->reaper) {
+            d->reaper.stop();
+        }
+    }
+
+    /**
+     * @brief Borrow a connection to the key, reuse the idle one if healthy, or make a new one,
+     *        wait in order if the connections of the key reach the maxPerHost
+     *
+     * @param key The key of the upstream
+     * @return IoTask<Connection> The borrowed connection, or the error of the connector
+     */
+    auto acquire(Key key) -> IoTask<Connection> {
+        ILIAS_ASSERT(runtime::Executor::currentThread() == d->executor, "The pool is bound to the executor it was created on");
+        auto &host = d->host(key);
+        auto permit = co_await host.sem.acquire();
+        while (!host.idle.empty()) { // The most recently used first, it is the most likely alive
+            auto idle = std::move(host.idle.back());
+            host.idle.pop_back();
+            if (std::chrono::steady_clock::now() - idle.since < d->config.idleTimeout && d->config.healthCheck(idle.conn)) {
+                d->stats.reused += 1;
+                co_return Connection(d, host, std::move(idle.conn), std::move(permit), true);
+            }
+            d->stats.evicted += 1;
+        }
+        auto conn = co_await d->config.connector(key);
+        if (!conn) {
+            co_return Err(conn.error());
+        }
+        d->stats.created += 1;
+        co_return Connection(d, host, std::move(*conn), std::move(permit), false);
+    }
+
+    /**
+     * @brief Close all the idle connections, the borrowed ones still come back
+     *
+     */
+    auto clear() -> void {
+        for (auto &[_, host] : d->hosts) {
+            d->stats.evicted += host->idle.size();
+            host->idle.clear();
+        }
+    }
+
+    /**
+     * @brief Get the num of the idle connections of the key
+     *
+     * @param key
+     * @return size_t
+     */
+    auto idleCount(const Key &key) const -> size_t {
+        auto it = d->hosts.find(key);
+        return it == d->hosts.end() ? 0 : it->second->idle.size();
+    }
+
+    /**
+     * @brief Get the num of the borrowed connections of the key
+     *
+     * @param key
+     * @return size_t
+     */
+    auto activeCount(const Key &key) const -> size_t {
+        auto it = d->hosts.find(key);
+        return it == d->hosts.end() ? 0 : d->config.maxPerHost - it->second->sem.available();
+    }
+
+    /**
+     * @brief Get the statistics of the pool
+     *
+     * @return Stats
+     */
+    auto stats() const -> Stats {
+        auto stats = d->stats;
+        for (const auto &[_, host] : d->hosts) {
+            stats.idle += host->idle.size();
+        }
+        return stats;
+    }
+private:
+    struct Idle {
+        T                                     conn;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    struct Host {
+        Host(size_t max) : sem(ptrdiff_t(max), sync::Fairness::Fifo) {}
+
+        Semaphore        sem;  // The slots of the connections in use, the waiters queue on it
+        std::deque<Idle> idle; // The oldest at the front
+    };
+
+    // Shared with the borrowed connections and the reaper, so they can outlive the pool object
+    struct State {
+        auto host(const Key &key) -> Host & {
+            auto &host = hosts[key];
+            if (!host) {
+                host = std::make_unique<Host>(config.maxPerHost);
+            }
+            return *host;
+        }
+
+        Config                                             config;
+        std::unordered_map<Key, std::unique_ptr<Host>, Hash> hosts;
+        Stats                                              stats;
+        runtime::Executor                                 *executor = nullptr;
+        WaitHandle<void>                                   reaper;
+    };
+
+    static auto release(const std::shared_ptr<State> &self, Host &host, T conn) -> void {
+        if (host.idle.size() >= self->config.maxIdle) {
+            self->stats.evicted += 1;
+            return;
+        }
+        host.idle.emplace_back(Idle {std::move(conn), std::chrono::steady_clock::now()});
+        if (!self->reaper) { // Start the timer to close the expired ones
+            self->reaper = spawn(reap(self));
+        }
+    }
+
+    // Sleep until the oldest idle connection expires, close the expired ones, quit when nothing is idle
+    static auto reap(std::weak_ptr<State> weak) -> Task<void> {
+        while (true) {
+            auto next = std::optional<std::chrono::steady_clock::time_point> {};
+            if (auto self = weak.lock(); self) {
+                auto now = std::chrono::steady_clock::now();
+                for (auto &[_, host] : self->hosts) {
+                    while (!host->idle.empty() && now - host->idle.front().since >= self->config.idleTimeout) {
+                        host->idle.pop_front();
+                        self->stats.evicted += 1;
+                    }
+                    if (!host->idle.empty()) {
+                        auto expire = host->idle.front().since + self->config.idleTimeout;
+                        next = std::min(next.value_or(expire), expire);
+                    }
+                }
+                if (!next) {
+                    self->reaper = {}; // Detach ourself, the next release starts a new one
+                    co_return;
+                }
+            }
+            else {
+                co_return;
+            }
+            co_await sleepUntil(*next);
+        }
+    }
+
+    std::shared_ptr<State> d;
+friend Connection;
+};
+
+/**
+ * @brief The pool per loop for the multi loop runtime (ShardedRuntime), each shard uses its own pool, nothing is shared
+ *
+ * @code
+ *  auto pools = ShardedConnectionPool<TcpStream> {runtime.size(), {.maxPerHost = 4}};
+ *  runtime.run([&](Shard &shard) -> Task<void> {
+ *      auto conn = co_await pools.local(shard.index()).acquire(upstream);
+ *      ...
+ *      pools.reset(shard.index()); // Close the idle connections on the loop, before it quits
+ *  });
+ * @endcode
+ *
+ */
+template <typename T, typename Key = IPEndpoint, typename Hash = std::hash<Key> >
+class ShardedConnectionPool {
+public:
+    using Pool = ConnectionPool<T, Key, Hash>;
+
+    ShardedConnectionPool(size_t shards, typename Pool::Config config = {}) : mPools(shards), mConfig(std::move(config)) {}
+    ShardedConnectionPool(const ShardedConnectionPool &) = delete;
+
+    /**
+     * @brief Get the pool of the shard, it is created on the first call, must be called on the loop of the shard
+     *
+     * @param shard The index of the shard
+     * @return Pool &
+     */
+    auto local(size_t shard) -> Pool & {
+        ILIAS_ASSERT(shard < mPools.size());
+        if (!mPools[shard]) { // Only the shard touches its slot, no lock
+            mPools[shard] = std::make_unique<Pool>(mConfig);
+        }
+        return *mPools[shard];
+    }
+
+    /**
+     * @brief Destroy the pool of the shard, must be called on the loop of the shard before it quits, the connections belong to it
+     *
+     * @param shard The index of the shard
+     */
+    auto reset(size_t shard) -> void {
+        ILIAS_ASSERT(shard < mPools.size());
+        mPools[shard].reset();
+    }
+private:
+    std::vector<std::unique_ptr<Pool> > mPools;
+    typename Pool::Config               mConfig;
+};
+
+ILIAS_NS_END
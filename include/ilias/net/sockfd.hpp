@@ -343,18 +343,41 @@ public:
         return SystemError(err);
     }
 
+    /**
+     * @brief Poll the socket for events synchronously, by poll (WSAPoll on windows)
+     * 
+     * @param events The events to poll (POLLIN, POLLOUT, ...)
+     * @param timeout The timeout in milliseconds, 0 to return at once, -1 to wait forever
+     * @return IoResult<uint32_t> The events ready (0 on timeout)
+     */
+    auto poll(uint32_t events, int timeout = 0) const -> IoResult<uint32_t> {
+        auto pfd = ::pollfd {};
+        pfd.fd = mFd;
+        pfd.events = static_cast<short>(events);
+        if (ILIAS_POLL(&pfd, 1, timeout) < 0) {
+            return Err(SystemError::fromErrno());
+        }
+        return uint32_t(static_cast<unsigned short>(pfd.revents));
+    }
+
     /**
      * @brief Accept a connection on the socket
      * 
      * @tparam T 
      * @param endpoint The endpoint of the remote peer (optional, can be nullptr)
+     * @param flags The flags of the accepted socket (SOCK_NONBLOCK, SOCK_CLOEXEC), by accept4 on linux, must be 0 on other platforms
      * @return IoResult<T> 
      */
     template <typename T>
-    auto accept(MutableEndpointView endpoint) const -> IoResult<T> {
+    auto accept(MutableEndpointView endpoint, int flags = 0) const -> IoResult<T> {
         ::sockaddr *addr = endpoint.data();
         ::socklen_t len = endpoint.bufsize();
+#if defined(__linux__)
+        auto fd = ::accept4(mFd, addr, &len, flags);
+#else
+        ILIAS_ASSERT(flags == 0, "The accept flags are only supported on linux");
         auto fd = ::accept(mFd, addr, &len);
+#endif // defined(__linux__)
         if (fd == Invalid) {
             return Err(SystemError::fromErrno());
         }
@@ -29,6 +29,11 @@
     #include <netinet/tcp.h>
 #endif // defined(_WIN32)
 
+#if defined(__linux__)
+    #include <linux/filter.h> // sock_fprog
+    #include <netinet/udp.h> // UDP_SEGMENT, UDP_GRO
+#endif // defined(__linux__)
+
 ILIAS_NS_BEGIN
 
 /**
@@ -235,6 +240,24 @@ using RecvBufSize = OptionT<SOL_SOCKET, SO_RCVBUF, int>;
 using ReusePort = OptionT<SOL_SOCKET, SO_REUSEPORT, int>;
 #endif // defined(SO_REUSEPORT)
 
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+/**
+ * @brief Attach the classic bpf program to select the socket in the SO_REUSEPORT group (struct sock_fprog)
+ * @note The program returns the index of the socket in the group, the filter array must alive during the setopt call
+ * 
+ */
+using AttachReusePortCBPF = OptionT<SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, ::sock_fprog, OptionAccess::Write>;
+#endif // defined(SO_ATTACH_REUSEPORT_CBPF)
+
+#if defined(SO_INCOMING_CPU)
+/**
+ * @brief Set the socket option SO_INCOMING_CPU (int), the cpu the packets of the socket are processed on
+ * @note On the listener of the SO_REUSEPORT group, the connection is steered to the socket with the matched cpu
+ * 
+ */
+using IncomingCpu = OptionT<SOL_SOCKET, SO_INCOMING_CPU, int>;
+#endif // defined(SO_INCOMING_CPU)
+
 
 // MARK: IPPROTO_TCP
 /**
@@ -269,6 +292,50 @@ using TcpKeepCnt = OptionT<IPPROTO_TCP, TCP_KEEPCNT, dword_t>;
 using TcpUserTimeout = OptionT<IPPROTO_TCP, TCP_USER_TIMEOUT, int>;
 #endif // defined(TCP_USER_TIMEOUT)
 
+#if defined(TCP_FASTOPEN)
+/**
+ * @brief Set the tcp socket option TCP_FASTOPEN (int), the queue length of the pending fast open requests on the listener
+ * @note Set it before the listen (TcpBuilder::bind), the server side also needs the net.ipv4.tcp_fastopen sysctl bit 0x2 on linux
+ * 
+ */
+using TcpFastOpen = OptionT<IPPROTO_TCP, TCP_FASTOPEN, int>;
+#endif // defined(TCP_FASTOPEN)
+
+#if defined(TCP_FASTOPEN_CONNECT)
+/**
+ * @brief Set the tcp socket option TCP_FASTOPEN_CONNECT (true or false), the connect is deferred to the first write, which carries the data in the SYN
+ * @note Without the cookie of the peer, the connect falls back to the normal handshake and asks for the cookie
+ * 
+ */
+using TcpFastOpenConnect = OptionT<IPPROTO_TCP, TCP_FASTOPEN_CONNECT, int>;
+#endif // defined(TCP_FASTOPEN_CONNECT)
+
+#if defined(TCP_DEFER_ACCEPT)
+/**
+ * @brief Set the tcp socket option TCP_DEFER_ACCEPT (int), the seconds the listener waits for the data before waking the accept
+ * 
+ */
+using TcpDeferAccept = OptionT<IPPROTO_TCP, TCP_DEFER_ACCEPT, int>;
+#endif // defined(TCP_DEFER_ACCEPT)
+
+#if defined(TCP_QUICKACK)
+/**
+ * @brief Set the tcp socket option TCP_QUICKACK (true or false), send the ack at once instead of the delayed ack
+ * @note It is not permanent, the kernel may go back to the delayed ack later, set it again after the read if needed
+ * 
+ */
+using TcpQuickAck = OptionT<IPPROTO_TCP, TCP_QUICKACK, int>;
+#endif // defined(TCP_QUICKACK)
+
+#if defined(TCP_NOTSENT_LOWAT)
+/**
+ * @brief Set the tcp socket option TCP_NOTSENT_LOWAT (int), the socket is writable only if the unsent bytes are below it
+ * @note Keep the data in the user space, so the latest one can be sent instead of the queued stale one
+ * 
+ */
+using TcpNotSentLowat = OptionT<IPPROTO_TCP, TCP_NOTSENT_LOWAT, int>;
+#endif // defined(TCP_NOTSENT_LOWAT)
+
 // MARK: IPPROTO_IPV6
 /**
  * @brief Set the ipv6 socket option IPV6_V6ONLY (true or false)
@@ -277,6 +344,26 @@ using TcpUserTimeout = OptionT<IPPROTO_TCP, TCP_USER_TIMEOUT, int>;
 using Ipv6Only = OptionT<IPPROTO_IPV6, IPV6_V6ONLY, dword_t>;
 
 
+// MARK: IPPROTO_UDP
+#if defined(UDP_SEGMENT)
+/**
+ * @brief Set the udp socket option UDP_SEGMENT (int), the segment size of the generic segmentation offload (GSO)
+ * @note The send buffer is split into the datagrams of this size by the kernel, 0 to disable
+ * 
+ */
+using UdpSegment = OptionT<IPPROTO_UDP, UDP_SEGMENT, int>;
+#endif // defined(UDP_SEGMENT)
+
+#if defined(UDP_GRO)
+/**
+ * @brief Set the udp socket option UDP_GRO (true or false), receive the coalesced datagrams (GRO) in one buffer
+ * @note The segment size is reported by the UDP_GRO control message, see UdpSocket::recvSegments
+ * 
+ */
+using UdpGro = OptionT<IPPROTO_UDP, UDP_GRO, int>;
+#endif // defined(UDP_GRO)
+
+
 // MARK: Platform specific
 #if defined(_WIN32)
 /**
@@ -356,6 +443,14 @@ ILIAS_FORMATTER(ilias::sockopt::RecvBufSize) {
     }
 };
 
+#if defined(SO_INCOMING_CPU)
+ILIAS_FORMATTER(ilias::sockopt::IncomingCpu) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "IncomingCpu({})", int(opt));
+    }
+};
+#endif // defined(SO_INCOMING_CPU)
+
 // IPPROTO_TCP
 ILIAS_FORMATTER(ilias::sockopt::TcpNoDelay) {
     auto format(const auto &opt, auto &ctxt) const {
@@ -389,4 +484,60 @@ ILIAS_FORMATTER(ilias::sockopt::TcpUserTimeout) {
 };
 #endif // defined(TCP_USER_TIMEOUT)
 
+#if defined(TCP_FASTOPEN)
+ILIAS_FORMATTER(ilias::sockopt::TcpFastOpen) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "TcpFastOpen({})", int(opt));
+    }
+};
+#endif // defined(TCP_FASTOPEN)
+
+#if defined(TCP_FASTOPEN_CONNECT)
+ILIAS_FORMATTER(ilias::sockopt::TcpFastOpenConnect) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "TcpFastOpenConnect({})", bool(opt));
+    }
+};
+#endif // defined(TCP_FASTOPEN_CONNECT)
+
+#if defined(TCP_DEFER_ACCEPT)
+ILIAS_FORMATTER(ilias::sockopt::TcpDeferAccept) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "TcpDeferAccept({})", int(opt));
+    }
+};
+#endif // defined(TCP_DEFER_ACCEPT)
+
+#if defined(TCP_QUICKACK)
+ILIAS_FORMATTER(ilias::sockopt::TcpQuickAck) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "TcpQuickAck({})", bool(opt));
+    }
+};
+#endif // defined(TCP_QUICKACK)
+
+#if defined(TCP_NOTSENT_LOWAT)
+ILIAS_FORMATTER(ilias::sockopt::TcpNotSentLowat) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "TcpNotSentLowat({})", int(opt));
+    }
+};
+#endif // defined(TCP_NOTSENT_LOWAT)
+
+#if defined(UDP_SEGMENT)
+ILIAS_FORMATTER(ilias::sockopt::UdpSegment) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "UdpSegment({})", int(opt));
+    }
+};
+#endif // defined(UDP_SEGMENT)
+
+#if defined(UDP_GRO)
+ILIAS_FORMATTER(ilias::sockopt::UdpGro) {
+    auto format(const auto &opt, auto &ctxt) const {
+        return format_to(ctxt.out(), "UdpGro({})", bool(opt));
+    }
+};
+#endif // defined(UDP_GRO)
+
 #endif // !defined(ILIAS_NO_FORMAT)
\ No newline at end of file
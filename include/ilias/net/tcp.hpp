@@ -11,11 +11,21 @@
 #pragma once
 
 #include <ilias/task/generator.hpp>
+#include <ilias/task/when_any.hpp>
+#include <ilias/detail/scope_exit.hpp>
 #include <ilias/net/endpoint.hpp>
+#include <ilias/net/dns.hpp> // DnsCache
 #include <ilias/net/sockfd.hpp>
 #include <ilias/net/msghdr.hpp> // MsgHdr
 #include <ilias/io/context.hpp>
 #include <ilias/io/ext.hpp>
+#include <ilias/fs/file.hpp> // File
+#include <ilias/sync/event.hpp>
+#include <functional> // std::function
+#include <algorithm> // std::min
+#include <vector> // std::vector
+#include <chrono> // std::chrono
+#include <span> // std::span
 
 ILIAS_NS_BEGIN
 
@@ -69,6 +79,19 @@ public:
      */
     auto connect(IPEndpoint endpoint) -> IoTask<TcpStream>;
 
+    /**
+     * @brief Connect to a remote endpoint and send the first payload, it is carried in the SYN by TCP Fast Open (TCP_FASTOPEN_CONNECT) if possible,
+     *        which saves one round trip before the peer gets the request
+     * @note It will consume the builder. Without the cookie of the peer (the first connection) or the support of the platform,
+     *       it falls back to the connect then the write. In the fast open case, the payload is queued before the handshake completes, so the connect error
+     *       (e.g. refused) may only show up on the first read of the stream.
+     * 
+     * @param endpoint 
+     * @param payload The first data to send, must alive until the task completes
+     * @return IoTask<TcpStream> The stream, the payload is all written
+     */
+    auto connect(IPEndpoint endpoint, Buffer payload) -> IoTask<TcpStream>;
+
     /**
      * @brief Bind to a local endpoint.
      * @note It will consume the builder.
@@ -85,6 +108,27 @@ private:
     IoResult<Socket> mFd;
 };
 
+/**
+ * @brief The record of a connection attempt, made by the connect of multiple endpoints
+ * 
+ */
+struct TcpConnectAttempt {
+    IPEndpoint               endpoint;
+    std::chrono::nanoseconds start {};   //< The time the attempt started, since the connect began
+    std::chrono::nanoseconds elapsed {}; //< The time the attempt took, until it connected, failed or was cancelled
+    std::error_code          error;      //< The error of the attempt, IoError::Canceled if it lost the race, empty if it won
+};
+
+/**
+ * @brief The options of the connect of multiple endpoints (Happy Eyeballs, RFC 8305)
+ * 
+ */
+struct TcpConnectOptions {
+    std::chrono::nanoseconds        attemptDelay = std::chrono::milliseconds(250); //< The delay before starting the next attempt, if the last one is still pending
+    std::function<IoTask<TcpStream> (const IPEndpoint &)> connector {};          //< Make the connection of each attempt, `TcpStream::connect(endpoint)` by default
+    std::vector<TcpConnectAttempt> *attempts = nullptr;                          //< Receive the records of the attempts in the start order, if not null
+};
+
 /**
  * @brief The tcp stream class.
  * 
@@ -169,6 +213,57 @@ public:
         co_return co_await mHandle.sendmsg(msg, 0);
     }
 
+    // Splice
+    /**
+     * @brief Move the data from the stream into the pipe in the kernel (splice), used by io::copy
+     * 
+     * @param pipe The write end of the pipe
+     * @param len The max bytes to move
+     * @return IoTask<size_t> The bytes moved (0 on EOF)
+     */
+    auto spliceRead(fd_t pipe, size_t len) const -> IoTask<size_t> {
+        return mHandle.spliceRead(pipe, len);
+    }
+
+    /**
+     * @brief Move the data from the pipe into the stream in the kernel (splice), used by io::copy
+     * 
+     * @param pipe The read end of the pipe
+     * @param len The max bytes to move
+     * @return IoTask<size_t> The bytes moved
+     */
+    auto spliceWrite(fd_t pipe, size_t len) const -> IoTask<size_t> {
+        return mHandle.spliceWrite(pipe, len);
+    }
+
+    /**
+     * @brief Send the range of the file to the stream, in the kernel if supported (sendfile), no copying to the user space
+     * @note It falls back to read the file and write it if the backend doesn't support it, the offset of the file is not changed.
+     *       Flush the buffered layer (like BufStream) before calling it, the data is written to the socket directly
+     * 
+     * @param file The file to send
+     * @param offset The offset in the file
+     * @param length The bytes to send
+     * @return IoTask<size_t> The bytes sent, less than length if the file is shorter
+     */
+    auto sendFile(File &file, uint64_t offset, size_t length) const -> IoTask<size_t> {
+        size_t sent = 0;
+        while (sent < length) {
+            auto n = co_await mHandle.sendfile(file.fd(), offset + sent, length - sent);
+            if (!n && sent == 0 && SplicePipe::isUnsupported(n.error())) {
+                co_return co_await sendFileBuffered(file, offset, length);
+            }
+            if (!n) {
+                co_return Err(n.error());
+            }
+            if (*n == 0) { // The end of the file
+                break;
+            }
+            sent += *n;
+        }
+        co_return sent;
+    }
+
     // Extension Methods
     /**
      * @brief Send data to the socket. like write but with flags.
@@ -243,6 +338,15 @@ public:
         return mHandle.poll(events);
     }
 
+    /**
+     * @brief Get the view of the socket, for the synchronous operations (options, poll, ...)
+     * 
+     * @return SocketView 
+     */
+    auto socket() const -> SocketView {
+        return mHandle.fd();
+    }
+
     auto operator <=>(const TcpStream &) const = default;
 
     /**
@@ -255,6 +359,26 @@ public:
         return TcpBuilder {endpoint.family()}.connect(endpoint);
     }
 
+    /**
+     * @brief Connect to the host, resolved by the DnsCache::global(), the addresses are raced by the Happy Eyeballs (RFC 8305)
+     * 
+     * @param host The hostname or the ip literal
+     * @param port The port
+     * @param options 
+     * @return IoTask<TcpStream> 
+     */
+    static auto connect(std::string_view host, uint16_t port, TcpConnectOptions options = {}) -> IoTask<TcpStream>;
+
+    /**
+     * @brief Connect to the first reachable endpoint, the families are interleaved, the next attempt is started after the attempt delay
+     *        or at once on the failure of the last one, the first connected wins and the others are cancelled
+     * 
+     * @param endpoints The endpoints in the preferred order, must not be empty
+     * @param options 
+     * @return IoTask<TcpStream> The connected stream, or the error of the last attempt if all failed
+     */
+    static auto connect(std::span<const IPEndpoint> endpoints, TcpConnectOptions options = {}) -> IoTask<TcpStream>;
+
     /**
      * @brief Check if the socket is valid.
      * 
@@ -263,6 +387,22 @@ public:
      */
     explicit operator bool() const noexcept { return bool(mHandle); }
 private:
+    // The fallback of sendFile, pread + write
+    auto sendFileBuffered(File &file, uint64_t offset, size_t length) const -> IoTask<size_t> {
+        auto buffer = std::vector<std::byte>(std::min<size_t>(length, 64 * 1024));
+        size_t sent = 0;
+        while (sent < length) {
+            auto chunk = makeBuffer(buffer).first(std::min(buffer.size(), length - sent));
+            ILIAS_CO_TRY(auto n, co_await file.pread(chunk, offset + sent));
+            if (n == 0) { // The end of the file
+                break;
+            }
+            ILIAS_CO_TRYV(co_await io::writeAll(*this, chunk.first(n)));
+            sent += n;
+        }
+        co_return sent;
+    }
+
     IoHandle<Socket> mHandle;
 };
 
@@ -322,7 +462,7 @@ public:
      */
     auto accept(IPEndpoint *endpoint) const -> IoTask<TcpStream> {
         ILIAS_CO_TRY(auto sockfd, co_await mHandle.accept(endpoint));
-        ILIAS_CO_TRY(auto handle, IoHandle<Socket>::make(Socket {sockfd}, IoDescriptor::Socket));
+        ILIAS_CO_TRY(auto handle, IoHandle<Socket>::make(Socket {sockfd}, IoDescriptor::Accepted));
         co_return TcpStream {std::move(handle)};
     }
 
@@ -336,6 +476,33 @@ public:
         return accept(&endpoint);
     }
 
+    /**
+     * @brief Accept the connections in the backlog in one wake, wait for the first one, then take the pending ones without waiting
+     * 
+     * @param max The max num of the connections to accept (must be > 0)
+     * @return IoTask<std::vector<std::pair<TcpStream, IPEndpoint> > > The connections (not empty), the error only if the first one failed
+     */
+    auto acceptMany(size_t max) const -> IoTask<std::vector<std::pair<TcpStream, IPEndpoint> > > {
+        ILIAS_ASSERT(max > 0, "The max must be greater than 0");
+        std::vector<std::pair<TcpStream, IPEndpoint> > clients;
+        ILIAS_CO_TRY(auto first, co_await accept());
+        clients.emplace_back(std::move(first));
+        while (clients.size() < max) {
+            // Only take the pending one, so the accept below completes without waiting
+            auto events = mHandle.fd().poll(POLLIN);
+            if (!events || !(*events & POLLIN)) {
+                break;
+            }
+            IPEndpoint endpoint;
+            auto client = co_await accept(&endpoint);
+            if (!client) { // Keep the accepted ones, the error shows up again on the next accept if it persists
+                break;
+            }
+            clients.emplace_back(std::move(*client), endpoint);
+        }
+        co_return clients;
+    }
+
     /**
      * @brief Poll the socket for events.
      * 
@@ -402,6 +569,20 @@ inline auto TcpBuilder::connect(IPEndpoint endpoint) -> IoTask<TcpStream> {
     return fn(std::move(*this), endpoint);
 }
 
+inline auto TcpBuilder::connect(IPEndpoint endpoint, Buffer payload) -> IoTask<TcpStream> {
+    auto fn = [](TcpBuilder self, IPEndpoint endpoint, Buffer payload) -> IoTask<TcpStream> {
+#if defined(TCP_FASTOPEN_CONNECT)
+        if (self.mFd) { // Best effort, the connect is deferred to the write if the kernel has the cookie
+            (void) self.mFd->setOption(sockopt::TcpFastOpenConnect(true));
+        }
+#endif // defined(TCP_FASTOPEN_CONNECT)
+        ILIAS_CO_TRY(auto stream, co_await std::move(self).connect(endpoint));
+        ILIAS_CO_TRYV(co_await stream.writeAll(payload));
+        co_return stream;
+    };
+    return fn(std::move(*this), endpoint, payload);
+}
+
 inline auto TcpBuilder::bind(IPEndpoint endpoint, int backlog) -> IoTask<TcpListener> {
     auto fn = [](TcpBuilder self, IPEndpoint endpoint, int backlog) -> IoTask<TcpListener> {
         ILIAS_CO_TRY(auto sockfd, std::move(self.mFd));
@@ -413,6 +594,115 @@ inline auto TcpBuilder::bind(IPEndpoint endpoint, int backlog) -> IoTask<TcpList
     return fn(std::move(*this), endpoint, backlog);
 };
 
+// MARK: Happy Eyeballs
+namespace net {
+
+// Race the attempts, the attempt of idx against (wait the delay or the failure of it, then race the ones after idx),
+// the side failed first keeps waiting until the other side fails too, so a pending attempt is never dropped by the failure of the other
+class HappyEyeballs {
+public:
+    HappyEyeballs(std::span<const IPEndpoint> endpoints, const TcpConnectOptions &options) : 
+        mEndpoints(endpoints), mDelay(options.attemptDelay), mConnector(options.connector), mBegin(std::chrono::steady_clock::now()) {}
+
+    auto race(size_t idx) -> IoTask<TcpStream> {
+        if (idx + 1 == mEndpoints.size()) {
+            co_return co_await attempt(idx);
+        }
+        auto failed = Event {};     // The attempt of idx failed
+        auto restFailed = Event {}; // The attempts after idx all failed
+        auto [first, rest] = co_await whenAny(head(idx, failed, restFailed), tail(idx, failed, restFailed));
+        if (first) {
+            co_return std::move(*first);
+        }
+        co_return std::move(*rest);
+    }
+
+    auto attempts() -> std::vector<TcpConnectAttempt> & { return mAttempts; }
+
+    // Interleave the families, start with the family of the first one (RFC 8305 Section 4)
+    static auto interleave(std::span<const IPEndpoint> endpoints) -> std::vector<IPEndpoint> {
+        auto preferred = std::vector<IPEndpoint> {};
+        auto other = std::vector<IPEndpoint> {};
+        for (const auto &endpoint : endpoints) {
+            (endpoint.family() == endpoints.front().family() ? preferred : other).emplace_back(endpoint);
+        }
+        auto result = std::vector<IPEndpoint> {};
+        result.reserve(endpoints.size());
+        for (size_t i = 0; i < std::max(preferred.size(), other.size()); i++) {
+            if (i < preferred.size()) {
+                result.emplace_back(preferred[i]);
+            }
+            if (i < other.size()) {
+                result.emplace_back(other[i]);
+            }
+        }
+        return result;
+    }
+private:
+    auto head(size_t idx, Event &failed, Event &restFailed) -> IoTask<TcpStream> {
+        auto res = co_await attempt(idx);
+        if (res) {
+            co_return std::move(*res);
+        }
+        failed.set();
+        co_await restFailed;
+        co_return Err(res.error());
+    }
+
+    auto tail(size_t idx, Event &failed, Event &restFailed) -> IoTask<TcpStream> {
+        (void) co_await whenAny(sleep(mDelay), failed.wait());
+        auto res = co_await race(idx + 1);
+        if (res) {
+            co_return std::move(*res);
+        }
+        restFailed.set();
+        co_await failed;
+        co_return Err(res.error());
+    }
+
+    auto attempt(size_t idx) -> IoTask<TcpStream> {
+        auto record = mAttempts.size();
+        mAttempts.emplace_back(TcpConnectAttempt {
+            .endpoint = mEndpoints[idx], 
+            .start = std::chrono::steady_clock::now() - mBegin,
+            .error = IoError::Canceled, // Until it completes
+        });
+        auto guard = ScopeExit([&, record]() { // Also on cancel
+            mAttempts[record].elapsed = std::chrono::steady_clock::now() - mBegin - mAttempts[record].start;
+        });
+        auto connect = mConnector ? mConnector(mEndpoints[idx]) : TcpStream::connect(mEndpoints[idx]);
+        auto res = co_await std::move(connect);
+        mAttempts[record].error = res ? std::error_code {} : res.error();
+        co_return res;
+    }
+
+    std::span<const IPEndpoint>           mEndpoints;
+    std::chrono::nanoseconds              mDelay;
+    const std::function<IoTask<TcpStream> (const IPEndpoint &)> &mConnector;
+    std::chrono::steady_clock::time_point mBegin;
+    std::vector<TcpConnectAttempt>        mAttempts;
+};
+
+} // namespace net
+
+inline auto TcpStream::connect(std::string_view host, uint16_t port, TcpConnectOptions options) -> IoTask<TcpStream> {
+    ILIAS_CO_TRY(auto endpoints, co_await DnsCache::global().lookup(host, port));
+    co_return co_await TcpStream::connect(endpoints, options);
+}
+
+inline auto TcpStream::connect(std::span<const IPEndpoint> endpoints, TcpConnectOptions options) -> IoTask<TcpStream> {
+    if (endpoints.empty()) {
+        co_return Err(IoError::InvalidArgument);
+    }
+    auto sorted = net::HappyEyeballs::interleave(endpoints);
+    auto eyeballs = net::HappyEyeballs {sorted, options};
+    auto res = co_await eyeballs.race(0);
+    if (options.attempts) {
+        *options.attempts = std::move(eyeballs.attempts());
+    }
+    co_return res;
+}
+
 // For compatible with old version.
 using TcpClient [[deprecated("Use TcpStream instead")]] = TcpStream;
 
@@ -12,14 +12,48 @@
 
 #include <ilias/net/endpoint.hpp>
 #include <ilias/net/sockfd.hpp>
-#include <ilias/net/msghdr.hpp> // MsgHdr
+#include <ilias/net/msghdr.hpp> // MsgHdr, ControlMsg
+#include <ilias/net/sockopt.hpp> // UDP_SEGMENT, UDP_GRO
 #include <ilias/io/context.hpp>
+#include <algorithm> // std::min
+#include <array> // std::array
+#include <cstdint> // UINT16_MAX
+#include <span> // std::span
 
 ILIAS_NS_BEGIN
 
 // Forward declaration
 class UdpSocket;
 
+/**
+ * @brief The slot to receive a datagram into, used by UdpSocket::recvMany
+ * 
+ */
+struct UdpPacketBuffer {
+    MutableBuffer buffer;   //< The buffer to receive the datagram into
+    size_t        size = 0; //< The datagram size, set on return
+    IPEndpoint    endpoint; //< The sender, set on return
+};
+
+/**
+ * @brief The datagram to send, used by UdpSocket::sendMany
+ * 
+ */
+struct UdpPacket {
+    Buffer     buffer;   //< The datagram
+    IPEndpoint endpoint; //< The endpoint to send to
+};
+
+/**
+ * @brief The coalesced datagrams received by UdpSocket::recvSegments
+ * 
+ */
+struct UdpSegments {
+    size_t     size = 0;        //< The total size of the datagrams
+    size_t     segmentSize = 0; //< The size of each datagram (the last one can be shorter), equal to size if not coalesced
+    IPEndpoint endpoint;        //< The sender
+};
+
 /**
  * @brief The builder used to build udp socket.
  * 
@@ -70,6 +104,9 @@ private:
  */
 class UdpSocket {
 public:
+    static constexpr size_t MaxBatch = 64; //< The max num of the datagrams per recvMany / sendMany
+    static constexpr size_t MaxSegments = 64; //< The max num of the datagrams per sendSegments (UDP_MAX_SEGMENTS)
+
     UdpSocket() = default;
     UdpSocket(IoHandle<Socket> h) : mHandle(std::move(h)) {}
 
@@ -134,6 +171,100 @@ public:
         co_return co_await mHandle.sendmsg(msg, 0);
     }
 
+    // Batched
+    /**
+     * @brief Receive multiple datagrams in one go (recvmmsg if the backend supports it), it waits only if nothing is queued.
+     * @note At most MaxBatch datagrams are received per call.
+     * 
+     * @param packets The slots to receive into, the size and the endpoint of the received ones are set
+     * @return IoTask<size_t> The num of the datagrams received (at least one on success)
+     */
+    auto recvMany(std::span<UdpPacketBuffer> packets) const -> IoTask<size_t> {
+        auto count = std::min(packets.size(), MaxBatch);
+        std::array<MutableIoVec, MaxBatch> vecs;
+        std::array<MutableMMsgHdr, MaxBatch> msgs;
+        for (size_t i = 0; i < count; ++i) {
+            vecs[i] = MutableIoVec(packets[i].buffer);
+            msgs[i].hdr.setBuffers(std::span(&vecs[i], 1));
+            msgs[i].hdr.setEndpoint(packets[i].endpoint);
+        }
+        ILIAS_CO_TRY(auto n, co_await mHandle.recvmmsg(std::span(msgs).first(count), 0));
+        for (size_t i = 0; i < n; ++i) {
+            packets[i].size = msgs[i].len;
+        }
+        co_return n;
+    }
+
+    /**
+     * @brief Send multiple datagrams in one go (sendmmsg if the backend supports it)
+     * @note At most MaxBatch datagrams are sent per call, the caller should retry the rest.
+     * 
+     * @param packets The datagrams to send
+     * @return IoTask<size_t> The num of the datagrams sent (at least one on success)
+     */
+    auto sendMany(std::span<const UdpPacket> packets) const -> IoTask<size_t> {
+        auto count = std::min(packets.size(), MaxBatch);
+        std::array<IoVec, MaxBatch> vecs;
+        std::array<MMsgHdr, MaxBatch> msgs;
+        for (size_t i = 0; i < count; ++i) {
+            vecs[i] = IoVec(packets[i].buffer);
+            msgs[i].hdr.setBuffers(std::span(&vecs[i], 1));
+            msgs[i].hdr.setEndpoint(packets[i].endpoint);
+        }
+        co_return co_await mHandle.sendmmsg(std::span(msgs).first(count), 0);
+    }
+
+#if defined(UDP_SEGMENT)
+    // Segmentation offload
+    /**
+     * @brief Send the buffer as the datagrams of segmentSize to the endpoint in one syscall (UDP GSO)
+     * @note The last datagram can be shorter, the buffer can hold at most MaxSegments datagrams (and 64KB in total),
+     *       the device must support the checksum offload, otherwise it fails with EIO
+     * 
+     * @param buffer The datagrams to send, back to back
+     * @param segmentSize The size of each datagram
+     * @param endpoint The endpoint to send the datagrams to.
+     * @return IoTask<size_t> The bytes sent, IoError::InvalidArgument on more than MaxSegments datagrams
+     */
+    auto sendSegments(Buffer buffer, size_t segmentSize, const IPEndpoint &endpoint) const -> IoTask<size_t> {
+        if (segmentSize == 0 || segmentSize > UINT16_MAX) {
+            co_return Err(IoError::InvalidArgument);
+        }
+        if ((buffer.size() + segmentSize - 1) / segmentSize > MaxSegments) { // The short tail is a datagram too
+            co_return Err(IoError::InvalidArgument);
+        }
+        auto vec = IoVec(buffer);
+        auto control = ControlMsg<uint16_t> {IPPROTO_UDP, UDP_SEGMENT, uint16_t(segmentSize)};
+        MsgHdr msg;
+        msg.setEndpoint(endpoint);
+        msg.setBuffers(std::span(&vec, 1));
+        msg.setControl(control.buffer());
+        co_return co_await mHandle.sendmsg(msg, 0);
+    }
+#endif // defined(UDP_SEGMENT)
+
+#if defined(UDP_GRO)
+    /**
+     * @brief Receive the datagrams coalesced by the kernel (UDP GRO) in one syscall, enable it by sockopt::UdpGro first
+     * @note The buffer should be 64KB to hold a full coalesced batch, or the rest is truncated
+     * 
+     * @param buffer The buffer to receive the datagrams into, back to back
+     * @return IoTask<UdpSegments> 
+     */
+    auto recvSegments(MutableBuffer buffer) const -> IoTask<UdpSegments> {
+        auto vec = MutableIoVec(buffer);
+        auto control = ControlMsg<int> {};
+        UdpSegments segments;
+        MutableMsgHdr msg;
+        msg.setEndpoint(segments.endpoint);
+        msg.setBuffers(std::span(&vec, 1));
+        msg.setControl(control.buffer());
+        ILIAS_CO_TRY(segments.size, co_await mHandle.recvmsg(msg, 0));
+        segments.segmentSize = msg.control<int>(IPPROTO_UDP, UDP_GRO).value_or(segments.size);
+        co_return segments;
+    }
+#endif // defined(UDP_GRO)
+
     /**
      * @brief Set the socket option.
      * 
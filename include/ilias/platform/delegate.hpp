@@ -81,6 +81,13 @@ public:
     auto sendmsg(IoDescriptor *fd, const MsgHdr &msg, int flags) -> IoTask<size_t> override;
     auto recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> IoTask<size_t> override;
 
+    auto sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+    auto recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+
+    auto spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    auto spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    auto sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> override;
+
     auto poll(IoDescriptor *fd, uint32_t event) -> IoTask<uint32_t> override;
 private:
     std::shared_ptr<IoContext> mContext; //< The context to delegate to
@@ -166,6 +173,26 @@ inline auto ProxyContext::recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flag
     co_return co_await scheduleOn(mContext->recvmsg(fd, msg, flags), *mContext);
 }
 
+inline auto ProxyContext::sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    co_return co_await scheduleOn(mContext->sendmmsg(fd, msgs, flags), *mContext);
+}
+
+inline auto ProxyContext::recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    co_return co_await scheduleOn(mContext->recvmmsg(fd, msgs, flags), *mContext);
+}
+
+inline auto ProxyContext::spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    co_return co_await scheduleOn(mContext->spliceRead(fd, pipe, len), *mContext);
+}
+
+inline auto ProxyContext::spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    co_return co_await scheduleOn(mContext->spliceWrite(fd, pipe, len), *mContext);
+}
+
+inline auto ProxyContext::sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> {
+    co_return co_await scheduleOn(mContext->sendfile(fd, file, offset, len), *mContext);
+}
+
 inline auto ProxyContext::poll(IoDescriptor *fd, uint32_t events) -> IoTask<uint32_t> {
     co_return co_await scheduleOn(mContext->poll(fd, events), *mContext);
 }
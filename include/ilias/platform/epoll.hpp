@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include <ilias/runtime/metrics.hpp>
 #include <ilias/runtime/timer.hpp>
+#include <ilias/runtime/queue.hpp>
 #include <ilias/runtime/token.hpp>
 #include <ilias/io/context.hpp>
 #include <ilias/io/error.hpp>
@@ -63,6 +65,16 @@ public:
     auto sendmsg(IoDescriptor *fd, const MsgHdr &msg, int flags) -> IoTask<size_t> override;
     ///> @brief Receive a message from a descriptor
     auto recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> IoTask<size_t> override;
+    ///> @brief Send multiple messages to a descriptor by sendmmsg
+    auto sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+    ///> @brief Receive multiple messages from a descriptor by recvmmsg
+    auto recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+    ///> @brief Move the data from a descriptor into the pipe by splice
+    auto spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    ///> @brief Move the data from the pipe into a descriptor by splice
+    auto spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    ///> @brief Send the file to a descriptor by sendfile
+    auto sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> override;
 
     ///> @brief Poll a descriptor for events
     auto poll(IoDescriptor *fd, uint32_t event) -> IoTask<uint32_t> override;
@@ -70,6 +82,18 @@ public:
     ///> @brief Post a callable to the executor
     auto post(void (*fn)(void *), void *args) -> void override;
 
+    ///> @brief Post a callable to the executor with the priority class
+    auto postWithPriority(void (*fn)(void *), void *args, runtime::Priority priority) -> void override;
+
+    ///> @brief Get the ready queue statistics of the priority class
+    auto queueStats(runtime::Priority priority) const -> runtime::QueueStats override;
+
+    ///> @brief Take a snapshot of the runtime metrics
+    auto metrics() const -> RuntimeMetrics override;
+
+    ///> @brief Get the heartbeat of the loop
+    auto heartbeat() noexcept -> runtime::Heartbeat * override;
+
     ///> @brief Enter and run the task in the executor, it will infinitely loop until the token is canceled
     auto run(runtime::StopToken token) -> void override;
 
@@ -81,17 +105,17 @@ private:
     auto processTimer() -> void;
     auto pollCallbacks() -> void;
 
-    using Callback = std::pair<void (*)(void *), void *>;
-
     ///> @brief The epoll file descriptor
     FileDescriptor         mEpollFd;
     FileDescriptor         mEventFd; // For wakeup the epoll, there is some new callback in the queue
     FileDescriptor         mTimerFd; // For timer service, use timerfd for high resolution
     runtime::TimerService  mService;
-    std::deque<Callback>   mCallbacks; // The callbacks in current thread, non mutex
-    std::deque<Callback>   mPendingCallbacks; // The callbacks from another thread, protected by mMutex
+    runtime::ReadyQueue    mCallbacks; // The callbacks in current thread, non mutex
+    runtime::ReadyQueue    mPendingCallbacks; // The callbacks from another thread, protected by mMutex
     std::atomic<bool>      mWakePending; // Whether there is a pending wakeup event set?
     std::mutex             mMutex;
+    runtime::MetricsRecorder mMetrics;
+    runtime::Heartbeat     mHeartbeat;
 };
 
 } // namespace os_linux
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <ilias/detail/win32defs.hpp>
+#include <ilias/runtime/metrics.hpp>
 #include <ilias/runtime/token.hpp>
 #include <ilias/runtime/timer.hpp>
 #include <ilias/net/system.hpp> // SockInitializer
@@ -42,6 +43,8 @@ public:
     auto sleep(std::chrono::nanoseconds ns) -> Task<void> override;
 
     // For IoContext
+    auto metrics() const -> RuntimeMetrics override;
+    auto heartbeat() noexcept -> runtime::Heartbeat * override;
     auto addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<IoDescriptor*> override;
     auto removeDescriptor(IoDescriptor* fd) -> IoResult<void> override;
 
@@ -72,6 +75,8 @@ private:
     Win32Handle mIocpFd;
     Win32Handle mAfdDevice; // For poll
     std::deque<Callback> mCallbacks; // For thread local post
+    runtime::MetricsRecorder mMetrics;
+    runtime::Heartbeat mHeartbeat;
     
     // Timer
     Win32Handle mTimerFd;
@@ -218,6 +218,9 @@ inline auto QIoContext::run(runtime::StopToken token) -> void {
 inline auto QIoContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<IoDescriptor*> {
     auto nfd = std::make_unique<QIoDescriptor>(this);
 
+    if (type == IoDescriptor::Accepted) {
+        type = IoDescriptor::Socket;
+    }
     // If the type is unknown, we need to check it
     if (type == IoDescriptor::Unknown) {
         auto ret = fd_utils::type(fd);
@@ -10,10 +10,14 @@
  */
 #pragma once
 
+#include <ilias/runtime/metrics.hpp>
+#include <ilias/runtime/queue.hpp>
 #include <ilias/net/sockfd.hpp>
 #include <ilias/io/context.hpp>
+#include <ilias/io/ext.hpp> // SplicePipe
 #include <liburing.h>
 #include <thread>
+#include <vector>
 #include <deque>
 
 ILIAS_NS_BEGIN
@@ -41,6 +45,10 @@ public:
 
     // For Executor
     auto post(void (*fn)(void *), void *args) -> void override;
+    auto postWithPriority(void (*fn)(void *), void *args, runtime::Priority priority) -> void override;
+    auto queueStats(runtime::Priority priority) const -> runtime::QueueStats override;
+    auto metrics() const -> RuntimeMetrics override;
+    auto heartbeat() noexcept -> runtime::Heartbeat * override;
     auto run(runtime::StopToken token) -> void override;
     auto sleep(std::chrono::nanoseconds ns) -> Task<void> override;
 
@@ -59,6 +67,11 @@ public:
 
     auto sendmsg(IoDescriptor *fd, const MsgHdr &msg, int flags) -> IoTask<size_t> override;
     auto recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> IoTask<size_t> override;
+    auto sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+    auto recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> override;
+    auto spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    auto spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> override;
+    auto sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> override;
 
     auto poll(IoDescriptor *fd, uint32_t event) -> IoTask<uint32_t> override;
 
@@ -68,13 +81,16 @@ private:
     auto processCompletion() -> void;
     auto allocSqe() -> ::io_uring_sqe *;
 
-    using Callback = std::pair<void (*)(void *), void *>;
-
     ::io_uring           mRing {};
     int                  mEventFd = -1;
-    std::deque<Callback> mCallbacks; // The callbacks in current thread, non mutex
-    std::deque<Callback> mPendingCallbacks; // The callbacks from another thread, protected by mMutex
+    runtime::ReadyQueue  mCallbacks; // The callbacks in current thread, non mutex
+    runtime::ReadyQueue  mPendingCallbacks; // The callbacks from another thread, protected by mMutex
     std::mutex           mMutex;
+    runtime::MetricsRecorder mMetrics;
+    runtime::Heartbeat   mHeartbeat;
+    std::vector<SplicePipe> mPipes; // The idle (drained) pipes for sendfile, at most MaxIdlePipes
+
+    static constexpr size_t MaxIdlePipes = 4;
 
     // Features
     struct {
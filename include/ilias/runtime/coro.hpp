@@ -3,6 +3,7 @@
 #include <ilias/runtime/exception.hpp> // ExceptionPtr
 #include <ilias/runtime/executor.hpp> // Executor
 #include <ilias/runtime/tracing.hpp> // TracingSubscriber
+#include <ilias/runtime/local.hpp> // LocalStorage
 #include <ilias/runtime/capture.hpp> // CaptureSource, StackFrame
 #include <ilias/runtime/token.hpp> // StopToken
 #include <ilias/runtime/await.hpp> // Awaitable
@@ -127,21 +128,157 @@ public:
         return mTraceContext;
     }
 
+    // LOCALS: Get the task local storage (nullptr on nothing set)
+    auto locals() const noexcept -> const LocalStorage::Ptr & {
+        return mLocals;
+    }
+
+    auto setLocals(LocalStorage::Ptr locals) noexcept -> void {
+        mLocals = std::move(locals);
+    }
+
+    // Get the priority class used when the coroutine is scheduled
+    auto priority() const noexcept -> Priority {
+        return mPriority;
+    }
+
+    auto setPriority(Priority priority) noexcept -> void {
+        mPriority = priority;
+    }
+
+    // Inherit the environment (locals, priority) from the parent context
+    auto inherit(const CoroContext &parent) noexcept -> void {
+        mLocals = parent.mLocals;
+        mPriority = parent.mPriority;
+    }
+
+    // Mark the context as running on the current thread, call on the coroutine resumed
+    auto enter() noexcept -> void {
+#if defined(ILIAS_TASK_LOCAL)
+        // Already running if equal (a nested task in the same context or resume without suspend), keep the previous one
+        auto &running = runningSlot();
+        if (running != this) {
+            mPrevious = running;
+            running = this;
+        }
+#endif // defined(ILIAS_TASK_LOCAL)
+    }
+
+    // Restore the running context to the previous one, call before the coroutine suspended
+    auto leave() noexcept -> void {
+#if defined(ILIAS_TASK_LOCAL)
+        runningSlot() = mPrevious;
+#endif // defined(ILIAS_TASK_LOCAL)
+#if defined(ILIAS_CORO_TRACE)
+        captureHeartbeat();
+#endif // defined(ILIAS_CORO_TRACE)
+    }
+
+    // Get the context of the coroutine running on the current thread (nullptr if not in coroutine or task local disabled)
+    static auto current() noexcept -> CoroContext * {
+#if defined(ILIAS_TASK_LOCAL)
+        return runningSlot();
+#else
+        return nullptr;
+#endif // defined(ILIAS_TASK_LOCAL)
+    }
+
     // Other operator
     auto operator =(CoroContext &&) -> CoroContext & = default;
     auto operator =(const CoroContext &) -> CoroContext & = delete;
 private:
+#if defined(_WIN32) && defined(ILIAS_DLL) // The thread_local variable can't be imported from the dll, keep it in the library
+    ILIAS_API
+    static auto runningSlot() noexcept -> CoroContext *&;
+#else
+    static auto runningSlot() noexcept -> CoroContext *& {
+        static thread_local constinit CoroContext *running = nullptr;
+        return running;
+    }
+#endif // defined(_WIN32) && defined(ILIAS_DLL)
+
+    // The watchdog wants to know who stalled the loop, capture our stacktrace if the heartbeat asks for it
+    ILIAS_API
+    auto captureHeartbeat() noexcept -> void;
+
     StopSource    mStopSource;                               // Used to request cooperative cancellation
     Executor     *mExecutor = nullptr;
     void        (*mStoppedHandler)(CoroContext &) = nullptr; // Called when coroutine is stopped
     void         *mUser = nullptr;                           // The user data, useful in the callback
     bool          mStopped = false;                          // The coroutine is actually stopped
+    Priority      mPriority = Priority::Normal;              // The priority class used when scheduled
     [[ILIAS_NO_UNIQUE_ADDRESS]]
     TraceContext  mTraceContext;                             // The context used for tracing
+    LocalStorage::Ptr mLocals;                               // The task local values, shared with the children
+#if defined(ILIAS_TASK_LOCAL)
+    CoroContext  *mPrevious = nullptr;                       // The context running before we enter, restore on leave
+#endif // defined(ILIAS_TASK_LOCAL)
 friend class CoroPromise;
 friend class CoroHandle;
 };
 
+// MARK: ContextAwaitable
+// Add hooks to an awaitable, used for tracking the running context (and tracing if enabled)
+template <typename T, bool Forward>
+class ContextAwaitable {
+public:
+    // Forward version just store the reference, the awaitable lives until the end of the co_await expression
+    using Awaitable = std::conditional_t<Forward, T &&, std::decay_t<T> >;
+    using Awaiter   = decltype(toAwaiter(std::declval<Awaitable>()));
+
+    ContextAwaitable(T &&awaitable, CoroContext &ctxt) : 
+        mAwaitable(std::forward<T>(awaitable)), 
+        mAwaiter(toAwaiter(static_cast<Awaitable &&>(mAwaitable))),
+        mCtxt(ctxt) {}
+
+    // MUST NRVO, Pin the awaitable, avoid the awaiter implementation need an stable awaitable address, it will cause dangling if move
+    ContextAwaitable(const ContextAwaitable &) = delete;
+
+    // Hooks
+    auto await_ready() noexcept(noexcept(mAwaiter.await_ready())) { 
+        return mAwaiter.await_ready(); 
+    }
+
+    template <typename U>
+    auto await_suspend(std::coroutine_handle<U> handle) noexcept(noexcept(mAwaiter.await_suspend(handle))) {
+        using Ret = decltype(mAwaiter.await_suspend(handle));
+        mCtxt.leave(); // Leave before, the coroutine may be resumed (or destroyed) in another thread after the call
+#if defined(ILIAS_CORO_TRACE)
+        if constexpr (std::is_same_v<Ret, void>) {
+            mAwaiter.await_suspend(handle);
+            mCtxt.tracing().suspend();
+            return;
+        }
+        else if constexpr (std::convertible_to<Ret, bool>) { // Return bool
+            auto ret = mAwaiter.await_suspend(handle);
+            if (ret) { // true on actually suspend
+                mCtxt.tracing().suspend();
+            }
+            return ret;
+        }
+        else { // std::coroutine_handle<>
+            auto ret = mAwaiter.await_suspend(handle);
+            mCtxt.tracing().suspend();
+            return ret;
+        }
+#else
+        return static_cast<Ret>(mAwaiter.await_suspend(handle));
+#endif // defined(ILIAS_CORO_TRACE)
+    }
+
+    auto await_resume() noexcept(noexcept(mAwaiter.await_resume())) -> decltype(auto) { 
+        mCtxt.enter();
+#if defined(ILIAS_CORO_TRACE)
+        mCtxt.tracing().resume();
+#endif // defined(ILIAS_CORO_TRACE)
+        return mAwaiter.await_resume();
+    }
+private:
+    Awaitable    mAwaitable;
+    Awaiter      mAwaiter;
+    CoroContext &mCtxt;
+};
+
 // MARK: CoroPromise
 // The common part of all stackless coroutines
 class CoroPromise {
@@ -197,17 +334,17 @@ public:
         else if constexpr (requires { awaitable.setContext(*mContext); }) { // It support setContext
             awaitable.setContext(*mContext);
         }
-#if defined(ILIAS_CORO_TRACE)
-        if constexpr (requires { typename T::SkipTracing; }) {
+#if defined(ILIAS_TASK_LOCAL) || defined(ILIAS_CORO_TRACE)
+        if constexpr (requires { typename T::SkipTracing; }) { // It never suspend, no hooks needed
             return std::forward<T>(awaitable);
         }
         else {
             static_assert(Forward || std::move_constructible<std::decay_t<T> >, "Awaitable must be move_constructible, it will be moved to the awaiter");
-            return TracingAwaitable<T, Forward> { std::forward<T>(awaitable), mContext->tracing()}; // Wrap it with tracing
+            return ContextAwaitable<T, Forward> { std::forward<T>(awaitable), *mContext }; // Wrap it with the hooks
         }
 #else
-        return std::forward<T>(awaitable);
-#endif // defined(ILIAS_CORO_TRACE)
+        return std::forward<T>(awaitable); // Nothing to track, no hooks needed
+#endif // defined(ILIAS_TASK_LOCAL) || defined(ILIAS_CORO_TRACE)
     }
 
     // co_await for can be converted to raw awaitable
@@ -229,6 +366,7 @@ public:
     // Doing sth before the coroutine starts
     auto init() noexcept -> void {
         ILIAS_ASSERT(mContext, "Coroutine context must be set before coroutine starts");
+        mContext->enter();
 #if defined(ILIAS_CORO_TRACE)
         // TRACING: Push the frame, we are start now
         mContext->tracing().resume();
@@ -238,6 +376,7 @@ public:
 
     // Doing sth after the coroutine done
     auto final() noexcept -> std::coroutine_handle<> {
+        mContext->leave();
         if (mCompletionHandler) {
             mCompletionHandler(*mContext);
         }
@@ -351,7 +490,7 @@ public:
     // Resume in the executor
     auto schedule() const noexcept -> void {
         ILIAS_ASSERT(!context().isStopped(), "Cannot schedule a stopped coroutine");
-        return executor().schedule(mHandle);
+        return executor().schedule(mHandle, context().mPriority);
     }
 
     // Get the stop source from the environment
@@ -507,6 +646,33 @@ inline auto name() noexcept {
     return Awaiter {};
 }
 
+// Get the priority class of the current coroutine context
+[[nodiscard]]
+inline auto priority() noexcept {
+    struct Awaiter : AwaiterBase {
+        auto await_resume() noexcept -> runtime::Priority {
+            return mCtxt->priority();
+        }
+    };
+
+    return Awaiter {};
+}
+
+// Set the priority class of the current coroutine context, it take effect on the next schedule
+inline auto setPriority(runtime::Priority priority) noexcept {
+    struct Awaiter : AwaiterBase {
+        auto await_resume() noexcept {
+            mCtxt->setPriority(priority);
+        }
+
+        runtime::Priority priority;
+    };
+
+    Awaiter awaiter {};
+    awaiter.priority = priority;
+    return awaiter;
+}
+
 // Set the name to the current coroutine context
 inline auto setName(std::string_view name) noexcept {
     struct Awaiter : AwaiterBase {
@@ -24,6 +24,30 @@ ILIAS_NS_BEGIN
 
 namespace runtime {
 
+/**
+ * @brief The priority class of the work posted to the executor
+ * 
+ */
+enum class Priority : uint8_t {
+    High       = 0, // Latency sensitive work, like the request handlers
+    Normal     = 1, // The default one
+    Background = 2, // Throughput work, like the compaction
+};
+
+inline constexpr size_t PriorityCount = 3;
+
+/**
+ * @brief The statistics of the ready queue for one priority class
+ * 
+ */
+struct QueueStats {
+    size_t                   depth = 0;  // The number of callbacks waiting in the queue
+    size_t                   count = 0;  // The number of callbacks dequeued
+    size_t                   samples = 0; // The number of dequeued callbacks whose wait is measured (a sample of the count)
+    std::chrono::nanoseconds totalWait {}; // The sum of the time between enqueue and dequeue of the samples
+    std::chrono::nanoseconds maxWait {}; // The max time between enqueue and dequeue of the samples
+};
+
 /**
  * @brief Executor, it can post a callable and execute it in the run() method, it is one loop per thread
  * 
@@ -40,6 +64,25 @@ public:
      */
     virtual auto post(void (*fn)(void *), void *args) -> void = 0;
 
+    /**
+     * @brief Post a callable to the executor with the priority class (thread safe)
+     * @note The default implementation ignores the priority, just forward to the post()
+     * 
+     * @param fn The function to post (can not be null)
+     * @param args The arguments of the function
+     * @param priority The priority class of it
+     */
+    virtual auto postWithPriority(void (*fn)(void *), void *args, Priority priority) -> void;
+
+    /**
+     * @brief Get the ready queue statistics of the priority class
+     * @note The default implementation returns empty stats
+     * 
+     * @param priority 
+     * @return QueueStats 
+     */
+    virtual auto queueStats(Priority priority) const -> QueueStats;
+
     /**
      * @brief Enter and run the task in the executor, it will infinitely loop until the token is canceled
      * 
@@ -77,6 +120,16 @@ public:
         post(scheduleImpl, h.address());
     }
 
+    /**
+     * @brief Schedule a coroutine to the executor with the priority class (thread safe)
+     * 
+     * @param h The coroutine handle (can not be null)
+     * @param priority The priority class of it
+     */
+    auto schedule(std::coroutine_handle<> h, Priority priority) -> void {
+        postWithPriority(scheduleImpl, h.address(), priority);
+    }
+
     /**
      * @brief Schedule a callable to the executor (thread safe)
      * 
@@ -129,6 +182,8 @@ public:
     ~EventLoop();
 
     auto post(void (*fn)(void *), void *args) -> void override;
+    auto postWithPriority(void (*fn)(void *), void *args, Priority priority) -> void override;
+    auto queueStats(Priority priority) const -> QueueStats override;
     auto run(StopToken token) -> void override;
     auto sleep(std::chrono::nanoseconds ns) -> Task<void> override;
 private:
@@ -179,5 +234,6 @@ namespace runtime::threadpool {
 
 // Re-export the EventLoop
 using runtime::EventLoop;
+using runtime::Priority;
 
 ILIAS_NS_END
\ No newline at end of file
@@ -0,0 +1,54 @@
+// INTERNAL !!!
+#pragma once
+
+#include <ilias/defines.hpp>
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+
+ILIAS_NS_BEGIN
+
+namespace runtime {
+
+// MARK: LocalStorage
+// The storage of the task local values, indexed by the slot allocated by TaskLocal<T>
+//
+// Invariants:
+// - The storage is immutable after published to a context, set a value will copy it (copy on write),
+//   so the children can share it with the parent without any synchronization.
+// - Lookup is O(1), just an bound check and an index, no allocation.
+class LocalStorage {
+public:
+    using Value = std::shared_ptr<void>;
+    using Ptr   = std::shared_ptr<const LocalStorage>;
+
+    // Get the value of the slot, nullptr on not set
+    auto get(size_t slot) const noexcept -> void * {
+        if (slot < mValues.size()) {
+            return mValues[slot].get();
+        }
+        return nullptr;
+    }
+
+    // Make a new storage by replacing the value of the slot from the base one (nullptr is ok)
+    static auto with(const Ptr &base, size_t slot, Value value) -> Ptr {
+        auto storage = std::make_shared<LocalStorage>();
+        if (base) {
+            storage->mValues = base->mValues;
+        }
+        if (slot >= storage->mValues.size()) {
+            storage->mValues.resize(slot + 1);
+        }
+        storage->mValues[slot] = std::move(value);
+        return storage;
+    }
+
+    // Allocate a new slot index for the task local, thread safe
+    ILIAS_API
+    static auto allocateSlot() noexcept -> size_t;
+private:
+    std::vector<Value> mValues;
+};
+
+} // namespace runtime
+
+ILIAS_NS_END
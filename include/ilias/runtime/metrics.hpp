@@ -0,0 +1,334 @@
+/**
+ * @file metrics.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The runtime metrics of the executor, like callbacks per tick, time blocked in the os wait, etc.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/executor.hpp> // QueueStats, PriorityCount
+#include <ilias/runtime/capture.hpp> // Stacktrace
+#include <ilias/defines.hpp>
+#include <algorithm> // std::min
+#include <optional> // std::optional
+#include <atomic> // std::atomic
+#include <mutex> // std::mutex
+#include <chrono> // std::chrono::nanoseconds
+#include <array> // std::array
+#include <bit> // std::bit_width
+#include <type_traits> // std::type_identity_t
+#include <utility> // std::exchange
+
+ILIAS_NS_BEGIN
+
+namespace runtime {
+
+// MARK: Histogram
+/**
+ * @brief The log2 histogram of durations
+ *
+ * The bucket 0 holds the 0ns, the bucket i holds [2^(i-1), 2^i) ns, the last bucket holds all the larger ones (>= ~1s)
+ */
+struct Histogram {
+    static constexpr size_t BucketCount = 32;
+
+    std::array<uint64_t, BucketCount> buckets {};
+    uint64_t                          count = 0; // The number of samples
+    std::chrono::nanoseconds          sum {};    // The sum of all samples
+    std::chrono::nanoseconds          max {};    // The max sample
+
+    /**
+     * @brief Get the bucket index of the duration
+     *
+     * @param ns
+     * @return size_t
+     */
+    static constexpr auto bucketOf(std::chrono::nanoseconds ns) noexcept -> size_t {
+        if (ns.count() <= 0) {
+            return 0;
+        }
+        return std::min<size_t>(std::bit_width(uint64_t(ns.count())), BucketCount - 1);
+    }
+
+    /**
+     * @brief Get the (exclusive) upper bound of the bucket
+     *
+     * @param idx
+     * @return std::chrono::nanoseconds
+     */
+    static constexpr auto upperBound(size_t idx) noexcept -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds(int64_t(1) << idx);
+    }
+
+    /**
+     * @brief Get the mean of the samples
+     *
+     * @return std::chrono::nanoseconds
+     */
+    auto mean() const noexcept -> std::chrono::nanoseconds {
+        return count ? sum / int64_t(count) : std::chrono::nanoseconds {};
+    }
+
+    /**
+     * @brief Get the approximate percentile, it is the upper bound of the bucket (capped by max)
+     *
+     * @param p In [0, 1], like 0.99
+     * @return std::chrono::nanoseconds
+     */
+    auto percentile(double p) const noexcept -> std::chrono::nanoseconds {
+        if (count == 0) {
+            return {};
+        }
+        auto rank = uint64_t(double(count) * std::clamp(p, 0.0, 1.0));
+        auto seen = uint64_t(0);
+        for (size_t i = 0; i < BucketCount; ++i) {
+            seen += buckets[i];
+            if (seen > rank || seen == count) {
+                return std::min(i == 0 ? std::chrono::nanoseconds {} : upperBound(i), max);
+            }
+        }
+        return max;
+    }
+};
+
+// MARK: RuntimeMetrics
+/**
+ * @brief The snapshot of the runtime metrics of an executor
+ *
+ */
+struct RuntimeMetrics {
+    uint64_t                 ticks       = 0;  // The number of the loop iterations
+    uint64_t                 callbacks   = 0;  // The number of the callbacks executed
+    uint64_t                 remotePosts = 0;  // The number of the callbacks posted from another thread
+    uint64_t                 polls       = 0;  // The number of the os wait (epoll_wait, io_uring_wait_cqe, GetQueuedCompletionStatusEx ...)
+    std::chrono::nanoseconds pollBlocked {};   // The total time blocked in the os wait
+    size_t                   descriptors = 0;  // The number of the descriptors registered
+    size_t                   timers      = 0;  // The number of the pending timers (0 if the backend uses kernel timeouts)
+    Histogram                pollDuration;     // The time of each os wait
+    Histogram                callbackDuration; // The time of each callback (aka. the task poll time)
+    std::array<QueueStats, PriorityCount> queues; // The ready queue stats of each priority class
+
+    /**
+     * @brief Get the average callbacks executed in one tick
+     *
+     * @return double
+     */
+    auto callbacksPerTick() const noexcept -> double {
+        return ticks ? double(callbacks) / double(ticks) : 0.0;
+    }
+};
+
+// MARK: Recorder
+// INTERNAL !!!, The recorder used by the executor to collect the metrics
+//
+// - All the on*() are called by the executor's own thread, except the onRemotePost() and onDescriptor*(),
+//   so we just use load & store instead of rmw on the hot path, the snapshot() can be called from any thread.
+// - The snapshot is not atomic as a whole, the fields may be from slightly different moments.
+class MetricsRecorder final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MetricsRecorder() = default;
+    MetricsRecorder(const MetricsRecorder &) = delete;
+
+    // One iteration of the loop
+    auto onTick(size_t timers = 0) noexcept -> void {
+        add(mTicks, 1);
+        mTimers.store(timers, std::memory_order_relaxed);
+    }
+
+    // One callback done, it takes the duration
+    auto onCallback(std::chrono::nanoseconds duration) noexcept -> void {
+        add(mCallbacks, 1);
+        mCallbackDuration.record(duration);
+    }
+
+    // One os wait done, it blocked for the duration
+    auto onPoll(std::chrono::nanoseconds duration) noexcept -> void {
+        add(mPolls, 1);
+        add(mPollBlocked, duration.count());
+        mPollDuration.record(duration);
+    }
+
+    // Thread safe
+    auto onRemotePost() noexcept -> void {
+        mRemotePosts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Thread safe
+    auto onDescriptorAdded() noexcept -> void {
+        mDescriptors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Thread safe
+    auto onDescriptorRemoved() noexcept -> void {
+        mDescriptors.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Take the snapshot (thread safe), the queues field is left to the executor
+    auto snapshot() const noexcept -> RuntimeMetrics {
+        return {
+            .ticks            = mTicks.load(std::memory_order_relaxed),
+            .callbacks        = mCallbacks.load(std::memory_order_relaxed),
+            .remotePosts      = mRemotePosts.load(std::memory_order_relaxed),
+            .polls            = mPolls.load(std::memory_order_relaxed),
+            .pollBlocked      = std::chrono::nanoseconds(mPollBlocked.load(std::memory_order_relaxed)),
+            .descriptors      = mDescriptors.load(std::memory_order_relaxed),
+            .timers           = mTimers.load(std::memory_order_relaxed),
+            .pollDuration     = mPollDuration.snapshot(),
+            .callbackDuration = mCallbackDuration.snapshot(),
+            .queues           = {},
+        };
+    }
+private:
+    struct HistogramRecorder {
+        std::array<std::atomic<uint64_t>, Histogram::BucketCount> buckets {};
+        std::atomic<uint64_t> count {0};
+        std::atomic<int64_t>  sum {0};
+        std::atomic<int64_t>  max {0};
+
+        auto record(std::chrono::nanoseconds ns) noexcept -> void {
+            add(buckets[Histogram::bucketOf(ns)], 1);
+            add(count, 1);
+            add(sum, ns.count());
+            if (ns.count() > max.load(std::memory_order_relaxed)) {
+                max.store(ns.count(), std::memory_order_relaxed);
+            }
+        }
+
+        auto snapshot() const noexcept -> Histogram {
+            auto h = Histogram {};
+            for (size_t i = 0; i < Histogram::BucketCount; ++i) {
+                h.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+            }
+            h.count = count.load(std::memory_order_relaxed);
+            h.sum = std::chrono::nanoseconds(sum.load(std::memory_order_relaxed));
+            h.max = std::chrono::nanoseconds(max.load(std::memory_order_relaxed));
+            return h;
+        }
+    };
+
+    // Single writer add, no lock prefix
+    template <typename T>
+    static auto add(std::atomic<T> &value, std::type_identity_t<T> n) noexcept -> void {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> mTicks {0};
+    std::atomic<uint64_t> mCallbacks {0};
+    std::atomic<uint64_t> mRemotePosts {0};
+    std::atomic<uint64_t> mPolls {0};
+    std::atomic<int64_t>  mPollBlocked {0};
+    std::atomic<size_t>   mDescriptors {0};
+    std::atomic<size_t>   mTimers {0};
+    HistogramRecorder     mPollDuration;
+    HistogramRecorder     mCallbackDuration;
+};
+
+// MARK: Heartbeat
+// INTERNAL !!!, The heartbeat of the loop, used by the watchdog to find the callback blocking the loop
+//
+// - The loop calls beat() before each callback and idle() before blocking in the os wait, it is just two relaxed stores.
+// - The watchdog arm() the sequence of the stalled callback, then the first coroutine leaving its context (suspend or complete)
+//   in the same callback captures its stacktrace on the loop thread, so it is safe to access the trace frames.
+//   Only with the coro trace enabled, otherwise nothing is captured and the watchdog reports without the stacktrace.
+class ILIAS_API Heartbeat final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Capture {
+        Stacktrace        stacktrace; // The stacktrace of the coroutine (empty if the coro trace is disabled)
+        Clock::time_point when;       // The time the coroutine left its context
+    };
+
+    // RAII, Make the heartbeat as the current thread's one, used in the executor's run()
+    class Scope {
+    public:
+        explicit Scope(Heartbeat &heartbeat) noexcept : mPrev(setCurrent(&heartbeat)) {}
+        Scope(const Scope &) = delete;
+        ~Scope() { setCurrent(mPrev); }
+    private:
+        Heartbeat *mPrev;
+    };
+
+    Heartbeat() = default;
+    Heartbeat(const Heartbeat &) = delete;
+
+    // A callback begins at the timepoint (loop thread)
+    auto beat(Clock::time_point begin) noexcept -> void {
+        mSequence.store(mSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        mSince.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // No callback running, going to block in the os wait (loop thread)
+    auto idle() noexcept -> void {
+        mSince.store(0, std::memory_order_relaxed);
+    }
+
+    // Get the begin of the running callback (thread safe), nullopt on idle
+    auto since() const noexcept -> std::optional<Clock::time_point> {
+        auto since = mSince.load(std::memory_order_relaxed);
+        if (since == 0) {
+            return std::nullopt;
+        }
+        return Clock::time_point(Clock::duration(since));
+    }
+
+    // Get the sequence of the running (or last) callback (thread safe)
+    auto sequence() const noexcept -> uint64_t {
+        return mSequence.load(std::memory_order_relaxed);
+    }
+
+    // Request to capture the stacktrace in the callback of the sequence (thread safe)
+    auto arm(uint64_t sequence) noexcept -> void {
+        mArmed.store(sequence, std::memory_order_relaxed);
+    }
+
+    // Take the capture of the callback of the sequence, and disarm it (thread safe)
+    auto take(uint64_t sequence) -> std::optional<Capture> {
+        std::lock_guard locker {mMutex};
+        auto expected = sequence;
+        mArmed.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+        if (mCapturedSequence != sequence) {
+            return std::nullopt;
+        }
+        mCapturedSequence = 0;
+        return std::exchange(mCapture, {});
+    }
+
+    // Check the watchdog wants the stacktrace in the current callback (loop thread)
+    auto wanted() const noexcept -> bool {
+        auto armed = mArmed.load(std::memory_order_relaxed);
+        return armed != 0 && armed == mSequence.load(std::memory_order_relaxed);
+    }
+
+    // Store the stacktrace of the coroutine leaving its context (loop thread)
+    auto capture(Stacktrace stacktrace) -> void {
+        std::lock_guard locker {mMutex};
+        mCapture = Capture {std::move(stacktrace), Clock::now()};
+        mCapturedSequence = mSequence.load(std::memory_order_relaxed);
+        mArmed.store(0, std::memory_order_relaxed);
+    }
+
+    // Get the heartbeat of the loop running on the current thread (nullptr on none)
+    static auto current() noexcept -> Heartbeat *;
+private:
+    static auto setCurrent(Heartbeat *heartbeat) noexcept -> Heartbeat *; // Return the previous one
+
+    std::atomic<int64_t>  mSince {0};    // The begin of the running callback in the clock ticks, 0 on idle
+    std::atomic<uint64_t> mSequence {0}; // The sequence of the callbacks
+    std::atomic<uint64_t> mArmed {0};    // The sequence that the watchdog wants the stacktrace, 0 on none
+    std::mutex            mMutex;        // Protect the capture
+    uint64_t              mCapturedSequence = 0;
+    Capture               mCapture;
+};
+
+} // namespace runtime
+
+using runtime::RuntimeMetrics;
+
+ILIAS_NS_END
@@ -0,0 +1,174 @@
+// INTERNAL !!!
+/**
+ * @file queue.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief Provide the multi-level ready queue, useful when you write the executor's callback queue
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <ilias/runtime/executor.hpp> // Priority, QueueStats
+#include <ilias/defines.hpp>
+#include <utility> // std::pair
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <array> // std::array
+#include <deque> // std::deque
+
+ILIAS_NS_BEGIN
+
+namespace runtime {
+
+// MARK: ReadyQueue
+// The ready queue with one FIFO per priority class, dequeue by weighted round robin.
+//
+// - In each round, the class i can be dequeued at most weights[i] times, from High to Background.
+//   The round restarts when all non-empty classes run out of credits, so the Background can't be starved.
+//   It also restarts when the queue is drained, so a new burst is always dequeued from High first.
+// - The wait time is measured on 1 of SampleRate pushes per class, so the hot path doesn't read the clock on every post.
+// - It is not thread safe, except the stats() can be called from any thread.
+class ReadyQueue final {
+public:
+    using Callback = std::pair<void (*)(void *), void *>;
+    using Weights  = std::array<uint32_t, PriorityCount>;
+    using Clock    = std::chrono::steady_clock;
+
+    static constexpr Weights DefaultWeights {16, 4, 1};
+    static constexpr uint32_t SampleRate = 16;
+
+    ReadyQueue(Weights weights = DefaultWeights) {
+        for (size_t i = 0; i < PriorityCount; ++i) {
+            ILIAS_ASSERT(weights[i] > 0, "The weight must be greater than 0");
+            mLevels[i].weight = weights[i];
+            mLevels[i].credit = weights[i];
+        }
+    }
+    ReadyQueue(const ReadyQueue &) = delete;
+
+    // Push a callback to the class of the priority
+    auto push(Callback cb, Priority priority = Priority::Normal) -> void {
+        auto &level = mLevels[static_cast<size_t>(priority)];
+        auto sampled = level.pushes++ % SampleRate == 0;
+        level.queue.push_back({cb, sampled ? Clock::now() : Clock::time_point {}});
+        level.depth.store(level.queue.size(), std::memory_order_relaxed);
+    }
+
+    // Pop a callback by weighted round robin, the queue must not be empty
+    auto pop() -> Callback {
+        ILIAS_ASSERT(!empty(), "Can't pop from an empty queue");
+        while (true) {
+            for (auto &level : mLevels) {
+                if (level.queue.empty() || level.credit == 0) {
+                    continue;
+                }
+                level.credit -= 1;
+                auto cb = take(level);
+                if (empty()) { // Drained, so the next burst starts with a fresh round
+                    resetCredits();
+                }
+                return cb;
+            }
+            resetCredits(); // All non-empty classes run out of credits, start a new round
+        }
+    }
+
+    // Move all callbacks from the other queue to the tail of self, keep the enqueue time
+    auto splice(ReadyQueue &other) -> void {
+        for (size_t i = 0; i < PriorityCount; ++i) {
+            auto &self = mLevels[i];
+            auto &from = other.mLevels[i];
+            if (self.queue.empty()) { // Use swap to make it faster
+                self.queue.swap(from.queue);
+            }
+            else {
+                self.queue.insert(self.queue.end(), from.queue.begin(), from.queue.end());
+            }
+            from.queue.clear();
+            self.depth.store(self.queue.size(), std::memory_order_relaxed);
+            from.depth.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    auto empty() const noexcept -> bool {
+        for (auto &level : mLevels) {
+            if (!level.queue.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto size() const noexcept -> size_t {
+        size_t n = 0;
+        for (auto &level : mLevels) {
+            n += level.queue.size();
+        }
+        return n;
+    }
+
+    // Get the stats of the priority class (thread safe)
+    auto stats(Priority priority) const noexcept -> QueueStats {
+        auto &level = mLevels[static_cast<size_t>(priority)];
+        return {
+            .depth     = level.depth.load(std::memory_order_relaxed),
+            .count     = level.count.load(std::memory_order_relaxed),
+            .samples   = level.samples.load(std::memory_order_relaxed),
+            .totalWait = std::chrono::nanoseconds(level.totalWait.load(std::memory_order_relaxed)),
+            .maxWait   = std::chrono::nanoseconds(level.maxWait.load(std::memory_order_relaxed)),
+        };
+    }
+private:
+    struct Entry {
+        Callback          cb;
+        Clock::time_point enqueued; // Zero on not sampled
+    };
+
+    // The stats only written by the owner thread, so we just use load & store instead of rmw
+    struct Level {
+        std::deque<Entry>    queue;
+        uint32_t             weight = 0;
+        uint32_t             credit = 0; // The remaining dequeue times in the current round
+        uint32_t             pushes = 0; // Used to pick the samples
+        std::atomic<size_t>  depth {0};
+        std::atomic<size_t>  count {0};
+        std::atomic<size_t>  samples {0};
+        std::atomic<int64_t> totalWait {0};
+        std::atomic<int64_t> maxWait {0};
+    };
+
+    auto resetCredits() noexcept -> void {
+        for (auto &level : mLevels) {
+            level.credit = level.weight;
+        }
+    }
+
+    static auto take(Level &level) -> Callback {
+        auto entry = level.queue.front();
+        level.queue.pop_front();
+
+        level.depth.store(level.queue.size(), std::memory_order_relaxed);
+        level.count.store(level.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (entry.enqueued == Clock::time_point {}) { // Not sampled
+            return entry.cb;
+        }
+
+        auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - entry.enqueued).count();
+        level.samples.store(level.samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        level.totalWait.store(level.totalWait.load(std::memory_order_relaxed) + wait, std::memory_order_relaxed);
+        if (wait > level.maxWait.load(std::memory_order_relaxed)) {
+            level.maxWait.store(wait, std::memory_order_relaxed);
+        }
+        return entry.cb;
+    }
+
+    std::array<Level, PriorityCount> mLevels;
+};
+
+} // namespace runtime
+
+ILIAS_NS_END
@@ -58,6 +58,13 @@ public:
      */
     auto nextTimepoint() const -> std::optional<TimePoint>;
 
+    /**
+     * @brief Get the number of the pending timers
+     * 
+     * @return size_t 
+     */
+    auto size() const noexcept -> size_t { return mTimers.size(); }
+
     /**
      * @brief Set the Callback when the nextTimepoint is updated
      * @note Caller should only do update the timerfd in it, don't enter the event loop, it may cause undefined behavior
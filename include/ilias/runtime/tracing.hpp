@@ -206,68 +206,6 @@ public:
     static auto currentThread() noexcept -> TracingSubscriber *;
 };
 
-// MARK: TracingAwaitable
-// Add hooks to an awaitable, used for tracing
-template <typename T, bool Forward>
-class TracingAwaitable {
-public:
-    template <typename U>
-    using DecayIf     = std::conditional_t<Forward, U, std::decay_t<U> >;
-    using Awaitable   = DecayIf<T>;
-    using Awaiter     = DecayIf<decltype(toAwaiter(std::declval<T>()))>;
-
-    // Move version, store it by value
-    TracingAwaitable(T awaitable, TraceContext &ctxt) requires(!Forward) : 
-        mAwaitable(std::move(awaitable)), 
-        mAwaiter(toAwaiter(std::move(mAwaitable))),
-        mCtxt(ctxt) {}
-
-    // Forward version, just store the reference
-    TracingAwaitable(T awaitable, TraceContext &ctxt) requires(Forward) :
-        mAwaitable(std::forward<T>(awaitable)),
-        mAwaiter(toAwaiter(std::forward<T>(mAwaitable))),
-        mCtxt(ctxt) {}
-
-    // MUST NRVO, Pin the awaitable, avoid the awaiter implementation need an stable awaitable address, it will cause dangling if move
-    TracingAwaitable(const TracingAwaitable &) = delete;
-
-    // Hooks
-    auto await_ready() noexcept(noexcept(mAwaiter.await_ready())) { 
-        return mAwaiter.await_ready(); 
-    }
-
-    template <typename U>
-    auto await_suspend(std::coroutine_handle<U> handle) noexcept(noexcept(mAwaiter.await_suspend(handle))) {
-        using Ret = decltype(mAwaiter.await_suspend(handle));
-        if constexpr (std::is_same_v<Ret, void>) {
-            mAwaiter.await_suspend(handle);
-            mCtxt.suspend();
-            return;
-        }
-        else if constexpr (std::convertible_to<Ret, bool>) { // Return bool
-            auto ret = mAwaiter.await_suspend(handle);
-            if (ret) { // true on actually suspend
-                mCtxt.suspend();
-            }
-            return ret;
-        }
-        else { // std::coroutine_handle<>
-            auto ret = mAwaiter.await_suspend(handle);
-            mCtxt.suspend();
-            return ret;
-        }
-    }
-
-    auto await_resume() noexcept(noexcept(mAwaiter.await_resume())) -> decltype(auto) { 
-        mCtxt.resume();
-        return mAwaiter.await_resume();
-    }
-private:
-    Awaitable mAwaitable;
-    Awaiter   mAwaiter;
-    TraceContext &mCtxt;
-};
-
 #if !defined(ILIAS_CORO_TRACE)
 inline TracingSubscriber::~TracingSubscriber() {}
 inline auto TracingSubscriber::install() noexcept -> bool { ILIAS_WARN("Runtime", "Tracing feature is not enabled"); return false; }
@@ -0,0 +1,291 @@
+/**
+ * @file sharded.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The thread-per-core sharded runtime, each shard owns a thread, a platform context and its own listener
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/exception.hpp>
+#include <ilias/runtime/token.hpp>
+#include <ilias/sync/mpsc.hpp>
+#include <ilias/task/spawn.hpp>
+#include <ilias/task/task.hpp>
+#include <ilias/net/sockopt.hpp>
+#include <ilias/net/tcp.hpp>
+#include <ilias/io/context.hpp>
+#include <concepts> // std::invocable
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <unordered_map> // std::unordered_map
+#include <thread> // std::thread
+#include <vector> // std::vector
+#include <limits> // std::numeric_limits
+#include <mutex> // std::mutex
+
+ILIAS_NS_BEGIN
+
+class ShardedRuntime;
+
+/**
+ * @brief The options of the ShardedRuntime
+ *
+ */
+struct ShardedOptions {
+    size_t shards      = 0;     //< The number of shards, 0 on std::thread::hardware_concurrency()
+    bool   pinCpu      = true;  //< Pin the shard i to the cpu (i % cpus)
+    bool   cpuSteering = false; //< Attach a SO_ATTACH_REUSEPORT_CBPF program, so the connection is accepted by the shard on the cpu which received it (linux only)
+};
+
+/**
+ * @brief The shard of the ShardedRuntime, it is share-nothing with other shards
+ *
+ */
+class ILIAS_API Shard {
+public:
+    Shard(const Shard &) = delete;
+
+    /**
+     * @brief Get the index of the shard in the runtime
+     *
+     * @return size_t
+     */
+    auto index() const noexcept -> size_t { return mIndex; }
+
+    /**
+     * @brief Get the number of the shards in the runtime
+     *
+     * @return size_t
+     */
+    auto count() const noexcept -> size_t;
+
+    /**
+     * @brief Get the cpu the shard pinned to
+     *
+     * @return int (-1 on not pinned)
+     */
+    auto cpu() const noexcept -> int { return mCpu; }
+
+    /**
+     * @brief Get the io context of the shard, only valid while the shard is running
+     * @note Use `this_coro::switchTo(shard.executor())` to move a task onto the shard
+     *
+     * @return IoContext &
+     */
+    auto executor() const noexcept -> IoContext & {
+        ILIAS_ASSERT(mContext, "The shard is not running");
+        return *mContext;
+    }
+
+    /**
+     * @brief Bind the listener of this shard, all shards bind the same endpoint with SO_REUSEPORT,
+     *  so the kernel will balance the connections between them. Must be called in the shard thread.
+     *  A shard can bind multiple endpoints, but only one listener per endpoint.
+     *
+     * @param endpoint The endpoint to bind to (all shards should use the same one)
+     * @param backlog
+     * @return IoTask<TcpListener> SystemError::AddressInUse if this shard already bound the endpoint
+     */
+    auto bind(IPEndpoint endpoint, int backlog = SOMAXCONN) -> IoTask<TcpListener>;
+private:
+    Shard(ShardedRuntime &runtime, size_t index, int cpu) : mRuntime(runtime), mIndex(index), mCpu(cpu) {}
+
+    ShardedRuntime       &mRuntime;
+    size_t                mIndex;
+    int                   mCpu;
+    IoContext            *mContext = nullptr; // The context of the shard thread, protected by the runtime mutex
+    StopHandle            mHandle;            // The handle of the user task, only touched in the shard thread
+    std::thread           mThread;
+    runtime::ExceptionPtr mException;         // The exception that the user task throwed
+friend class ShardedRuntime;
+};
+
+/**
+ * @brief The thread-per-core runtime, an share-nothing alternative to the work-stealing one.
+ *
+ * It starts N threads, each one has its own PlatformContext (optionally pinned to a cpu) and runs the user factory coroutine.
+ * The shards usually bind their own listener by `Shard::bind` (SO_REUSEPORT), and talk to each other by the ShardMailbox.
+ *
+ * @code
+ *  auto runtime = ShardedRuntime { {.shards = 4} };
+ *  runtime.run([](Shard &shard) -> Task<void> {
+ *      auto listener = (co_await shard.bind("0.0.0.0:8080")).value();
+ *      while (auto res = co_await listener.accept()) {
+ *          spawn(handle(std::move(res->first)));
+ *      }
+ *  });
+ * @endcode
+ */
+class ILIAS_API ShardedRuntime {
+public:
+    using Factory = std::function<Task<void> (Shard &)>;
+
+    explicit ShardedRuntime(ShardedOptions options = {});
+    ShardedRuntime(const ShardedRuntime &) = delete;
+
+    /**
+     * @brief Destroy the runtime, it will stop & `BLOCKING!!!` join all the shards
+     *
+     */
+    ~ShardedRuntime();
+
+    /**
+     * @brief Start the factory coroutine on every shard, it doesn't block
+     *
+     * @param factory The factory, called in the shard thread
+     */
+    auto start(Factory factory) -> void;
+
+    /**
+     * @brief Blocking wait for all the shards done, rethrow the first exception of the shards (if any)
+     *
+     */
+    auto blockingJoin() -> void;
+
+    /**
+     * @brief Start the factory on every shard and blocking wait for all of them done
+     *
+     * @param factory
+     */
+    auto run(Factory factory) -> void {
+        start(std::move(factory));
+        blockingJoin();
+    }
+
+    /**
+     * @brief Send the stop request to all the shards (thread safe), if called before `start`, the shards stop at once
+     *
+     */
+    auto stop() -> void;
+
+    /**
+     * @brief Get the number of the shards
+     *
+     * @return size_t
+     */
+    auto size() const noexcept -> size_t { return mShards.size(); }
+
+    /**
+     * @brief Get the shard by index
+     *
+     * @param idx
+     * @return Shard &
+     */
+    auto shard(size_t idx) noexcept -> Shard & { return *mShards[idx]; }
+    auto operator [](size_t idx) noexcept -> Shard & { return *mShards[idx]; }
+private:
+    auto main(Shard &shard) -> void;
+    auto bindReusePort(Shard &shard, IPEndpoint endpoint, int backlog) -> IoResult<Socket>;
+
+    ShardedOptions                       mOptions;
+    Factory                              mFactory;
+    std::vector<std::unique_ptr<Shard> > mShards;
+    std::unordered_map<IPEndpoint, std::vector<size_t> > mBindOrder; // The shard index in the order they joined the reuseport group, by the bound endpoint
+    std::mutex                           mMutex;     // Protect the mBindOrder, mStopRequested and the shards' state
+    bool                                 mStopRequested = false;
+friend class Shard;
+};
+
+/**
+ * @brief The mailboxes for the cross-shard messaging, one mpsc channel per shard.
+ *
+ * @tparam T The message type
+ *
+ * @code
+ *  auto mailbox = ShardMailbox<std::string> {runtime.size()};
+ *  // In shard 0
+ *  co_await mailbox.send(1, "Hello");
+ *  // In shard 1
+ *  auto msg = co_await mailbox.recv(1);
+ * @endcode
+ */
+template <sync::Sendable T>
+class ShardMailbox {
+public:
+    explicit ShardMailbox(size_t shards, size_t capacity = std::numeric_limits<size_t>::max()) {
+        mSenders.reserve(shards);
+        mReceivers.reserve(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            auto [sender, receiver] = mpsc::channel<T>(capacity);
+            mSenders.emplace_back(std::move(sender));
+            mReceivers.emplace_back(std::move(receiver));
+        }
+    }
+
+    ShardMailbox(const ShardMailbox &) = delete;
+
+    /**
+     * @brief Send the message to the shard, can be called from any shard (or thread)
+     *
+     * @param shard The target shard index
+     * @param item
+     * @return Result<void, T> (awaitable), Err(item) on the mailbox closed
+     */
+    [[nodiscard]]
+    auto send(size_t shard, T item) const {
+        return mSenders[shard].send(std::move(item));
+    }
+
+    /**
+     * @brief Try send the message to the shard without waiting
+     *
+     * @param shard The target shard index
+     * @param item
+     * @return Result<void, mpsc::TrySendErrorResult<T> >
+     */
+    [[nodiscard]]
+    auto trySend(size_t shard, T item) const {
+        return mSenders[shard].trySend(std::move(item));
+    }
+
+    /**
+     * @brief Receive the message of the shard, only the shard itself should call it
+     *
+     * @param shard The self shard index
+     * @return Option<T> (awaitable), nullopt on closed
+     */
+    [[nodiscard]]
+    auto recv(size_t shard) {
+        return mReceivers[shard].recv();
+    }
+
+    /**
+     * @brief Get a copy of the sender to the shard
+     *
+     * @param shard
+     * @return mpsc::Sender<T>
+     */
+    auto sender(size_t shard) const -> mpsc::Sender<T> {
+        return mSenders[shard];
+    }
+
+    /**
+     * @brief Close all the mailboxes, the pending recv will get nullopt after the messages drained
+     *
+     */
+    auto close() -> void {
+        for (auto &sender : mSenders) {
+            sender.close();
+        }
+    }
+private:
+    std::vector<mpsc::Sender<T> >   mSenders;
+    std::vector<mpsc::Receiver<T> > mReceivers;
+};
+
+// MARK: Impl
+inline auto Shard::count() const noexcept -> size_t {
+    return mRuntime.size();
+}
+
+inline auto Shard::bind(IPEndpoint endpoint, int backlog) -> IoTask<TcpListener> {
+    ILIAS_CO_TRY(auto sockfd, mRuntime.bindReusePort(*this, endpoint, backlog));
+    ILIAS_CO_TRY(auto handle, IoHandle<Socket>::make(std::move(sockfd), IoDescriptor::Socket));
+    co_return TcpListener {std::move(handle)};
+}
+
+ILIAS_NS_END
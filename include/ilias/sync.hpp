@@ -11,9 +11,15 @@
 #pragma once
 
 #include <ilias/sync/semaphore.hpp>
+#include <ilias/sync/admission.hpp>
 #include <ilias/sync/oneshot.hpp>
 #include <ilias/sync/latch.hpp>
 #include <ilias/sync/mutex.hpp>
+#include <ilias/sync/rwlock.hpp>
 #include <ilias/sync/event.hpp>
+#include <ilias/sync/notify.hpp>
 #include <ilias/sync/mpsc.hpp>
-#include <ilias/sync/mpmc.hpp>
\ No newline at end of file
+#include <ilias/sync/mpmc.hpp>
+#include <ilias/sync/spsc.hpp>
+#include <ilias/sync/broadcast.hpp>
+#include <ilias/sync/watch.hpp>
\ No newline at end of file
@@ -0,0 +1,129 @@
+/**
+ * @file admission.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The admission controller, limit the cost in flight and shed the load when the queue keeps standing (CoDel style).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/futex.hpp> // FutexMutex
+#include <ilias/sync/semaphore.hpp>
+#include <ilias/task/task.hpp>
+#include <optional> // std::optional
+#include <cstdint> // uint64_t
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono
+#include <mutex> // std::lock_guard
+
+ILIAS_NS_BEGIN
+
+/**
+ * @brief The admission controller, the requests are admitted by the cost (bytes, connections, ...) in order
+ *
+ * It tracks the min queue wait over each interval, a burst drains within the interval, so the min wait drops to near zero,
+ * but a standing queue keeps the min wait above the target, then it is overloaded and the new requests only wait up to the target,
+ * the rest are shed (fail fast), so the server degrades gracefully instead of building an unbounded queue.
+ *
+ */
+class AdmissionController {
+public:
+    struct Config {
+        ptrdiff_t                capacity;                                      // The total cost allowed in flight
+        std::chrono::nanoseconds target   = std::chrono::milliseconds(5);     // The acceptable queue wait
+        std::chrono::nanoseconds interval = std::chrono::milliseconds(100);   // The window to observe the min queue wait, also the max wait when not overloaded
+    };
+
+    explicit AdmissionController(Config config) :
+        mSem(config.capacity, sync::Fairness::Fifo), mConfig(config), mIntervalEnd(std::chrono::steady_clock::now() + config.interval)
+    {
+        ILIAS_ASSERT(config.target > std::chrono::nanoseconds::zero() && config.interval >= config.target);
+    }
+    explicit AdmissionController(ptrdiff_t capacity) : AdmissionController(Config {.capacity = capacity}) {}
+    AdmissionController(const AdmissionController &) = delete;
+
+    /**
+     * @brief Admit the request by the cost, wait in order, fail fast when overloaded
+     *
+     * @param cost The cost of the request, must be greater than 0
+     * @return Task<Option<SemaphorePermit> >, nullopt on the request is shed, the permit gives the cost back when destroyed
+     */
+    [[nodiscard]]
+    auto admit(ptrdiff_t cost = 1) -> Task<Option<SemaphorePermit> > {
+        auto start = std::chrono::steady_clock::now();
+        auto limit = isOverloaded() ? mConfig.target : mConfig.interval;
+        auto permit = co_await mSem.acquireFor(limit, cost);
+        onWaited(std::chrono::steady_clock::now() - start);
+        if (!permit) {
+            mShed.fetch_add(1, std::memory_order_relaxed);
+        }
+        co_return permit;
+    }
+
+    /**
+     * @brief Try admit the request without waiting
+     *
+     * @param cost The cost of the request, must be greater than 0
+     * @return std::optional<SemaphorePermit>
+     */
+    [[nodiscard]]
+    auto tryAdmit(ptrdiff_t cost = 1) -> std::optional<SemaphorePermit> {
+        return mSem.tryAcquire(cost);
+    }
+
+    /**
+     * @brief Check the queue was standing in the last interval, the new requests only wait up to the target
+     *
+     * @return true
+     * @return false
+     */
+    auto isOverloaded() const noexcept -> bool {
+        return mOverloaded.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the num of the requests shed so far
+     *
+     * @return uint64_t
+     */
+    auto shedCount() const noexcept -> uint64_t {
+        return mShed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the cost can be admitted now
+     *
+     * @return ptrdiff_t
+     */
+    auto available() const noexcept -> ptrdiff_t {
+        return mSem.available();
+    }
+private:
+    // Keep the min wait of the current interval, decide the state at the end of it
+    auto onWaited(std::chrono::nanoseconds wait) -> void {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard locker {mMutex};
+        if (wait < mMinWait) {
+            mMinWait = wait;
+        }
+        if (now < mIntervalEnd) {
+            return;
+        }
+        mOverloaded.store(mMinWait > mConfig.target, std::memory_order_relaxed);
+        mMinWait = std::chrono::nanoseconds::max();
+        mIntervalEnd = now + mConfig.interval;
+    }
+
+    Semaphore                             mSem;
+    Config                                mConfig;
+    sync::FutexMutex                      mMutex; // Protect the interval state below
+    std::chrono::steady_clock::time_point mIntervalEnd;
+    std::chrono::nanoseconds              mMinWait = std::chrono::nanoseconds::max();
+    std::atomic<bool>                     mOverloaded {false};
+    std::atomic<uint64_t>                 mShed {0};
+};
+
+ILIAS_NS_END
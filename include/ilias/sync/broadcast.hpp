@@ -0,0 +1,387 @@
+/**
+ * @file broadcast.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The broadcast channel, every receiver gets a copy of every item.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/queue.hpp> // WaitQueue
+#include <ilias/sync/detail/futex.hpp> // FutexMutex
+#include <ilias/sync/detail/channel_core.hpp> // Sendable, ChanRef
+#include <ilias/task/task.hpp>
+#include <ilias/result.hpp> // Result
+#include <shared_mutex> // std::shared_mutex
+#include <concepts> // std::copy_constructible
+#include <optional> // std::optional
+#include <memory> // std::shared_ptr
+#include <atomic> // std::atomic
+#include <mutex> // std::lock_guard
+#include <bit> // std::bit_ceil
+
+ILIAS_NS_BEGIN
+
+namespace broadcast {
+
+// The item must be copyable, each receiver gets its own copy
+template <typename T>
+concept Broadcastable = sync::Sendable<T> && std::copy_constructible<T>;
+
+enum class RecvErrorKind {
+    Empty,  // No new item (only on the try / blocking version)
+    Closed, // All the senders are closed, and the items are drained
+    Lagged  // The receiver is too slow, the items are overwritten, the cursor is moved to the oldest one
+};
+
+struct RecvError {
+    RecvErrorKind reason;
+    uint64_t      lagged = 0; // The num of the items skipped (only on Lagged)
+};
+
+// Implementation
+namespace detail {
+
+// All receivers read the one shared ring by their own cursors, the senders never wait for them.
+// The pos of each slot is the position of the item it holds, so the reader knows whether it is ready, or overwritten.
+template <Broadcastable T>
+class Channel final {
+public:
+    Channel(size_t c) : mask(std::bit_ceil(c) - 1), slots(new Slot[mask + 1]) {
+        for (uint64_t i = 0; i <= mask; ++i) {
+            slots[i].pos = i - (mask + 1); // As it written in the previous lap, so it is not ready for the cursor i
+        }
+    }
+    Channel(Channel &&) = delete;
+
+    auto size() const noexcept -> uint64_t {
+        return mask + 1;
+    }
+
+    // For sender
+    auto send(T &value) -> Result<size_t, T> {
+        size_t count = 0;
+        {
+            std::lock_guard locker {mutex};
+            count = receiverCount.load(std::memory_order_acquire);
+            if (count == 0) {
+                return Err(std::move(value));
+            }
+            auto pos = tail.load(std::memory_order_relaxed);
+            auto &slot = slots[pos & mask];
+            {
+                std::lock_guard slotLocker {slot.mutex};
+                slot.value.emplace(std::move(value));
+                slot.pos = pos;
+            }
+            tail.store(pos + 1, std::memory_order_release);
+        }
+        receivers.wakeupAll(); // One wakeup for all the parked receivers
+        return count;
+    }
+
+    auto onSenderClose() -> void {
+        {
+            std::lock_guard locker {mutex}; // Order with the last send
+            senderClosed.store(true, std::memory_order_release);
+        }
+        receivers.wakeupAll();
+    }
+
+    // For receiver
+    auto readable(uint64_t cursor) const noexcept -> bool {
+        return tail.load(std::memory_order_acquire) != cursor || senderClosed.load(std::memory_order_acquire);
+    }
+
+    auto tryRecv(uint64_t &cursor) -> Result<T, RecvError> {
+        auto &slot = slots[cursor & mask];
+        std::shared_lock locker {slot.mutex};
+        auto diff = int64_t(slot.pos - cursor);
+        if (diff == 0) { // Ready
+            cursor += 1;
+            return *slot.value;
+        }
+        if (diff > 0) { // Overwritten, move to the oldest one still in the ring
+            locker.unlock();
+            auto oldest = tail.load(std::memory_order_acquire) - size();
+            auto lagged = oldest - cursor;
+            cursor = oldest;
+            return Err(RecvError {.reason = RecvErrorKind::Lagged, .lagged = lagged});
+        }
+        locker.unlock();
+        if (senderClosed.load(std::memory_order_acquire) && tail.load(std::memory_order_acquire) == cursor) {
+            return Err(RecvError {.reason = RecvErrorKind::Closed});
+        }
+        return Err(RecvError {.reason = RecvErrorKind::Empty});
+    }
+
+    struct Slot {
+        std::shared_mutex mutex; // Readers copy the value under the shared lock
+        uint64_t          pos;
+        std::optional<T>  value;
+    };
+
+    const uint64_t           mask;
+    std::unique_ptr<Slot[]>  slots;
+    std::atomic<uint64_t>    tail {0}; // The next pos to write
+    std::atomic<size_t>      senderCount {0};
+    std::atomic<size_t>      receiverCount {0};
+    std::atomic<bool>        senderClosed {false};
+    sync::FutexMutex         mutex; // Serialize the senders
+    sync::WaitQueue          receivers;
+};
+
+template <Broadcastable T>
+class ReceiveAwaiter final : public sync::WaitAwaiter<ReceiveAwaiter<T> > {
+public:
+    ReceiveAwaiter(Channel<T> *c, uint64_t &cursor) : sync::WaitAwaiter<ReceiveAwaiter<T> >(c->receivers), mChan(c), mCursor(cursor) {}
+    ReceiveAwaiter(ReceiveAwaiter &&) = default;
+
+    // Fast path, don't touch the queue if the item is already there
+    auto await_ready() const noexcept -> bool {
+        return mChan->readable(mCursor);
+    }
+
+    // The copy is done here in the receiver's own context, not in the sender's wakeupAll
+    auto await_resume() -> Result<T, RecvError> {
+        return mChan->tryRecv(mCursor);
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->readable(mCursor);
+    }
+private:
+    Channel<T> *mChan;
+    uint64_t   &mCursor;
+};
+
+template <Broadcastable T>
+using ChanSender   = sync::ChanRef<Channel<T>, true>;
+
+template <Broadcastable T>
+using ChanReceiver = sync::ChanRef<Channel<T>, false>;
+
+} // namespace detail
+
+template <Broadcastable T>
+class Sender;
+
+template <Broadcastable T>
+class Receiver;
+
+template <Broadcastable T>
+struct Pair {
+    Sender<T>   sender;
+    Receiver<T> receiver;
+};
+
+/**
+ * @brief The broadcast receiver class, it has its own cursor in the channel. (copy & move able)
+ * @note The copy starts at the same cursor as the original one
+ *
+ * @tparam T The item type to be received.
+ */
+template <Broadcastable T>
+class Receiver final {
+public:
+    Receiver() = default;
+    Receiver(const Receiver &) = default;
+    Receiver(Receiver &&) = default;
+    ~Receiver() = default;
+
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if all the senders are closed. (the items may not be drained yet)
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return !mChan || mChan->senderClosed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the capacity of the channel. (rounded up to the power of two)
+     *
+     * @return size_t
+     */
+    auto capacity() const noexcept -> size_t {
+        return mChan ? mChan->size() : 0;
+    }
+
+    /**
+     * @brief Get the num of the items not received yet (may larger than the capacity on lagged)
+     *
+     * @return uint64_t
+     */
+    auto pending() const noexcept -> uint64_t {
+        return mChan ? mChan->tail.load(std::memory_order_acquire) - mCursor : 0;
+    }
+
+    /**
+     * @brief Receive a copy of the next item.
+     *
+     * @return Result<T, RecvError>, Err(Lagged) on the receiver is too slow (the next recv will get the oldest one), Err(Closed) on the channel is closed
+     */
+    [[nodiscard]]
+    auto recv() noexcept {
+        return detail::ReceiveAwaiter<T> {mChan.get(), mCursor};
+    }
+
+    /**
+     * @brief Try receive a copy of the next item.
+     *
+     * @return Result<T, RecvError>, Err(Empty) on no new item
+     */
+    [[nodiscard]]
+    auto tryRecv() -> Result<T, RecvError> {
+        return mChan->tryRecv(mCursor);
+    }
+
+    /**
+     * @brief Blocking receive a copy of the next item.
+     * @note It will ```BLOCK``` the thread, so it is not recommended to use it in the async context, use it in sync code
+     *
+     * @return Result<T, RecvError>
+     */
+    [[nodiscard]]
+    auto blockingRecv() -> Result<T, RecvError> {
+        mChan->receivers.blockingWait([&]() { return mChan->readable(mCursor); });
+        return mChan->tryRecv(mCursor);
+    }
+
+    /**
+     * @brief Make a new receiver starts at the newest position (only receive the items sent after it)
+     *
+     * @return Receiver<T>
+     */
+    auto resubscribe() const -> Receiver<T> {
+        return Receiver<T> {mChan.shared()};
+    }
+
+    auto operator =(const Receiver &other) -> Receiver & = default;
+    auto operator =(Receiver &&other) -> Receiver & = default;
+
+    // Check the receiver is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    explicit Receiver(std::shared_ptr<detail::Channel<T> > chan) : mChan(chan) {
+        std::lock_guard locker {mChan->mutex}; // Don't miss the item being sent
+        mCursor = mChan->tail.load(std::memory_order_relaxed);
+    }
+
+    detail::ChanReceiver<T> mChan;
+    uint64_t                mCursor = 0; // The pos of the next item to receive
+template <Broadcastable U>
+friend auto channel(size_t capacity) -> Pair<U>;
+template <Broadcastable U>
+friend class Sender;
+};
+
+/**
+ * @brief The broadcast sender class, it never waits for the receivers. (copy & move able)
+ *
+ * @tparam T The item type to be sent.
+ */
+template <Broadcastable T>
+class Sender final {
+public:
+    Sender() = default;
+    Sender(const Sender &) = default;
+    Sender(Sender &&) = default;
+    ~Sender() = default;
+
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if all the receivers are closed. we can't send any more data
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return receiverCount() == 0;
+    }
+
+    /**
+     * @brief Get the capacity of the channel. (rounded up to the power of two)
+     *
+     * @return size_t
+     */
+    auto capacity() const noexcept -> size_t {
+        return mChan ? mChan->size() : 0;
+    }
+
+    /**
+     * @brief Get the num of the receivers
+     *
+     * @return size_t
+     */
+    auto receiverCount() const noexcept -> size_t {
+        return mChan ? mChan->receiverCount.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Send the item to all the receivers, it never waits, the oldest item is overwritten on full.
+     *
+     * @param item
+     * @return Result<size_t, T> The num of the receivers, Err(item) on no receiver
+     */
+    auto send(T item) const -> Result<size_t, T> {
+        return mChan->send(item);
+    }
+
+    /**
+     * @brief Make a new receiver, only receive the items sent after it
+     *
+     * @return Receiver<T>
+     */
+    auto subscribe() const -> Receiver<T> {
+        return Receiver<T> {mChan.shared()};
+    }
+
+    auto operator =(const Sender &other) -> Sender & = default;
+    auto operator =(Sender &&other) -> Sender & = default;
+
+    // Check the sender is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    explicit Sender(std::shared_ptr<detail::Channel<T> > chan) : mChan(std::move(chan)) {}
+
+    detail::ChanSender<T> mChan;
+template <Broadcastable U>
+friend auto channel(size_t capacity) -> Pair<U>;
+};
+
+/**
+ * @brief Make a broadcast channel, for multi producer and multi consumer, each item is received by all the receivers.
+ *
+ * @tparam T The item type to be sent and received. (must be copyable)
+ * @param capacity The num of the items kept for the slow receivers. (abort on 0), rounded up to the power of two
+ * @return Pair<T>
+ */
+template <Broadcastable T>
+inline auto channel(size_t capacity) -> Pair<T> {
+    ILIAS_ASSERT(capacity > 0, "The capacity of the channel must be greater than 0.");
+    auto ptr = std::make_shared<detail::Channel<T> >(capacity);
+    return {
+        .sender = Sender<T> {ptr},
+        .receiver = Receiver<T> {ptr}
+    };
+}
+
+} // namespace broadcast
+
+ILIAS_NS_END
@@ -12,7 +12,9 @@
 
 #include <ilias/sync/detail/futex.hpp> // FutexMutex
 #include <memory>
+#include <vector> // std::vector
 #include <atomic>
+#include <span> // std::span
 
 ILIAS_NS_BEGIN
 
@@ -65,9 +67,91 @@ public:
     }
 };
 
+/**
+ * @brief The strong ref of one side, for the channel that each handle is a shared_ptr (so new handles can be made from any side)
+ * @note The channel should have the atomic senderCount / receiverCount, the onSenderClose() / onReceiverClose() (optional)
+ * is called when the last handle of the side is dropped
+ *
+ * @tparam C The channel type
+ * @tparam IsSender
+ */
+template <typename C, bool IsSender>
+class ChanRef {
+public:
+    ChanRef() = default;
+    ChanRef(std::shared_ptr<C> chan) : mChan(std::move(chan)) { acquire(); }
+    ChanRef(const ChanRef &other) : mChan(other.mChan) { acquire(); }
+    ChanRef(ChanRef &&other) = default;
+    ~ChanRef() { reset(); }
+
+    auto reset() -> void {
+        if (!mChan) {
+            return;
+        }
+        auto chan = std::move(mChan);
+        if (counter(*chan).fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if constexpr (IsSender && requires { chan->onSenderClose(); }) {
+            chan->onSenderClose();
+        }
+        else if constexpr (!IsSender && requires { chan->onReceiverClose(); }) {
+            chan->onReceiverClose();
+        }
+    }
+
+    auto get() const noexcept -> C * { return mChan.get(); }
+    auto shared() const noexcept -> const std::shared_ptr<C> & { return mChan; }
+    auto operator ->() const noexcept -> C * { return mChan.get(); }
+    auto operator *() const noexcept -> C & { return *mChan; }
+    explicit operator bool() const noexcept { return bool(mChan); }
+
+    auto operator =(ChanRef other) -> ChanRef & {
+        reset();
+        mChan = std::move(other.mChan);
+        return *this;
+    }
+private:
+    static auto counter(C &chan) -> auto & {
+        if constexpr (IsSender) {
+            return chan.senderCount;
+        }
+        else {
+            return chan.receiverCount;
+        }
+    }
+
+    auto acquire() -> void {
+        if (mChan) {
+            counter(*mChan).fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::shared_ptr<C> mChan;
+};
+
 template <typename T>
 concept Sendable = std::is_move_constructible_v<T> && (!std::is_reference_v<T>);
 
+// The output of the batch receive, the vector is appended, the span is filled from the begin
+template <typename T>
+struct BatchOutput {
+    BatchOutput(std::vector<T> &vec) : vec(&vec) {}
+    BatchOutput(std::span<T> span) : span(span) {}
+
+    auto put(size_t idx, T &&item) -> void {
+        if (vec) {
+            vec->emplace_back(std::move(item));
+        }
+        else {
+            span[idx] = std::move(item);
+        }
+    }
+
+    std::vector<T> *vec = nullptr;
+    std::span<T>    span;
+};
+
 } // namespace sync
 
 ILIAS_NS_END
\ No newline at end of file
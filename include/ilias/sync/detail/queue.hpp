@@ -7,7 +7,7 @@
 #include <ilias/runtime/coro.hpp>
 #include <ilias/log.hpp>
 #include <concepts> // std::convertible_to
-#include <atomic> // std::atomic_ref
+#include <atomic> // std::atomic_ref, std::atomic
 
 ILIAS_NS_BEGIN
 
@@ -15,6 +15,12 @@ namespace sync {
 
 class WaitQueue;
 
+// How the released ownership (lock, permit) goes to the waiters
+enum class Fairness {
+    Barging, // Released first, the head waiter races with the newcomers for it, higher throughput under the thread contention
+    Fifo,    // Handed to the head waiter directly (see WaitQueue::handoffOne), the newcomers can't barge in, bounded latency
+};
+
 // The common base class for all waiters, (support blocking & async)
 class WaiterBase : public intrusive::ListNode<WaiterBase> {
 public:
@@ -82,18 +88,55 @@ public:
     auto unlock() -> void;
 
     // Wakeup one, no-op on empty queue, it will skip the waiter (if not satisfied the predicate) in the queue
+    // It doesn't take the lock when no one is parked, so the lock-free state changed before it is never missed (see mParked)
     // Precondition: the queue must not be ```locked```
     auto wakeupOne() -> void;
     auto wakeupAll() -> void;
+
+    // Wakeup the waiters from the head in order, stop at the first one not satisfied, so the later ones never jump ahead of it
+    // Precondition: the queue must not be ```locked```
+    auto wakeupInOrder() -> void;
+
+    // Wakeup the head waiter if it's predicate is satisfied, O(1), unlike wakeupOne, it never walks the rest of the queue
+    // Only for the waiters waiting for the same ownership, if the head can't get it, someone else got it and will wake the head on release
+    // Precondition: the queue must not be ```locked```
+    auto wakeupHead() -> void;
+
+    // Direct handoff, resume the head waiter without checking its predicate, O(1) and FIFO
+    // The caller transfers the ownership (lock, permit) to it, return false on no waiter in the list (the caller keeps the ownership)
+    // The waiter going to park at the same time is not seen, so the caller should release the ownership and wakeupOne() on false
+    // Precondition: the queue must not be ```locked```, all the waiters must be waiting for the same ownership
+    auto handoffOne() -> bool;
+
+    // Direct handoff to all the waiters in the list now, without checking their predicates, the ones parked later are not woken
+    // Precondition: the queue must not be ```locked```
+    auto handoffAll() -> void;
     auto operator =(const WaitQueue &) = delete;
 
+    // Check the waiter is the head one, (or the queue is empty while it is parking), for the fair predicate
+    // Precondition: only call it in the predicate (the lock is held)
+    auto isHead(const WaiterBase &waiter) const noexcept -> bool {
+        return mWaiters.empty() || &mWaiters.front() == &waiter;
+    }
+
+    // Check has any waiter, only a hint for the fast path of the fair waiters
+    auto hasWaiters() const noexcept -> bool {
+        return mParked.load(std::memory_order_relaxed) != 0;
+    }
+
     // Blocking wait, it will block the current thread until the predicate is satisfied
     // Precondition: the queue must not be ```locked```
     template <std::predicate Fn>
     auto blockingWait(Fn pred) -> void;
 private:
+    // Called with the lock held, before the last predicate check, return true if the waiter parked
+    auto park(WaiterBase &waiter) -> bool;
+    // Check has any waiter parked, false means the waiter (if any) will see the state changed before this call
+    auto hasParked() const noexcept -> bool;
+
     intrusive::List<WaiterBase>  mWaiters;
     FutexMutex                   mMutex; // Protect the mWaiters, it is smaller
+    std::atomic<size_t>          mParked {0}; // The num of the waiters in (or going to) the list, paired with seq_cst fences (Dekker)
 friend class AwaiterBase;
 };
 
@@ -126,6 +169,22 @@ private:
 };
 
 // Implementation
+inline auto WaitQueue::park(WaiterBase &waiter) -> bool {
+    mParked.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Announce before checking, the waker checks in the reverse order
+    if (waiter.mOnWakeup(waiter)) {
+        mParked.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    mWaiters.push_back(waiter);
+    return true;
+}
+
+inline auto WaitQueue::hasParked() const noexcept -> bool {
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Order the state changed by the caller before loading the count
+    return mParked.load(std::memory_order_relaxed) != 0;
+}
+
 template <std::predicate Fn>
 auto WaitQueue::blockingWait(Fn pred) -> void {
     struct Waiter : public WaiterBase {
@@ -140,10 +199,9 @@ auto WaitQueue::blockingWait(Fn pred) -> void {
             }
             {
                 std::lock_guard locker {mQueue};
-                if (mFn()) { // Atomic check and suspend
+                if (!mQueue.park(*this)) { // Atomic check and suspend
                     return;
                 }
-                mQueue.mWaiters.push_back(*this);
             }
 
             std::atomic_ref {mBlocking}.wait(true); // Wait it to be set to false
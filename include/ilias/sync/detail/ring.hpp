@@ -0,0 +1,299 @@
+// INTERNAL!!
+#pragma once
+
+#include <ilias/defines.hpp>
+#include <type_traits> // std::is_nothrow_move_constructible_v
+#include <optional> // std::optional
+#include <cstddef> // std::byte
+#include <cstdint> // intptr_t
+#include <utility> // std::move
+#include <memory> // std::unique_ptr
+#include <atomic> // std::atomic
+#include <thread> // std::this_thread::yield
+#include <algorithm> // std::min
+#include <bit> // std::bit_ceil
+#include <new> // std::launder
+
+ILIAS_NS_BEGIN
+
+namespace sync {
+
+// The cache line size, used to keep the hot atomics of producer & consumer apart
+inline constexpr size_t CacheLineSize = 64;
+
+/**
+ * @brief The bounded lock-free mpmc ring (Dmitry Vyukov's sequence number cells)
+ *
+ * Each cell has a sequence number, the producer owns the cell when seq == pos, the consumer owns it when seq == pos + 1.
+ * The ring size is rounded up to the power of two, the capacity limit (if not power of two) should be done by the caller.
+ *
+ * @tparam T
+ */
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity) : mMask(std::bit_ceil(capacity) - 1), mCells(new Cell[mMask + 1]) {
+        for (size_t i = 0; i <= mMask; ++i) {
+            mCells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpmcRing(const MpmcRing &) = delete;
+    ~MpmcRing() {
+        while (tryPop()) {} // Destroy the remaining items
+    }
+
+    /**
+     * @brief Try push the item, the item is moved only on success
+     *
+     * @param item
+     * @return false on full (or the cell of the last lap is still being consumed)
+     */
+    auto tryPush(T &item) noexcept(std::is_nothrow_move_constructible_v<T>) -> bool {
+        auto pos = mTail.value.load(std::memory_order_relaxed);
+        while (true) {
+            auto &cell = mCells[pos & mMask];
+            auto seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0) { // The cell is free, try to claim it
+                if (mTail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (cell.storage) T(std::move(item));
+                    cell.seq.store(pos + 1, std::memory_order_release); // Publish to the consumer
+                    return true;
+                }
+            }
+            else if (diff < 0) { // Full
+                return false;
+            }
+            else { // Another producer claimed it, reload
+                pos = mTail.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Push the item, spin if the ring is full, only use it when the caller already reserved the space (by the capacity limit)
+     * @note It is lock-free except on a preempted claimer: if the consumer of the last lap claimed the cell and got preempted
+     * before moving the item out, the push yields the thread until it finishes, the caller can't make progress without it.
+     *
+     * @param item
+     */
+    auto push(T item) noexcept(std::is_nothrow_move_constructible_v<T>) -> void {
+        while (!tryPush(item)) { // A consumer took the cell, but doesn't finish moving it out yet, short wait
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Try pop the item
+     *
+     * @return std::optional<T>, nullopt on empty (or the producer doesn't finish writing the head cell yet)
+     */
+    auto tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) -> std::optional<T> {
+        auto pos = mHead.value.load(std::memory_order_relaxed);
+        while (true) {
+            auto &cell = mCells[pos & mMask];
+            auto seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos + 1);
+            if (diff == 0) { // The cell is ready, try to claim it
+                if (mHead.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    auto ptr = std::launder(reinterpret_cast<T *>(cell.storage));
+                    auto value = std::optional<T> {std::move(*ptr)};
+                    ptr->~T();
+                    cell.seq.store(pos + mMask + 1, std::memory_order_release); // Give it back to the producer of the next lap
+                    return value;
+                }
+            }
+            else if (diff < 0) { // Empty
+                return std::nullopt;
+            }
+            else { // Another consumer claimed it, reload
+                pos = mHead.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Check the ring is empty, only a hint under the concurrent access
+     *
+     */
+    auto empty() const noexcept -> bool {
+        return mHead.value.load(std::memory_order_relaxed) == mTail.value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the size of the ring (the power of two)
+     *
+     */
+    auto size() const noexcept -> size_t {
+        return mMask + 1;
+    }
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+    struct alignas(CacheLineSize) Pos {
+        std::atomic<size_t> value {0};
+    };
+
+    const size_t            mMask;
+    std::unique_ptr<Cell[]> mCells;
+    Pos                     mHead; // The next pos to pop, touched by the consumers
+    Pos                     mTail; // The next pos to push, touched by the producers
+};
+
+/**
+ * @brief The bounded wait-free spsc ring, the head and tail are on separate cache lines
+ *
+ * Each side caches the index of the other side, so it only touches the remote cache line when the cached one says full (or empty).
+ * The producer side methods must be called by one thread at a time, so as the consumer side.
+ *
+ * @tparam T
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) : mMask(std::bit_ceil(capacity) - 1), mSlots(new Slot[mMask + 1]) {}
+    SpscRing(const SpscRing &) = delete;
+    ~SpscRing() {
+        while (tryPop()) {} // Destroy the remaining items
+    }
+
+    // MARK: Producer
+    /**
+     * @brief Try push the item, the item is moved only on success
+     *
+     * @param item
+     * @return false on full
+     */
+    auto tryPush(T &item) noexcept(std::is_nothrow_move_constructible_v<T>) -> bool {
+        if (writable() == 0) {
+            return false;
+        }
+        auto tail = mProducer.tail.load(std::memory_order_relaxed);
+        new (mSlots[tail & mMask].data) T(std::move(item));
+        mProducer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push as many items as possible from the begin, publish them at once
+     *
+     * @param begin The iterator of the items, they will be moved from
+     * @param n The num of the items
+     * @return size_t The num of the items pushed
+     */
+    template <typename It>
+    auto pushMany(It begin, size_t n) noexcept(std::is_nothrow_move_constructible_v<T>) -> size_t {
+        n = std::min(n, writable());
+        auto tail = mProducer.tail.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i, ++begin) {
+            new (mSlots[(tail + i) & mMask].data) T(std::move(*begin));
+        }
+        if (n != 0) {
+            mProducer.tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get the num of the free slots, refresh the cached head only when the cached one says full
+     *
+     */
+    auto writable() noexcept -> size_t {
+        auto tail = mProducer.tail.load(std::memory_order_relaxed);
+        auto free = size() - (tail - mProducer.cachedHead);
+        if (free == 0) {
+            mProducer.cachedHead = mConsumer.head.load(std::memory_order_acquire);
+            free = size() - (tail - mProducer.cachedHead);
+        }
+        return free;
+    }
+
+    // MARK: Consumer
+    /**
+     * @brief Try pop the item
+     *
+     * @return std::optional<T>, nullopt on empty
+     */
+    auto tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) -> std::optional<T> {
+        if (readable() == 0) {
+            return std::nullopt;
+        }
+        auto head = mConsumer.head.load(std::memory_order_relaxed);
+        auto ptr = slot(head);
+        auto value = std::optional<T> {std::move(*ptr)};
+        ptr->~T();
+        mConsumer.head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @brief Pop at most max items, give the slots back at once
+     *
+     * @param max
+     * @param fn The callback called with T && for each item
+     * @return size_t The num of the items popped
+     */
+    template <typename Fn>
+    auto popMany(size_t max, Fn fn) -> size_t {
+        auto n = std::min(max, readable());
+        auto head = mConsumer.head.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            auto ptr = slot(head + i);
+            fn(std::move(*ptr));
+            ptr->~T();
+        }
+        if (n != 0) {
+            mConsumer.head.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get the num of the items ready, refresh the cached tail only when the cached one says empty
+     *
+     */
+    auto readable() noexcept -> size_t {
+        auto head = mConsumer.head.load(std::memory_order_relaxed);
+        auto ready = mConsumer.cachedTail - head;
+        if (ready == 0) {
+            mConsumer.cachedTail = mProducer.tail.load(std::memory_order_acquire);
+            ready = mConsumer.cachedTail - head;
+        }
+        return ready;
+    }
+
+    /**
+     * @brief Get the size of the ring (the power of two)
+     *
+     */
+    auto size() const noexcept -> size_t {
+        return mMask + 1;
+    }
+private:
+    auto slot(size_t pos) noexcept -> T * {
+        return std::launder(reinterpret_cast<T *>(mSlots[pos & mMask].data));
+    }
+
+    struct Slot {
+        alignas(T) std::byte data[sizeof(T)];
+    };
+    struct alignas(CacheLineSize) Producer {
+        std::atomic<size_t> tail {0};
+        size_t              cachedHead = 0; // The last seen head of the consumer
+    };
+    struct alignas(CacheLineSize) Consumer {
+        std::atomic<size_t> head {0};
+        size_t              cachedTail = 0; // The last seen tail of the producer
+    };
+
+    const size_t            mMask;
+    std::unique_ptr<Slot[]> mSlots;
+    Consumer                mConsumer;
+    Producer                mProducer;
+};
+
+} // namespace sync
+
+ILIAS_NS_END
@@ -13,16 +13,18 @@
 #include <ilias/sync/detail/channel_core.hpp> // ChannelBase
 #include <ilias/sync/detail/futex.hpp> // FutexMutex
 #include <ilias/sync/detail/queue.hpp> // WaitQueue
+#include <ilias/sync/detail/ring.hpp> // MpmcRing
 #include <ilias/task/task.hpp>
 #include <ilias/result.hpp> // Result
+#include <algorithm> // std::min
 #include <concepts>
+#include <ranges> // std::ranges::forward_range
 #include <memory> // std::unique_ptr, std::shared_ptr
 #include <limits>
 #include <atomic> // std::atomic
+#include <optional> // std::optional
 #include <deque>
 
-// TODO: Duplicated code with mpmc.hpp, maye we can refactor it?
-
 ILIAS_NS_BEGIN
 
 namespace mpmc {
@@ -37,94 +39,216 @@ class Permit;
 // Implementation
 namespace detail {
 
+// The channel with the capacity larger than it, (including the default unbounded one) use the locked deque instead of the preallocated ring
+inline constexpr size_t RingCapacityLimit = size_t(1) << 16;
+
+// The fast path is lock-free except on a preempted claimer (see MpmcRing::push), the mutex is only used for the unbounded storage,
+// the WaitQueue only for the park / unpark.
+// The capacity is counted by the credits, one for each free slot, the sender (or the permit) takes one before pushing, the receiver gives it back after popping.
 template <Sendable T>
 class Channel final : public sync::ChannelBase {
 public:
-    Channel(size_t c) : capacity(c) {}
+    Channel(size_t c) : capacity(c), credits(c) {
+        if (c <= RingCapacityLimit) {
+            ring.emplace(c);
+        }
+    }
     Channel(Channel &&) = delete;
     ~Channel() { // Check state
-        ILIAS_ASSERT(receiverClosed);
-        ILIAS_ASSERT(senderClosed);
+        ILIAS_ASSERT(receiverClosed.load());
+        ILIAS_ASSERT(senderClosed.load());
+    }
+
+    // Take a credit (a free slot), false on full
+    auto acquireCredit() noexcept -> bool {
+        auto cur = credits.load(std::memory_order_relaxed);
+        while (cur != 0) {
+            if (credits.compare_exchange_weak(cur, cur - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Take at most n credits at once, return the num taken
+    auto acquireCredits(size_t n) noexcept -> size_t {
+        auto cur = credits.load(std::memory_order_relaxed);
+        while (cur != 0) {
+            auto take = std::min(cur, n);
+            if (credits.compare_exchange_weak(cur, cur - take, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return take;
+            }
+        }
+        return 0;
+    }
+
+    auto releaseCredit(size_t n = 1) noexcept -> void {
+        credits.fetch_add(n, std::memory_order_release);
+    }
+
+    // Push the item, the credit must be taken
+    auto push(T item) -> void {
+        if (ring) {
+            ring->push(std::move(item));
+            return;
+        }
+        std::lock_guard locker {mutex};
+        queue.emplace_back(std::move(item));
+    }
+
+    // Push n items from the iterator, the credits must be taken
+    template <typename It>
+    auto pushMany(It &it, size_t n) -> void {
+        if (ring) {
+            for (size_t i = 0; i < n; ++i, ++it) {
+                ring->push(std::ranges::iter_move(it));
+            }
+            return;
+        }
+        std::lock_guard locker {mutex};
+        for (size_t i = 0; i < n; ++i, ++it) {
+            queue.emplace_back(std::ranges::iter_move(it));
+        }
+    }
+
+    // Pop at most max items and give back the credits at once
+    auto popMany(sync::BatchOutput<T> &out, size_t max) -> size_t {
+        size_t got = 0;
+        if (ring) {
+            for (; got < max; ++got) {
+                auto value = ring->tryPop();
+                if (!value) {
+                    break;
+                }
+                out.put(got, std::move(*value));
+            }
+        }
+        else {
+            std::lock_guard locker {mutex};
+            for (; got < max && !queue.empty(); ++got) {
+                out.put(got, std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        if (got != 0) {
+            releaseCredit(got);
+        }
+        return got;
+    }
+
+    // Pop the item and give back the credit
+    auto pop() -> std::optional<T> {
+        std::optional<T> value;
+        if (ring) {
+            value = ring->tryPop();
+        }
+        else {
+            std::lock_guard locker {mutex};
+            if (!queue.empty()) {
+                value.emplace(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        if (value) {
+            releaseCredit();
+        }
+        return value;
     }
 
     // For sender
     auto trySendInternal(Result<void, T> &item) -> bool {
-        std::lock_guard locker {mutex};
-        if (receiverClosed) { // We can't send any more data.
+        if (receiverClosed.load(std::memory_order_acquire)) { // We can't send any more data.
             return true;
         }
-        if (queue.size() + reserved >= capacity) {
+        if (!acquireCredit()) {
             return false; // No space, continue to wait.
         }
-        queue.emplace_back(std::move(item.error()));
+        push(std::move(item.error()));
         item = {};
         return true; // Sended
     }
 
     // Returns true when wait is finished. outGot is true only when a slot was reserved.
     auto tryReserveInternal(bool &outGot) -> bool {
-        std::lock_guard locker {mutex};
-        if (receiverClosed) { // We can't send any more data.
+        if (receiverClosed.load(std::memory_order_acquire)) { // We can't send any more data.
             outGot = false;
             return true;
         }
-        if (queue.size() + reserved >= capacity) {
+        if (!acquireCredit()) {
             return false; // No space, continue to wait.
         }
-        ++reserved;
         outGot = true;
         return true; // Reserved
     }
 
     auto onSenderClose() -> void {
-        bool notify = false;
-        {
-            std::lock_guard locker {mutex};
-            senderClosed = true; // All sender is closed.
-            notify = !receiverClosed; // If the receiver is closed, not need to notify.
-        }
-        if (notify) { // Wake all receivers so they can observe the closed state.
+        senderClosed.store(true, std::memory_order_release); // All sender is closed.
+        if (!receiverClosed.load(std::memory_order_acquire)) { // Wake all receivers so they can observe the closed state.
             receivers.wakeupAll();
         }
     }
 
     // For receiver
     auto tryRecvInternal(std::optional<T> &value) -> bool {
-        std::lock_guard locker {mutex};
-        if (!queue.empty()) {
-            value.emplace(std::move(queue.front()));
-            queue.pop_front();
+        value = pop();
+        if (value) {
             return true; // Have data
         }
-        if (senderClosed) {
+        if (senderClosed.load(std::memory_order_acquire)) {
+            value = pop(); // Pick the item sent just before the close
             return true; // No sender, so we can't receive any more.
         }
         return false;
     }
 
-    auto onReceiverClose() -> void {
-        bool notify = false;
-        {
-            std::lock_guard locker {mutex};
-            receiverClosed = true; // All receiver is closed.
-            notify = !senderClosed; // If the sender is all closed, not need to notify.
+    auto tryRecvManyInternal(sync::BatchOutput<T> &out, size_t max, size_t &got) -> bool {
+        got = popMany(out, max);
+        if (got != 0) {
+            return true; // Have data
+        }
+        if (senderClosed.load(std::memory_order_acquire)) {
+            got = popMany(out, max); // Pick the items sent just before the close
+            return true;
         }
-        if (notify) {
+        return false;
+    }
+
+    // Returns true when there is space or the receiver is closed
+    auto writableInternal() -> bool {
+        return receiverClosed.load(std::memory_order_acquire) || credits.load(std::memory_order_acquire) != 0;
+    }
+
+    // Wakeup the other side after the batch, one call for the whole batch
+    static auto wakeupMany(sync::WaitQueue &queue, size_t n) -> void {
+        if (n == 1) {
+            queue.wakeupOne();
+        }
+        else if (n > 1) { // Multiple items / slots, let all the waiters can fit in go
+            queue.wakeupAll();
+        }
+    }
+
+    auto onReceiverClose() -> void {
+        receiverClosed.store(true, std::memory_order_release); // All receiver is closed.
+        if (!senderClosed.load(std::memory_order_acquire)) {
             senders.wakeupAll(); // Multi producer, use wakeupAll
         }
     }
 
     // States
     const size_t          capacity       {0};     // The capacity of the channel. read only.
-    bool                  senderClosed   {false}; // If all the sender is closed.
-    bool                  receiverClosed {false}; // If all the receiver is closed.
+    std::atomic<bool>     senderClosed   {false}; // If all the sender is closed.
+    std::atomic<bool>     receiverClosed {false}; // If all the receiver is closed.
+    std::atomic<size_t>   credits        {0};     // The num of the free slots (capacity - queued - reserved)
+
+    // Storage, the ring on bounded, the deque protected by the mutex on unbounded
+    std::optional<sync::MpmcRing<T> > ring;
+    sync::FutexMutex      mutex;
+    std::deque<T>         queue;
 
     // Sync, all queue's wakeup must call without lock the mutex, we may lock the mutex in the onWakeup. it will deadlock.
-    sync::FutexMutex      mutex; // Protect the queue, reserved, and closed flags.
     sync::WaitQueue       senders;
     sync::WaitQueue       receivers;
-    std::deque<T>         queue; // For storing the items.
-    size_t                reserved {0}; // The num of reserved items
 };
 
 // Used for Permit<T>
@@ -132,15 +256,8 @@ class ChanPermitDeleter final {
 public:
     template <Sendable T>
     auto operator ()(Channel<T> *chan) { // Give the reserved item slot back to the channel.
-        bool notify = false;
-        {
-            std::lock_guard locker {chan->mutex};
-            chan->reserved -= 1; // Release the reserved item
-            notify = chan->queue.size() + chan->reserved < chan->capacity; // If we have space, we should wakeup the an sender.
-        }
-        if (notify) {
-            chan->senders.wakeupOne();
-        }
+        chan->releaseCredit();
+        chan->senders.wakeupOne();
     }
 };
 
@@ -186,6 +303,44 @@ private:
     std::optional<T> mValue; // The value we got
 };
 
+template <Sendable T>
+class ReceiveManyAwaiter final : public sync::WaitAwaiter<ReceiveManyAwaiter<T> > {
+public:
+    ReceiveManyAwaiter(Channel<T> *c, sync::BatchOutput<T> out, size_t max) :
+        sync::WaitAwaiter<ReceiveManyAwaiter<T> >(c->receivers), mChan(c), mOut(out), mMax(max) {}
+    ReceiveManyAwaiter(ReceiveManyAwaiter &&) = default;
+
+    auto await_resume() -> size_t {
+        Channel<T>::wakeupMany(mChan->senders, mGot);
+        return mGot;
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->tryRecvManyInternal(mOut, mMax, mGot);
+    }
+private:
+    Channel<T>          *mChan;
+    sync::BatchOutput<T> mOut;
+    size_t               mMax;
+    size_t               mGot = 0;
+};
+
+// Wait for any space (or closed), used by the batch send
+template <Sendable T>
+class WritableAwaiter final : public sync::WaitAwaiter<WritableAwaiter<T> > {
+public:
+    WritableAwaiter(Channel<T> *c) : sync::WaitAwaiter<WritableAwaiter<T> >(c->senders), mChan(c) {}
+    WritableAwaiter(WritableAwaiter &&) = default;
+
+    auto await_resume() -> void {}
+
+    auto onWakeup() -> bool {
+        return mChan->writableInternal();
+    }
+private:
+    Channel<T> *mChan;
+};
+
 template <Sendable T>
 class ReserveAwaiter final : public sync::WaitAwaiter<ReserveAwaiter<T> > {
 public:
@@ -273,13 +428,9 @@ public:
     auto send(T item) -> void {
         auto ptr = std::exchange(mChan, nullptr);
         ILIAS_ASSERT(ptr, "Can't send on a invalid permit");
-        {
-            std::lock_guard locker {ptr->mutex};
-            ptr->queue.emplace_back(std::move(item));
-            ptr->reserved -= 1;
-        }
+        ptr->push(std::move(item)); // The credit is moved to the item, the receiver gives it back
         ptr->receivers.wakeupOne();
-        ptr.release(); // Don't decrease the reserved count, we already do it
+        ptr.release(); // Don't give back the credit
     }
 
     // Give up the permit
@@ -337,8 +488,7 @@ public:
         if (!mChan) {
             return true;
         }
-        std::lock_guard locker {mChan->mutex};
-        return mChan->receiverClosed;
+        return mChan->receiverClosed.load(std::memory_order_acquire);
     }
 
     /**
@@ -362,6 +512,36 @@ public:
         return detail::SendAwaiter<T> {mChan.get(), std::move(item)};
     }
 
+    /**
+     * @brief Send all the items in the range, take the credits for as many items as the space allows at once, and wake the receivers once for each batch.
+     * @note Cancellation: The items not sent are left in the range.
+     *
+     * @param items The items will be moved from, it must be alive until the task is done
+     * @return Task<size_t> The num of the items sent, less than the range size only when the receiver is closed
+     */
+    template <std::ranges::forward_range R> requires(std::constructible_from<T, std::ranges::range_rvalue_reference_t<R> >)
+    [[nodiscard]]
+    auto sendMany(R &&items) const -> Task<size_t> {
+        auto chan = mChan.get();
+        auto it = std::ranges::begin(items);
+        auto end = std::ranges::end(items);
+        size_t sent = 0;
+        while (it != end) {
+            if (chan->receiverClosed.load(std::memory_order_acquire)) {
+                break;
+            }
+            auto n = chan->acquireCredits(std::ranges::distance(it, end));
+            if (n != 0) {
+                chan->pushMany(it, n);
+                sent += n;
+                detail::Channel<T>::wakeupMany(chan->receivers, n);
+                continue;
+            }
+            co_await detail::WritableAwaiter<T> {chan}; // Full, wait for the receivers
+        }
+        co_return sent;
+    }
+
     /**
      * @brief Try send a item to the channel.
      * 
@@ -370,17 +550,14 @@ public:
      */
     [[nodiscard]]
     auto trySend(T item) const -> Result<void, TrySendErrorResult<T> > {
-        std::unique_lock locker {mChan->mutex};
-
         // Do check
-        if (mChan->receiverClosed) {
+        if (mChan->receiverClosed.load(std::memory_order_acquire)) {
             return Err(TrySendErrorResult<T> { .item = std::move(item), .reason = TrySendError::Closed });
         }
-        if (mChan->queue.size() + mChan->reserved >= mChan->capacity) {
+        if (!mChan->acquireCredit()) {
             return Err(TrySendErrorResult<T> { .item = std::move(item), .reason = TrySendError::Full });
         }
-        mChan->queue.emplace_back(std::move(item));
-        locker.unlock();
+        mChan->push(std::move(item));
 
         // Success to send, wakeup one receiver.
         mChan->receivers.wakeupOne();
@@ -421,17 +598,13 @@ public:
      */
     [[nodiscard]]
     auto tryReserve() const -> Result<Permit<T>, TrySendError> {
-        std::unique_lock locker {mChan->mutex};
-
         // Do check
-        if (mChan->receiverClosed) {
+        if (mChan->receiverClosed.load(std::memory_order_acquire)) {
             return Err(TrySendError::Closed);
         }
-        if (mChan->queue.size() + mChan->reserved >= mChan->capacity) {
+        if (!mChan->acquireCredit()) {
             return Err(TrySendError::Full);
         }
-
-        mChan->reserved++;
         return Permit<T> {mChan.get()};
     }
 
@@ -515,8 +688,7 @@ public:
         if (!mChan) {
             return true;
         }
-        std::lock_guard locker {mChan->mutex};
-        return mChan->senderClosed;
+        return mChan->senderClosed.load(std::memory_order_acquire);
     }
 
     /**
@@ -539,6 +711,31 @@ public:
         return detail::ReceiveAwaiter<T> {mChan.get()};
     }
 
+    /**
+     * @brief Receive at least one item, at most max items from the channel, give back the space and wake the senders once for the batch.
+     *
+     * @param out The items will be appended to it
+     * @param max The max num of the items
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::vector<T> &out, size_t max) noexcept {
+        ILIAS_ASSERT(max > 0, "The max of recvMany must be greater than 0.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, max};
+    }
+
+    /**
+     * @brief Receive at least one item, at most out.size() items from the channel
+     *
+     * @param out The items will be assigned from the begin
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::span<T> out) noexcept {
+        ILIAS_ASSERT(!out.empty(), "The span of recvMany must not be empty.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, out.size()};
+    }
+
     /**
      * @brief Try receive a item from the channel.
      * 
@@ -546,20 +743,20 @@ public:
      */
     [[nodiscard]]
     auto tryRecv() noexcept(std::is_nothrow_move_constructible_v<T>) -> Result<T, TryRecvError> {
-        std::unique_lock locker {mChan->mutex};
-        if (mChan->queue.empty() && mChan->senderClosed) {
-            return Err(TryRecvError::Closed);
+        auto value = mChan->pop();
+        if (!value && mChan->senderClosed.load(std::memory_order_acquire)) {
+            value = mChan->pop(); // Pick the item sent just before the close
+            if (!value) {
+                return Err(TryRecvError::Closed);
+            }
         }
-        if (mChan->queue.empty()) {
+        if (!value) {
             return Err(TryRecvError::Empty);
         }
-        auto value = std::move(mChan->queue.front());
-        mChan->queue.pop_front();
-        locker.unlock();
 
         // Success to recv, wakeup one sender.
         mChan->senders.wakeupOne();
-        return std::move(value);
+        return std::move(*value);
     }
 
     /**
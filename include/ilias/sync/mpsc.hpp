@@ -15,7 +15,10 @@
 #include <ilias/sync/detail/queue.hpp> // WaitQueue
 #include <ilias/task/task.hpp>
 #include <ilias/result.hpp> // Result
+#include <algorithm> // std::min
 #include <concepts>
+#include <optional> // std::optional
+#include <ranges> // std::ranges::input_range
 #include <memory> // std::unique_ptr, std::shared_ptr
 #include <limits>
 #include <atomic> // std::atomic
@@ -74,6 +77,26 @@ public:
         return true; // Reserved
     }
 
+    // Move as many items as the space allows under one lock, nullopt on the receiver closed
+    template <typename It, typename End>
+    auto trySendManyInternal(It &it, End end) -> std::optional<size_t> {
+        std::lock_guard locker {mutex};
+        if (receiverClosed) {
+            return std::nullopt;
+        }
+        size_t n = 0;
+        for (; it != end && queue.size() + reserved < capacity; ++it, ++n) {
+            queue.emplace_back(std::ranges::iter_move(it));
+        }
+        return n;
+    }
+
+    // Returns true when there is space or the receiver is closed
+    auto writableInternal() -> bool {
+        std::lock_guard locker {mutex};
+        return receiverClosed || queue.size() + reserved < capacity;
+    }
+
     auto onSenderClose() -> void {
         bool notify = false;
         {
@@ -100,6 +123,27 @@ public:
         return false;
     }
 
+    // Move at most max items under one lock, got is the num of the items moved
+    auto tryRecvManyInternal(sync::BatchOutput<T> &out, size_t max, size_t &got) -> bool {
+        std::lock_guard locker {mutex};
+        got = std::min(max, queue.size());
+        for (size_t i = 0; i < got; ++i) {
+            out.put(i, std::move(queue.front()));
+            queue.pop_front();
+        }
+        return got != 0 || senderClosed;
+    }
+
+    // Wakeup the senders after the batch receive, one call for the whole batch
+    auto onRecvMany(size_t got) -> void {
+        if (got == 1) {
+            senders.wakeupOne();
+        }
+        else if (got > 1) { // Multiple slots are freed, let all the senders can fit in go
+            senders.wakeupAll();
+        }
+    }
+
     auto onReceiverClose() -> void {
         bool notify = false;
         {
@@ -185,6 +229,44 @@ private:
     std::optional<T> mValue; // The value we got
 };
 
+template <Sendable T>
+class ReceiveManyAwaiter final : public sync::WaitAwaiter<ReceiveManyAwaiter<T> > {
+public:
+    ReceiveManyAwaiter(Channel<T> *c, sync::BatchOutput<T> out, size_t max) :
+        sync::WaitAwaiter<ReceiveManyAwaiter<T> >(c->receiver), mChan(c), mOut(out), mMax(max) {}
+    ReceiveManyAwaiter(ReceiveManyAwaiter &&) = default;
+
+    auto await_resume() -> size_t {
+        mChan->onRecvMany(mGot);
+        return mGot;
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->tryRecvManyInternal(mOut, mMax, mGot);
+    }
+private:
+    Channel<T>          *mChan;
+    sync::BatchOutput<T> mOut;
+    size_t               mMax;
+    size_t               mGot = 0;
+};
+
+// Wait for any space (or closed), used by the batch send
+template <Sendable T>
+class WritableAwaiter final : public sync::WaitAwaiter<WritableAwaiter<T> > {
+public:
+    WritableAwaiter(Channel<T> *c) : sync::WaitAwaiter<WritableAwaiter<T> >(c->senders), mChan(c) {}
+    WritableAwaiter(WritableAwaiter &&) = default;
+
+    auto await_resume() -> void {}
+
+    auto onWakeup() -> bool {
+        return mChan->writableInternal();
+    }
+private:
+    Channel<T> *mChan;
+};
+
 template <Sendable T>
 class ReserveAwaiter final : public sync::WaitAwaiter<ReserveAwaiter<T> > {
 public:
@@ -356,6 +438,35 @@ public:
         return detail::SendAwaiter<T> {mChan.get(), std::move(item)};
     }
 
+    /**
+     * @brief Send all the items in the range, move as many items as the space allows under one lock, and wake the receiver once for each batch.
+     * @note Cancellation: The items not sent are left in the range.
+     *
+     * @param items The items will be moved from, it must be alive until the task is done
+     * @return Task<size_t> The num of the items sent, less than the range size only when the receiver is closed
+     */
+    template <std::ranges::input_range R> requires(std::constructible_from<T, std::ranges::range_rvalue_reference_t<R> >)
+    [[nodiscard]]
+    auto sendMany(R &&items) const -> Task<size_t> {
+        auto chan = mChan.get();
+        auto it = std::ranges::begin(items);
+        auto end = std::ranges::end(items);
+        size_t sent = 0;
+        while (it != end) {
+            auto n = chan->trySendManyInternal(it, end);
+            if (!n) { // Closed
+                break;
+            }
+            if (*n != 0) {
+                sent += *n;
+                chan->receiver.wakeupOne();
+                continue;
+            }
+            co_await detail::WritableAwaiter<T> {chan}; // Full, wait for the receiver
+        }
+        co_return sent;
+    }
+
     /**
      * @brief Try send a item to the channel.
      * 
@@ -524,6 +635,31 @@ public:
         return detail::ReceiveAwaiter<T> {mChan.get()};
     }
 
+    /**
+     * @brief Receive at least one item, at most max items from the channel, under one lock and one wakeup of the senders.
+     *
+     * @param out The items will be appended to it
+     * @param max The max num of the items
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::vector<T> &out, size_t max) noexcept {
+        ILIAS_ASSERT(max > 0, "The max of recvMany must be greater than 0.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, max};
+    }
+
+    /**
+     * @brief Receive at least one item, at most out.size() items from the channel
+     *
+     * @param out The items will be assigned from the begin
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::span<T> out) noexcept {
+        ILIAS_ASSERT(!out.empty(), "The span of recvMany must not be empty.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, out.size()};
+    }
+
     /**
      * @brief Try receive a item from the channel.
      * 
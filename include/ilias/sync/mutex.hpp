@@ -49,11 +49,12 @@ private:
  * @brief The locked guard, user can access the value by it
  * 
  * @tparam T 
+ * @tparam Guard The underlying lock guard (MutexGuard, RwReadGuard, ...)
  */
-template <typename T>
+template <typename T, typename Guard = MutexGuard>
 class [[nodiscard]] LockedGuard {
 public:
-    explicit LockedGuard(MutexGuard guard, T &value) : mGuard(std::move(guard)), mValue(&value) {};
+    explicit LockedGuard(Guard guard, T &value) : mGuard(std::move(guard)), mValue(&value) {};
     LockedGuard(const LockedGuard &) = delete;
     LockedGuard(LockedGuard &&) = default;
     ~LockedGuard() = default;
@@ -61,13 +62,14 @@ public:
     auto operator ->() const noexcept -> T * { return mValue; }
     auto operator *() const noexcept -> T & { return *mValue; }
     auto get() const noexcept -> T * { return mValue; }
+    auto guard() noexcept -> Guard & { return mGuard; }
 
     auto unlock() -> void { mGuard.unlock(); mValue = nullptr; }
     auto release() -> void { mGuard.release(); mValue = nullptr; }
     auto leak() -> void { mGuard.leak(); mValue = nullptr; }
 private:
-    MutexGuard mGuard;
-    T         *mValue = nullptr;
+    Guard mGuard;
+    T    *mValue = nullptr;
 };
 
 /**
@@ -81,6 +83,13 @@ public:
     Mutex() = default;
     ~Mutex() = default;
 
+    /**
+     * @brief Construct a new Mutex object with the fairness
+     * 
+     * @param fairness Fifo to hand the lock to the head waiter directly on unlock, the waiters get it in order (no barging)
+     */
+    explicit Mutex(sync::Fairness fairness) : mFairness(fairness) {}
+
     /**
      * @brief Check if the mutex is locked, internal use for assert
      * 
@@ -115,9 +124,12 @@ public:
      * 
      */
     auto unlockRaw() -> void {
-        auto locked = mLocked.exchange(false, std::memory_order_release);
-        ILIAS_ASSERT(locked, "Unlock a unlocked mutex");
-        mQueue.wakeupOne();
+        ILIAS_ASSERT(isLocked(), "Unlock a unlocked mutex");
+        if (mFairness == sync::Fairness::Fifo && mQueue.handoffOne()) { // Keep it locked, the head waiter owns it now
+            return;
+        }
+        mLocked.store(false, std::memory_order_release);
+        mQueue.wakeupHead(); // The waiters all want the same lock, only the head one need to be checked
     }
 
     /**
@@ -161,6 +173,7 @@ public:
 private:
     sync::WaitQueue   mQueue;
     std::atomic<bool> mLocked {false};
+    sync::Fairness    mFairness = sync::Fairness::Barging;
 friend class sync::MutexAwaiter;
 };
 
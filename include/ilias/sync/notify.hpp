@@ -0,0 +1,138 @@
+/**
+ * @file notify.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The notify class, signal the waiting tasks without a guarded state
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/queue.hpp> // WaitQueue, WaitAwaiter
+#include <ilias/runtime/coro.hpp>
+#include <ilias/log.hpp>
+#include <atomic> // std::atomic
+#include <cstdint> // uint64_t
+
+ILIAS_NS_BEGIN
+
+class Notify;
+
+namespace sync {
+
+class [[nodiscard]] NotifyAwaiter final : public WaitAwaiter<NotifyAwaiter> {
+public:
+    NotifyAwaiter(Notify &notify);
+
+    auto await_ready() -> bool;
+    auto await_resume() -> void;
+    auto onWakeup() -> bool;
+private:
+    Notify  &mNotify;
+    uint64_t mGeneration; // The generation of notifyWaiters() when it is created
+};
+
+} // namespace sync
+
+/**
+ * @brief The Coroutine Notify object, like the condition variable without the mutex, it is thread safe
+ *
+ * @note The notifyOne() keeps a permit if no one is waiting, so the next notified() returns at once, the wakeup is never lost.
+ *       The notifyWaiters() wakes all the awaiters created before the call (even not awaited yet), nothing is kept for the later ones.
+ *       So the condition checked before `co_await notify.notified()` never misses the broadcast. The waiters are woken in FIFO order.
+ */
+class Notify final {
+public:
+    Notify() = default;
+    Notify(const Notify &) = delete;
+    ~Notify() = default;
+
+    /**
+     * @brief Wake one waiting task, or keep the permit (at most one) for the next notified() if no one is waiting
+     *
+     */
+    auto notifyOne() -> void {
+        if (mPermit.exchange(true, std::memory_order_acq_rel)) { // Already pending, the one consumes it will see our writes too
+            return;
+        }
+        mQueue.wakeupHead(); // The head waiter consumes the permit, O(1)
+    }
+
+    /**
+     * @brief Wake all the tasks waiting now and the awaiters created before it, the permit is not kept
+     *
+     */
+    auto notifyWaiters() -> void {
+        mGeneration.fetch_add(1, std::memory_order_release); // The awaiter going to park sees it, handoffAll() orders it before the parked count check
+        mQueue.handoffAll();
+    }
+
+    /**
+     * @brief Wait for the notification, consume the permit if there is one
+     *
+     * @return sync::NotifyAwaiter
+     */
+    [[nodiscard]]
+    auto notified() noexcept -> sync::NotifyAwaiter { return {*this}; }
+
+    /**
+     * @brief Consume the permit if there is one
+     *
+     * @return true on the permit is consumed
+     */
+    [[nodiscard]]
+    auto tryNotified() noexcept -> bool {
+        return mPermit.load(std::memory_order_relaxed) && mPermit.exchange(false, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Block the current thread to wait for the notification
+     *
+     * @note It will ```BLOCK``` the current thread
+     */
+    auto blockingNotified() -> void {
+        auto generation = mGeneration.load(std::memory_order_acquire);
+        mQueue.blockingWait([&]() {
+            return mGeneration.load(std::memory_order_acquire) != generation || tryNotified();
+        });
+    }
+
+    /**
+     * @brief Wait for the notification
+     *
+     * @return co_await
+     */
+    auto operator co_await() noexcept -> sync::NotifyAwaiter {
+        return {*this};
+    }
+private:
+    sync::WaitQueue       mQueue;
+    std::atomic<bool>     mPermit {false};
+    std::atomic<uint64_t> mGeneration {0}; // Bumped by notifyWaiters()
+friend sync::NotifyAwaiter;
+};
+
+inline sync::NotifyAwaiter::NotifyAwaiter(Notify &notify) : 
+    WaitAwaiter(notify.mQueue), mNotify(notify), mGeneration(notify.mGeneration.load(std::memory_order_acquire)) 
+{
+
+}
+
+inline auto sync::NotifyAwaiter::await_ready() -> bool {
+    return onWakeup(); // Fast path, don't touch the queue
+}
+
+inline auto sync::NotifyAwaiter::await_resume() -> void {
+
+}
+
+inline auto sync::NotifyAwaiter::onWakeup() -> bool {
+    if (mNotify.mGeneration.load(std::memory_order_acquire) != mGeneration) { // Broadcast after we were created
+        return true;
+    }
+    return mNotify.tryNotified();
+}
+
+ILIAS_NS_END
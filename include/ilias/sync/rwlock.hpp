@@ -0,0 +1,783 @@
+/**
+ * @file rwlock.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The coroutine reader-writer lock, for the data read often but written rarely.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/queue.hpp> // WaitQueue, WaitAwaiter
+#include <ilias/sync/mutex.hpp> // LockedGuard
+#include <ilias/runtime/coro.hpp>
+#include <ilias/log.hpp>
+#include <optional> // std::optional
+#include <cstdint> // uint64_t
+#include <atomic> // std::atomic
+
+ILIAS_NS_BEGIN
+
+class RwMutex;
+class RwReadGuard;
+class RwWriteGuard;
+class RwUpgradableGuard;
+
+namespace sync {
+
+// The bits of the RwMutex state, all the transitions are done by the one atomic word
+struct RwState {
+    static constexpr uint64_t Writer      = 1;                  // The write lock is held
+    static constexpr uint64_t Upgradable  = 1 << 1;             // The upgradable read lock is held
+    static constexpr uint64_t WaitingOne  = 1 << 2;             // One writer (or upgrading reader) is waiting, it blocks the new readers
+    static constexpr uint64_t WaitingMask = 0xFFFFFFFC;
+    static constexpr uint64_t ReaderOne   = uint64_t(1) << 32;  // One read lock is held
+    static constexpr uint64_t ReaderMask  = ~uint64_t(0xFFFFFFFF);
+};
+
+class [[nodiscard]] ReadAwaiter final : public WaitAwaiter<ReadAwaiter> {
+public:
+    ReadAwaiter(RwMutex &m);
+
+    auto await_ready() -> bool;
+    auto await_resume() -> RwReadGuard;
+    auto onWakeup() -> bool; // Do try lock here, the lock is handed to us by the waker
+protected:
+    RwMutex &mMutex;
+};
+
+class [[nodiscard]] UpgradableAwaiter final : public WaitAwaiter<UpgradableAwaiter> {
+public:
+    UpgradableAwaiter(RwMutex &m);
+
+    auto await_ready() -> bool;
+    auto await_resume() -> RwUpgradableGuard;
+    auto onWakeup() -> bool;
+protected:
+    RwMutex &mMutex;
+};
+
+// The writer is counted as waiting from await_ready to the lock acquired (or the awaiter destroyed on cancel)
+class [[nodiscard]] WriteAwaiter final : public WaitAwaiter<WriteAwaiter> {
+public:
+    WriteAwaiter(RwMutex &m);
+    WriteAwaiter(WriteAwaiter &&);
+    ~WriteAwaiter();
+
+    auto await_ready() -> bool;
+    auto await_resume() -> RwWriteGuard;
+    auto onWakeup() -> bool;
+protected:
+    RwMutex &mMutex;
+    bool     mPending = false;
+};
+
+class [[nodiscard]] UpgradeAwaiter final : public WaitAwaiter<UpgradeAwaiter> {
+public:
+    UpgradeAwaiter(RwUpgradableGuard &guard);
+    UpgradeAwaiter(UpgradeAwaiter &&);
+    ~UpgradeAwaiter();
+
+    auto await_ready() -> bool;
+    auto await_resume() -> RwWriteGuard;
+    auto onWakeup() -> bool;
+protected:
+    RwUpgradableGuard &mGuard;
+    RwMutex           &mMutex;
+    bool               mPending = false;
+};
+
+} // namespace sync
+
+/**
+ * @brief The shared lock guard, unlock when the object is destroyed
+ *
+ */
+class [[nodiscard]] RwReadGuard {
+public:
+    explicit RwReadGuard(RwMutex &m);
+    RwReadGuard(const RwReadGuard &) = delete;
+    RwReadGuard(RwReadGuard &&);
+    ~RwReadGuard();
+
+    auto unlock() -> void;
+    auto release() -> void;
+    auto leak() -> void; // as same as release
+private:
+    RwMutex *mMutex = nullptr;
+};
+
+/**
+ * @brief The exclusive lock guard, unlock when the object is destroyed
+ *
+ */
+class [[nodiscard]] RwWriteGuard {
+public:
+    explicit RwWriteGuard(RwMutex &m);
+    RwWriteGuard(const RwWriteGuard &) = delete;
+    RwWriteGuard(RwWriteGuard &&);
+    ~RwWriteGuard();
+
+    /**
+     * @brief Atomically turn the write lock into a read lock, no other writer can get in between
+     *
+     * @return RwReadGuard
+     */
+    auto downgrade() -> RwReadGuard;
+
+    auto unlock() -> void;
+    auto release() -> void;
+    auto leak() -> void; // as same as release
+private:
+    RwMutex *mMutex = nullptr;
+};
+
+/**
+ * @brief The upgradable read lock guard, it shares with the readers, but only one upgradable guard at a time
+ *
+ */
+class [[nodiscard]] RwUpgradableGuard {
+public:
+    explicit RwUpgradableGuard(RwMutex &m);
+    RwUpgradableGuard(const RwUpgradableGuard &) = delete;
+    RwUpgradableGuard(RwUpgradableGuard &&);
+    ~RwUpgradableGuard();
+
+    /**
+     * @brief Wait for the other readers to leave, and turn into the write lock, the guard is released on success
+     * @note The new readers are blocked while upgrading. on cancel, the guard keeps the upgradable read lock
+     *
+     * @return RwWriteGuard (awaitable)
+     */
+    auto upgrade() noexcept -> sync::UpgradeAwaiter {
+        return sync::UpgradeAwaiter(*this);
+    }
+
+    /**
+     * @brief Try to upgrade to the write lock without waiting, the guard is released on success
+     *
+     * @return std::optional<RwWriteGuard>
+     */
+    auto tryUpgrade() -> std::optional<RwWriteGuard>;
+
+    auto unlock() -> void;
+    auto release() -> void;
+    auto leak() -> void; // as same as release
+private:
+    RwMutex *mMutex = nullptr;
+friend class sync::UpgradeAwaiter;
+};
+
+/**
+ * @brief The coroutine reader-writer lock, it is thread-safe
+ * @note The writer is preferred, the new readers are blocked once a writer is waiting, so the writer never starves.
+ *       The lock is handed to the waiter by the unlocker (in the waiter's predicate), so the woken one doesn't race for it again.
+ *
+ */
+class RwMutex {
+public:
+    RwMutex(const RwMutex &) = delete;
+    RwMutex(RwMutex &&) = delete;
+    RwMutex() = default;
+    ~RwMutex() = default;
+
+    /**
+     * @brief Check if the write lock is held, internal use for assert
+     *
+     * @return true
+     * @return false
+     */
+    auto isLocked() const noexcept -> bool { return mState.load(std::memory_order_relaxed) & sync::RwState::Writer; }
+
+    /**
+     * @brief Get the num of the read locks held, (not include the upgradable one), internal use for assert
+     *
+     * @return size_t
+     */
+    auto readerCount() const noexcept -> size_t { return mState.load(std::memory_order_relaxed) >> 32; }
+
+    /**
+     * @brief Try to take the read lock, fail on the lock is held by a writer, or a writer is waiting
+     *
+     * @return std::optional<RwReadGuard>
+     */
+    [[nodiscard]]
+    auto tryRead() noexcept -> std::optional<RwReadGuard>;
+
+    /**
+     * @brief Try to take the write lock
+     *
+     * @return std::optional<RwWriteGuard>
+     */
+    [[nodiscard]]
+    auto tryWrite() noexcept -> std::optional<RwWriteGuard>;
+
+    /**
+     * @brief Try to take the upgradable read lock
+     *
+     * @return std::optional<RwUpgradableGuard>
+     */
+    [[nodiscard]]
+    auto tryUpgradableRead() noexcept -> std::optional<RwUpgradableGuard>;
+
+    /**
+     * @brief Take the read lock, the fast path is one atomic add
+     *
+     * @return RwReadGuard (awaitable)
+     */
+    [[nodiscard]]
+    auto read() noexcept {
+        return sync::ReadAwaiter(*this);
+    }
+
+    /**
+     * @brief Take the write lock
+     *
+     * @return RwWriteGuard (awaitable)
+     */
+    [[nodiscard]]
+    auto write() noexcept {
+        return sync::WriteAwaiter(*this);
+    }
+
+    /**
+     * @brief Take the upgradable read lock, it can be upgraded to the write lock later without unlocking
+     *
+     * @return RwUpgradableGuard (awaitable)
+     */
+    [[nodiscard]]
+    auto upgradableRead() noexcept {
+        return sync::UpgradableAwaiter(*this);
+    }
+
+    /**
+     * @brief Blocking take the read lock
+     * @note It will ```BLOCK``` the current thread until the lock is taken
+     *
+     * @return RwReadGuard
+     */
+    [[nodiscard]]
+    auto blockingRead() -> RwReadGuard;
+
+    /**
+     * @brief Blocking take the write lock
+     * @note It will ```BLOCK``` the current thread until the lock is taken
+     *
+     * @return RwWriteGuard
+     */
+    [[nodiscard]]
+    auto blockingWrite() -> RwWriteGuard;
+
+    /**
+     * @brief Blocking take the upgradable read lock
+     * @note It will ```BLOCK``` the current thread until the lock is taken
+     *
+     * @return RwUpgradableGuard
+     */
+    [[nodiscard]]
+    auto blockingUpgradableRead() -> RwUpgradableGuard;
+
+    /**
+     * @brief Manually unlock the read lock, it will crash if no read lock is held
+     * @note It is not recommend to use this function directly, use RAII lock instead
+     *
+     */
+    auto unlockReadRaw() -> void {
+        auto prev = mState.fetch_sub(sync::RwState::ReaderOne, std::memory_order_release);
+        ILIAS_ASSERT(prev & sync::RwState::ReaderMask, "Unlock a unlocked rwmutex");
+        if ((prev & sync::RwState::ReaderMask) == sync::RwState::ReaderOne && (prev & sync::RwState::WaitingMask)) {
+            mWriters.wakeupOne(); // The last reader, hand off to the waiting writer
+        }
+    }
+
+    /**
+     * @brief Manually unlock the write lock, it will crash if the write lock is not held
+     * @note It is not recommend to use this function directly, use RAII lock instead
+     *
+     */
+    auto unlockWriteRaw() -> void {
+        auto prev = mState.fetch_sub(sync::RwState::Writer, std::memory_order_release);
+        ILIAS_ASSERT(prev & sync::RwState::Writer, "Unlock a unlocked rwmutex");
+        wakeupAfterRelease(prev);
+    }
+
+    /**
+     * @brief Manually unlock the upgradable read lock, it will crash if the upgradable read lock is not held
+     * @note It is not recommend to use this function directly, use RAII lock instead
+     *
+     */
+    auto unlockUpgradableRaw() -> void {
+        auto prev = mState.fetch_sub(sync::RwState::Upgradable, std::memory_order_release);
+        ILIAS_ASSERT(prev & sync::RwState::Upgradable, "Unlock a unlocked rwmutex");
+        wakeupAfterRelease(prev);
+    }
+private:
+    // The fast path of the reader, one atomic add, undo it if the writer is holding or waiting
+    auto tryReadFast() -> bool {
+        auto prev = mState.fetch_add(sync::RwState::ReaderOne, std::memory_order_acquire);
+        if (!(prev & (sync::RwState::Writer | sync::RwState::WaitingMask))) {
+            return true;
+        }
+        unlockReadRaw(); // The writer may see our transient count and park, so wake it up if we are the last one
+        return false;
+    }
+
+    // The slow path (in the predicate), never touch the count if it can't get the lock
+    auto tryReadInternal() -> bool {
+        auto cur = mState.load(std::memory_order_relaxed);
+        while (!(cur & (sync::RwState::Writer | sync::RwState::WaitingMask))) {
+            if (mState.compare_exchange_weak(cur, cur + sync::RwState::ReaderOne, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto tryUpgradableInternal() -> bool {
+        auto cur = mState.load(std::memory_order_relaxed);
+        while (!(cur & (sync::RwState::Writer | sync::RwState::Upgradable | sync::RwState::WaitingMask))) {
+            if (mState.compare_exchange_weak(cur, cur | sync::RwState::Upgradable, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The new writer may barge in before the waiting ones, as the Mutex does
+    auto tryWriteInternal() -> bool {
+        auto cur = mState.load(std::memory_order_relaxed);
+        while (!(cur & ~sync::RwState::WaitingMask)) {
+            if (mState.compare_exchange_weak(cur, cur | sync::RwState::Writer, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Take the write lock and remove self from the waiting count at once
+    auto tryWritePending() -> bool {
+        auto cur = mState.load(std::memory_order_relaxed);
+        while (!(cur & ~sync::RwState::WaitingMask)) {
+            auto next = cur - sync::RwState::WaitingOne + sync::RwState::Writer;
+            if (mState.compare_exchange_weak(cur, next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Turn the upgradable read lock into the write lock once the readers are gone
+    auto tryUpgradeInternal(bool pending) -> bool {
+        auto cur = mState.load(std::memory_order_relaxed);
+        ILIAS_ASSERT(cur & sync::RwState::Upgradable);
+        while (!(cur & sync::RwState::ReaderMask)) {
+            auto next = cur - sync::RwState::Upgradable + sync::RwState::Writer - (pending ? sync::RwState::WaitingOne : 0);
+            if (mState.compare_exchange_weak(cur, next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto addWaiting() -> void {
+        mState.fetch_add(sync::RwState::WaitingOne, std::memory_order_relaxed);
+    }
+
+    // The waiting writer gives up (cancelled), let the readers in if it was the last one
+    auto removeWaiting() -> void {
+        auto prev = mState.fetch_sub(sync::RwState::WaitingOne, std::memory_order_release);
+        if ((prev & sync::RwState::WaitingMask) == sync::RwState::WaitingOne) {
+            mReaders.wakeupAll();
+        }
+    }
+
+    // Writer preferred, only let the readers in if no writer is waiting
+    auto wakeupAfterRelease(uint64_t prev) -> void {
+        if (prev & sync::RwState::WaitingMask) {
+            mWriters.wakeupOne();
+        }
+        else {
+            mReaders.wakeupAll();
+        }
+    }
+
+    std::atomic<uint64_t> mState {0};
+    sync::WaitQueue       mReaders; // The readers and the upgradable readers
+    sync::WaitQueue       mWriters; // The writers and the upgrading reader
+friend class sync::ReadAwaiter;
+friend class sync::UpgradableAwaiter;
+friend class sync::WriteAwaiter;
+friend class sync::UpgradeAwaiter;
+friend class RwWriteGuard;
+friend class RwUpgradableGuard;
+};
+
+/**
+ * @brief The reader-writer lock protected value, the readers get the const reference
+ *
+ * @tparam T
+ */
+template <typename T>
+class RwLock {
+public:
+    using ReadGuard       = LockedGuard<const T, RwReadGuard>;
+    using WriteGuard      = LockedGuard<T, RwWriteGuard>;
+    using UpgradableGuard = LockedGuard<const T, RwUpgradableGuard>;
+
+    template <typename... Args> requires (std::constructible_from<T, Args...>)
+    RwLock(Args &&... args) : mValue(std::forward<Args>(args)...) {}
+    RwLock(const RwLock &) = delete;
+    ~RwLock() = default;
+
+    auto isLocked() const noexcept -> bool { return mMutex.isLocked(); }
+
+    [[nodiscard]]
+    auto tryRead() noexcept -> std::optional<ReadGuard> {
+        auto guard = mMutex.tryRead();
+        if (!guard) {
+            return std::nullopt;
+        }
+        return ReadGuard(std::move(*guard), mValue);
+    }
+
+    [[nodiscard]]
+    auto tryWrite() noexcept -> std::optional<WriteGuard> {
+        auto guard = mMutex.tryWrite();
+        if (!guard) {
+            return std::nullopt;
+        }
+        return WriteGuard(std::move(*guard), mValue);
+    }
+
+    /**
+     * @brief Lock the value for reading, return the lock guard, access the value by the guard
+     *
+     * @return ReadGuard
+     */
+    [[nodiscard]]
+    auto read() noexcept {
+        return wrap<ReadGuard>(mMutex.read());
+    }
+
+    /**
+     * @brief Lock the value for writing, return the lock guard, access the value by the guard
+     *
+     * @return WriteGuard
+     */
+    [[nodiscard]]
+    auto write() noexcept {
+        return wrap<WriteGuard>(mMutex.write());
+    }
+
+    /**
+     * @brief Lock the value for reading, it can be upgraded by upgrade() later
+     *
+     * @return UpgradableGuard
+     */
+    [[nodiscard]]
+    auto upgradableRead() noexcept {
+        return wrap<UpgradableGuard>(mMutex.upgradableRead());
+    }
+
+    /**
+     * @brief Upgrade the upgradable guard to the write guard, the upgradable guard is released on success
+     *
+     * @param guard The guard got from upgradableRead() of this lock
+     * @return WriteGuard
+     */
+    [[nodiscard]]
+    auto upgrade(UpgradableGuard &guard) noexcept {
+        struct Awaiter final {
+            auto await_ready() -> bool { return mAwaiter.await_ready(); }
+            auto await_suspend(runtime::CoroHandle caller) -> bool { return mAwaiter.await_suspend(caller); }
+            auto await_resume() -> WriteGuard {
+                auto write = WriteGuard(mAwaiter.await_resume(), mValue);
+                mGuard.release(); // The lock is moved into the write guard
+                return write;
+            }
+
+            sync::UpgradeAwaiter mAwaiter;
+            UpgradableGuard     &mGuard;
+            T                   &mValue;
+        };
+        return Awaiter {guard.guard().upgrade(), guard, mValue};
+    }
+
+    [[nodiscard]]
+    auto blockingRead() -> ReadGuard {
+        return ReadGuard(mMutex.blockingRead(), mValue);
+    }
+
+    [[nodiscard]]
+    auto blockingWrite() -> WriteGuard {
+        return WriteGuard(mMutex.blockingWrite(), mValue);
+    }
+private:
+    template <typename Guard, typename Awaiter>
+    auto wrap(Awaiter awaiter) noexcept {
+        struct Wrapper final {
+            auto await_ready() -> bool { return mAwaiter.await_ready(); }
+            auto await_suspend(runtime::CoroHandle caller) -> bool { return mAwaiter.await_suspend(caller); }
+            auto await_resume() -> Guard { return Guard(mAwaiter.await_resume(), mValue); }
+
+            Awaiter mAwaiter;
+            T      &mValue;
+        };
+        return Wrapper {std::move(awaiter), mValue};
+    }
+
+    RwMutex mMutex;
+    [[ILIAS_NO_UNIQUE_ADDRESS]]
+    T       mValue;
+};
+
+// Implementation
+// MARK: RwMutex
+inline auto RwMutex::tryRead() noexcept -> std::optional<RwReadGuard> {
+    if (tryReadFast()) {
+        return RwReadGuard(*this);
+    }
+    return std::nullopt;
+}
+
+inline auto RwMutex::tryWrite() noexcept -> std::optional<RwWriteGuard> {
+    if (tryWriteInternal()) {
+        return RwWriteGuard(*this);
+    }
+    return std::nullopt;
+}
+
+inline auto RwMutex::tryUpgradableRead() noexcept -> std::optional<RwUpgradableGuard> {
+    if (tryUpgradableInternal()) {
+        return RwUpgradableGuard(*this);
+    }
+    return std::nullopt;
+}
+
+inline auto RwMutex::blockingRead() -> RwReadGuard {
+    if (!tryReadFast()) {
+        mReaders.blockingWait([this]() { return tryReadInternal(); });
+    }
+    return RwReadGuard(*this);
+}
+
+inline auto RwMutex::blockingWrite() -> RwWriteGuard {
+    if (!tryWriteInternal()) {
+        addWaiting();
+        mWriters.blockingWait([this]() { return tryWritePending(); });
+    }
+    return RwWriteGuard(*this);
+}
+
+inline auto RwMutex::blockingUpgradableRead() -> RwUpgradableGuard {
+    mReaders.blockingWait([this]() { return tryUpgradableInternal(); });
+    return RwUpgradableGuard(*this);
+}
+
+// MARK: Guards
+inline RwReadGuard::RwReadGuard(RwMutex &m) : mMutex(&m) {
+    ILIAS_ASSERT(mMutex->readerCount() > 0);
+}
+
+inline RwReadGuard::RwReadGuard(RwReadGuard &&o) : mMutex(o.mMutex) {
+    o.mMutex = nullptr;
+}
+
+inline RwReadGuard::~RwReadGuard() {
+    unlock();
+}
+
+inline auto RwReadGuard::unlock() -> void {
+    if (mMutex) {
+        mMutex->unlockReadRaw();
+        mMutex = nullptr;
+    }
+}
+
+inline auto RwReadGuard::release() -> void {
+    mMutex = nullptr;
+}
+
+inline auto RwReadGuard::leak() -> void {
+    mMutex = nullptr;
+}
+
+inline RwWriteGuard::RwWriteGuard(RwMutex &m) : mMutex(&m) {
+    ILIAS_ASSERT(mMutex->isLocked());
+}
+
+inline RwWriteGuard::RwWriteGuard(RwWriteGuard &&o) : mMutex(o.mMutex) {
+    o.mMutex = nullptr;
+}
+
+inline RwWriteGuard::~RwWriteGuard() {
+    unlock();
+}
+
+inline auto RwWriteGuard::downgrade() -> RwReadGuard {
+    ILIAS_ASSERT(mMutex, "Downgrade a released guard");
+    auto mutex = std::exchange(mMutex, nullptr);
+    auto prev = mutex->mState.fetch_add(sync::RwState::ReaderOne - sync::RwState::Writer, std::memory_order_release);
+    if (!(prev & sync::RwState::WaitingMask)) { // The other readers can come in now
+        mutex->mReaders.wakeupAll();
+    }
+    return RwReadGuard(*mutex);
+}
+
+inline auto RwWriteGuard::unlock() -> void {
+    if (mMutex) {
+        mMutex->unlockWriteRaw();
+        mMutex = nullptr;
+    }
+}
+
+inline auto RwWriteGuard::release() -> void {
+    mMutex = nullptr;
+}
+
+inline auto RwWriteGuard::leak() -> void {
+    mMutex = nullptr;
+}
+
+inline RwUpgradableGuard::RwUpgradableGuard(RwMutex &m) : mMutex(&m) {
+    ILIAS_ASSERT(mMutex->mState.load(std::memory_order_relaxed) & sync::RwState::Upgradable);
+}
+
+inline RwUpgradableGuard::RwUpgradableGuard(RwUpgradableGuard &&o) : mMutex(o.mMutex) {
+    o.mMutex = nullptr;
+}
+
+inline RwUpgradableGuard::~RwUpgradableGuard() {
+    unlock();
+}
+
+inline auto RwUpgradableGuard::tryUpgrade() -> std::optional<RwWriteGuard> {
+    ILIAS_ASSERT(mMutex, "Upgrade a released guard");
+    if (!mMutex->tryUpgradeInternal(false)) {
+        return std::nullopt;
+    }
+    return RwWriteGuard(*std::exchange(mMutex, nullptr));
+}
+
+inline auto RwUpgradableGuard::unlock() -> void {
+    if (mMutex) {
+        mMutex->unlockUpgradableRaw();
+        mMutex = nullptr;
+    }
+}
+
+inline auto RwUpgradableGuard::release() -> void {
+    mMutex = nullptr;
+}
+
+inline auto RwUpgradableGuard::leak() -> void {
+    mMutex = nullptr;
+}
+
+// MARK: Awaiters
+inline sync::ReadAwaiter::ReadAwaiter(RwMutex &m) : WaitAwaiter(m.mReaders), mMutex(m) {
+
+}
+
+inline auto sync::ReadAwaiter::await_ready() -> bool {
+    return mMutex.tryReadFast();
+}
+
+inline auto sync::ReadAwaiter::await_resume() -> RwReadGuard {
+    return RwReadGuard(mMutex); // Got this in await_ready or onWakeup
+}
+
+inline auto sync::ReadAwaiter::onWakeup() -> bool {
+    return mMutex.tryReadInternal();
+}
+
+inline sync::UpgradableAwaiter::UpgradableAwaiter(RwMutex &m) : WaitAwaiter(m.mReaders), mMutex(m) {
+
+}
+
+inline auto sync::UpgradableAwaiter::await_ready() -> bool {
+    return mMutex.tryUpgradableInternal();
+}
+
+inline auto sync::UpgradableAwaiter::await_resume() -> RwUpgradableGuard {
+    return RwUpgradableGuard(mMutex);
+}
+
+inline auto sync::UpgradableAwaiter::onWakeup() -> bool {
+    return mMutex.tryUpgradableInternal();
+}
+
+inline sync::WriteAwaiter::WriteAwaiter(RwMutex &m) : WaitAwaiter(m.mWriters), mMutex(m) {
+
+}
+
+inline sync::WriteAwaiter::WriteAwaiter(WriteAwaiter &&o) : WaitAwaiter(std::move(o)), mMutex(o.mMutex), mPending(std::exchange(o.mPending, false)) {
+
+}
+
+inline sync::WriteAwaiter::~WriteAwaiter() {
+    if (mPending) { // Cancelled while waiting
+        mMutex.removeWaiting();
+    }
+}
+
+inline auto sync::WriteAwaiter::await_ready() -> bool {
+    if (mMutex.tryWriteInternal()) {
+        return true;
+    }
+    mMutex.addWaiting(); // Block the new readers from now on
+    mPending = true;
+    return false;
+}
+
+inline auto sync::WriteAwaiter::await_resume() -> RwWriteGuard {
+    return RwWriteGuard(mMutex);
+}
+
+inline auto sync::WriteAwaiter::onWakeup() -> bool {
+    if (mMutex.tryWritePending()) {
+        mPending = false;
+        return true;
+    }
+    return false;
+}
+
+inline sync::UpgradeAwaiter::UpgradeAwaiter(RwUpgradableGuard &guard) : WaitAwaiter(guard.mMutex->mWriters), mGuard(guard), mMutex(*guard.mMutex) {
+
+}
+
+inline sync::UpgradeAwaiter::UpgradeAwaiter(UpgradeAwaiter &&o) : WaitAwaiter(std::move(o)), mGuard(o.mGuard), mMutex(o.mMutex), mPending(std::exchange(o.mPending, false)) {
+
+}
+
+inline sync::UpgradeAwaiter::~UpgradeAwaiter() {
+    if (mPending) { // Cancelled while waiting, the guard still holds the upgradable read lock
+        mMutex.removeWaiting();
+    }
+}
+
+inline auto sync::UpgradeAwaiter::await_ready() -> bool {
+    if (mMutex.tryUpgradeInternal(false)) {
+        return true;
+    }
+    mMutex.addWaiting();
+    mPending = true;
+    return false;
+}
+
+inline auto sync::UpgradeAwaiter::await_resume() -> RwWriteGuard {
+    mGuard.release(); // The lock is moved into the write guard
+    return RwWriteGuard(mMutex);
+}
+
+inline auto sync::UpgradeAwaiter::onWakeup() -> bool {
+    if (mMutex.tryUpgradeInternal(true)) {
+        mPending = false;
+        return true;
+    }
+    return false;
+}
+
+ILIAS_NS_END
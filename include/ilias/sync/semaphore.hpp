@@ -2,9 +2,13 @@
 
 #include <ilias/sync/detail/queue.hpp> // WaitQueue, WaitAwaiter
 #include <ilias/runtime/coro.hpp>
+#include <ilias/task/utils.hpp> // timeout
+#include <ilias/task/task.hpp>
 #include <ilias/log.hpp>
 #include <optional> // std::optional
+#include <utility> // std::exchange
 #include <atomic> // std::atomic
+#include <chrono> // std::chrono::nanoseconds
 
 ILIAS_NS_BEGIN
 
@@ -15,14 +19,25 @@ public:
     ~SemaphorePermit();
 
     auto leak() noexcept -> void;
+
+    /**
+     * @brief Get the num of the permits held by it
+     * 
+     * @return ptrdiff_t
+     */
+    auto count() const noexcept -> ptrdiff_t { return mSem ? mCount : 0; }
 private:
-    SemaphorePermit(Semaphore &sem);
+    SemaphorePermit(Semaphore &sem, ptrdiff_t count = 1);
     Semaphore *mSem = nullptr;
+    ptrdiff_t  mCount = 0;
 friend class Semaphore;
 };
 
 /**
  * @brief The coroutine version of a semaphore. thread-safe, like std::semaphore
+ * @note The permits can be acquired by weight (bytes, connections, ...), the waiters get the released permits in order.
+ *       Only with Fifo fairness a heavy waiter at the head is never starved, by the light ones behind it or the newcomers;
+ *       with Barging (the default) a light newcomer (acquire or tryAcquire) takes the free permits if they are enough for it.
  * 
  */
 class Semaphore {
@@ -33,72 +48,119 @@ public:
      * @param count The initial count
      */
     explicit Semaphore(ptrdiff_t count) : mCount(count) { ILIAS_ASSERT(count >= 0); }
+
+    /**
+     * @brief Construct a new Semaphore object with the specified count and fairness
+     * 
+     * @param count The initial count
+     * @param fairness Fifo to make the newcomers queue behind the waiters, even if the free permits are enough for them (no barging)
+     */
+    Semaphore(ptrdiff_t count, sync::Fairness fairness) : mCount(count), mFairness(fairness) { ILIAS_ASSERT(count >= 0); }
     Semaphore(const Semaphore &) = delete;
 
     /**
-     * @brief Accquire a permit from the semaphore
+     * @brief Accquire n permits from the semaphore
+     * @note It waits forever if n is greater than the total permits
      * 
+     * @param n The num of the permits (the weight), must be greater than 0
      * @return SemaphorePermit
      */
     [[nodiscard]]
-    auto acquire() {
+    auto acquire(ptrdiff_t n = 1) {
         struct Awaiter : sync::WaitAwaiter<Awaiter> {
-            Awaiter(Semaphore &sem) : sync::WaitAwaiter<Awaiter>(sem.mQueue), sem(sem) {}
+            Awaiter(Semaphore &sem, ptrdiff_t n) : sync::WaitAwaiter<Awaiter>(sem.mQueue), sem(sem), n(n) {}
+            Awaiter(Awaiter &&other) : sync::WaitAwaiter<Awaiter>(std::move(other)), sem(other.sem), n(other.n), got(std::exchange(other.got, true)) {}
+            ~Awaiter() {
+                if (!got) { // Cancelled, we may block the waiters behind us
+                    sem.mQueue.wakeupInOrder();
+                }
+            }
 
             auto await_ready() -> bool {
-                return sem.tryAcquireInternal();
+                if (sem.mFairness == sync::Fairness::Fifo && sem.mQueue.hasWaiters()) {
+                    return false;
+                }
+                got = sem.tryAcquireInternal(n);
+                return got;
             }
 
             [[nodiscard]]
             auto await_resume() -> SemaphorePermit {
-                return SemaphorePermit(sem); // Got this in onWakeup
+                return SemaphorePermit(sem, n); // Got this in onWakeup
             }
 
             auto onWakeup() -> bool {
-                return sem.tryAcquireInternal();
+                if (sem.mFairness == sync::Fairness::Fifo && !sem.mQueue.isHead(*this)) {
+                    return false;
+                }
+                got = sem.tryAcquireInternal(n);
+                return got;
             }
 
             Semaphore &sem;
+            ptrdiff_t  n;
+            bool       got = false;
         };
-        return Awaiter(*this);
+        ILIAS_ASSERT(n > 0);
+        return Awaiter(*this, n);
     }
 
     /**
-     * @brief Blocking accquire a permit from the semaphore
+     * @brief Accquire n permits from the semaphore, give up on timeout
+     * 
+     * @param timeout The max time to wait (by the TimerService of the current executor)
+     * @param n The num of the permits (the weight), must be greater than 0
+     * @return Task<Option<SemaphorePermit> >, nullopt on timeout
+     */
+    [[nodiscard]]
+    auto acquireFor(std::chrono::nanoseconds timeout, ptrdiff_t n = 1) -> Task<Option<SemaphorePermit> > {
+        if (auto permit = tryAcquire(n); permit) { // Fast path, don't touch the timer
+            co_return std::move(*permit);
+        }
+        co_return co_await ilias::timeout(acquire(n), timeout);
+    }
+
+    /**
+     * @brief Blocking accquire n permits from the semaphore
      * @note It will ```BLOCK``` the current thread
      * 
-     * @return SemaphorePermit 
+     * @param n The num of the permits (the weight), must be greater than 0
+     * @return SemaphorePermit
      */
     [[nodiscard]]
-    auto blockingAcquire() -> SemaphorePermit {
-        mQueue.blockingWait([&]() { return tryAcquireInternal(); });
-        return SemaphorePermit(*this);
+    auto blockingAcquire(ptrdiff_t n = 1) -> SemaphorePermit {
+        ILIAS_ASSERT(n > 0);
+        mQueue.blockingWait([&]() { return tryAcquireInternal(n); });
+        return SemaphorePermit(*this, n);
     }
 
     /**
-     * @brief Try to accquire a permit from the semaphore
+     * @brief Try to accquire n permits from the semaphore
+     * @note With Fifo fairness, it fails if there are any waiters, even if the free permits are enough
      * 
-     * @return std::optional<SemaphorePermit> 
+     * @param n The num of the permits (the weight), must be greater than 0
+     * @return std::optional<SemaphorePermit>
      */
     [[nodiscard]]
-    auto tryAcquire() -> std::optional<SemaphorePermit> {
-        auto current = mCount.load(std::memory_order_acquire);
-        while (current > 0) { // Still has permits
-            if (mCount.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel)) {
-                return SemaphorePermit(*this);
-            }
+    auto tryAcquire(ptrdiff_t n = 1) -> std::optional<SemaphorePermit> {
+        ILIAS_ASSERT(n > 0);
+        if (mFairness == sync::Fairness::Fifo && mQueue.hasWaiters()) { // Don't overtake the waiters
+            return std::nullopt;
+        }
+        if (tryAcquireInternal(n)) {
+            return SemaphorePermit(*this, n);
         }
         return std::nullopt;
     }
 
     /**
-     * @brief Release a permit to the semaphore
+     * @brief Release n permits to the semaphore
      * @note This method is used as impl, not recommended to use directly
      * 
      */
-    auto releaseRaw() -> void {
-        mCount.fetch_add(1, std::memory_order_release);
-        mQueue.wakeupOne();
+    auto releaseRaw(ptrdiff_t n = 1) -> void {
+        mCount.fetch_add(n, std::memory_order_release);
+        mQueue.wakeupInOrder(); // Hand them to the waiters from the head, until the head one can't get enough
     }
 
     /**
@@ -108,45 +170,47 @@ public:
      */
     auto addPremits(ptrdiff_t n) -> void {
         ILIAS_ASSERT(n >= 0);
-        mCount.fetch_add(n, std::memory_order_release);
-        for (ptrdiff_t i = 0; i < n; ++i) {
-            mQueue.wakeupOne();
+        if (n > 0) {
+            releaseRaw(n);
         }
     }
 
     /**
      * @brief Get the number of available permits
      * 
-     * @return ptrdiff_t 
+     * @return ptrdiff_t
      */
     auto available() const noexcept -> ptrdiff_t {
         return mCount.load(std::memory_order_acquire);
     }
 private:
-    auto tryAcquireInternal() -> bool {
-        auto premit = tryAcquire();
-        if (premit) {
-            premit->leak(); // Transfer the permit to waiter
-            return true;
+    // Take n permits without checking the waiters, the caller owns them on success
+    auto tryAcquireInternal(ptrdiff_t n) -> bool {
+        auto current = mCount.load(std::memory_order_acquire);
+        while (current >= n) { // Still has enough permits
+            if (mCount.compare_exchange_weak(current, current - n, std::memory_order_acq_rel)) {
+                return true;
+            }
         }
         return false;
     }
 
     sync::WaitQueue        mQueue;
     std::atomic<ptrdiff_t> mCount;
+    sync::Fairness         mFairness = sync::Fairness::Barging;
 };
 
-inline SemaphorePermit::SemaphorePermit(Semaphore &sem) : mSem(&sem) {}
-inline SemaphorePermit::SemaphorePermit(SemaphorePermit &&other) : mSem(other.mSem) {
+inline SemaphorePermit::SemaphorePermit(Semaphore &sem, ptrdiff_t count) : mSem(&sem), mCount(count) {}
+inline SemaphorePermit::SemaphorePermit(SemaphorePermit &&other) : mSem(other.mSem), mCount(other.mCount) {
     other.mSem = nullptr;
 }
 inline SemaphorePermit::~SemaphorePermit() {
     if (mSem) {
-        mSem->releaseRaw();
+        mSem->releaseRaw(mCount);
     }
 }
 inline auto SemaphorePermit::leak() noexcept -> void {
     mSem = nullptr;
 }
 
-ILIAS_NS_END
\ No newline at end of file
+ILIAS_NS_END
@@ -0,0 +1,503 @@
+/**
+ * @file spsc.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The single producer single consumer channel.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/channel_core.hpp> // ChannelBase
+#include <ilias/sync/detail/queue.hpp> // WaitQueue
+#include <ilias/sync/detail/ring.hpp> // SpscRing
+#include <ilias/task/task.hpp>
+#include <ilias/result.hpp> // Result
+#include <optional> // std::optional
+#include <memory> // std::unique_ptr
+#include <vector> // std::vector
+#include <atomic> // std::atomic
+#include <span> // std::span
+
+ILIAS_NS_BEGIN
+
+namespace spsc {
+
+// Re-import types
+using sync::Sendable;
+
+// Implementation
+namespace detail {
+
+// The data is in the wait-free ring, the WaitQueue is only touched when the other side is parked (see WaitQueue::wakeupOne)
+template <Sendable T>
+class Channel final : public sync::ChannelBase {
+public:
+    Channel(size_t c) : ring(c) {}
+    Channel(Channel &&) = delete;
+    ~Channel() { // Check state
+        ILIAS_ASSERT(receiverClosed.load());
+        ILIAS_ASSERT(senderClosed.load());
+    }
+
+    // For sender
+    auto trySendInternal(Result<void, T> &item) -> bool {
+        if (receiverClosed.load(std::memory_order_acquire)) { // We can't send any more data.
+            return true;
+        }
+        if (!ring.tryPush(item.error())) {
+            return false; // No space, continue to wait.
+        }
+        item = {};
+        return true; // Sended
+    }
+
+    // Returns true when there is space or the receiver is closed
+    auto writableInternal() -> bool {
+        return receiverClosed.load(std::memory_order_acquire) || ring.writable() != 0;
+    }
+
+    auto onSenderClose() -> void {
+        senderClosed.store(true, std::memory_order_release); // The sender is closed.
+        if (!receiverClosed.load(std::memory_order_acquire)) { // Let the receiver observe the closed state.
+            receiver.wakeupOne();
+        }
+    }
+
+    // For receiver
+    auto tryRecvInternal(std::optional<T> &value) -> bool {
+        value = ring.tryPop();
+        if (value) {
+            return true; // Have data
+        }
+        if (senderClosed.load(std::memory_order_acquire)) {
+            value = ring.tryPop(); // Pick the item sent just before the close
+            return true; // No sender, so we can't receive any more.
+        }
+        return false;
+    }
+
+    auto tryRecvManyInternal(sync::BatchOutput<T> &out, size_t max, size_t &got) -> bool {
+        size_t idx = 0;
+        auto push = [&](T &&item) { out.put(idx++, std::move(item)); };
+        got = ring.popMany(max, push);
+        if (got != 0) {
+            return true; // Have data
+        }
+        if (senderClosed.load(std::memory_order_acquire)) {
+            got = ring.popMany(max, push);
+            return true;
+        }
+        return false;
+    }
+
+    auto onReceiverClose() -> void {
+        receiverClosed.store(true, std::memory_order_release); // The receiver is closed.
+        if (!senderClosed.load(std::memory_order_acquire)) {
+            sender.wakeupOne();
+        }
+    }
+
+    // States
+    std::atomic<bool>  senderClosed   {false}; // If the sender is closed.
+    std::atomic<bool>  receiverClosed {false}; // If the receiver is closed.
+    sync::SpscRing<T>  ring;
+
+    // Sync, at most one waiter in each queue
+    sync::WaitQueue    sender;
+    sync::WaitQueue    receiver;
+};
+
+template <Sendable T>
+class SendAwaiter final : public sync::WaitAwaiter<SendAwaiter<T> > {
+public:
+    SendAwaiter(Channel<T> *c, T value) : sync::WaitAwaiter<SendAwaiter<T> >(c->sender), mChan(c), mResult(Err(std::move(value))) {}
+    SendAwaiter(SendAwaiter &&) = default;
+
+    auto await_resume() -> Result<void, T> {
+        if (mResult) { // Is sended
+            mChan->receiver.wakeupOne();
+        }
+        return std::move(mResult);
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->trySendInternal(mResult);
+    }
+private:
+    Channel<T> *mChan;
+    Result<void, T> mResult;
+};
+
+// Wait for any space (or closed), used by the batch send
+template <Sendable T>
+class WritableAwaiter final : public sync::WaitAwaiter<WritableAwaiter<T> > {
+public:
+    WritableAwaiter(Channel<T> *c) : sync::WaitAwaiter<WritableAwaiter<T> >(c->sender), mChan(c) {}
+    WritableAwaiter(WritableAwaiter &&) = default;
+
+    auto await_resume() -> void {}
+
+    auto onWakeup() -> bool {
+        return mChan->writableInternal();
+    }
+private:
+    Channel<T> *mChan;
+};
+
+template <Sendable T>
+class ReceiveAwaiter final : public sync::WaitAwaiter<ReceiveAwaiter<T> > {
+public:
+    ReceiveAwaiter(Channel<T> *c) : sync::WaitAwaiter<ReceiveAwaiter<T> >(c->receiver), mChan(c) {}
+    ReceiveAwaiter(ReceiveAwaiter &&) = default;
+
+    auto await_resume() -> std::optional<T> {
+        if (mValue) {
+            mChan->sender.wakeupOne();
+        }
+        return std::move(mValue);
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->tryRecvInternal(mValue);
+    }
+private:
+    Channel<T>      *mChan;
+    std::optional<T> mValue; // The value we got
+};
+
+template <Sendable T>
+class ReceiveManyAwaiter final : public sync::WaitAwaiter<ReceiveManyAwaiter<T> > {
+public:
+    ReceiveManyAwaiter(Channel<T> *c, sync::BatchOutput<T> out, size_t max) :
+        sync::WaitAwaiter<ReceiveManyAwaiter<T> >(c->receiver), mChan(c), mOut(out), mMax(max) {}
+    ReceiveManyAwaiter(ReceiveManyAwaiter &&) = default;
+
+    auto await_resume() -> size_t {
+        if (mGot != 0) { // Only one wakeup for the whole batch
+            mChan->sender.wakeupOne();
+        }
+        return mGot;
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->tryRecvManyInternal(mOut, mMax, mGot);
+    }
+private:
+    Channel<T>          *mChan;
+    sync::BatchOutput<T> mOut;
+    size_t               mMax;
+    size_t               mGot = 0;
+};
+
+template <Sendable T>
+using ChanSender   = std::unique_ptr<Channel<T>, sync::ChanSenderDeleter>;
+
+template <Sendable T>
+using ChanReceiver = std::unique_ptr<Channel<T>, sync::ChanReceiverDeleter>;
+
+} // namespace detail
+
+template <Sendable T>
+class Sender;
+
+template <Sendable T>
+class Receiver;
+
+template <Sendable T>
+struct Pair {
+    Sender<T>   sender;
+    Receiver<T> receiver;
+};
+
+enum class TryRecvError {
+    Empty,
+    Closed
+};
+
+enum class TrySendError {
+    Full,
+    Closed
+};
+
+template <typename T>
+struct TrySendErrorResult {
+    T            item;
+    TrySendError reason;
+};
+
+/**
+ * @brief The spsc sender class. This class is used to send data to the channel. (only moveable)
+ *
+ * @tparam T The item type to be sent.
+ */
+template <Sendable T>
+class Sender final {
+public:
+    Sender() = default;
+    Sender(const Sender &) = delete;
+    Sender(Sender &&) = default;
+    ~Sender() = default;
+
+    /**
+     * @brief Close the sender
+     *
+     */
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if the channel is closed. we can't send any more data
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return !mChan || mChan->receiverClosed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the capacity of the channel. (the capacity given in channel() rounded up to the power of two)
+     *
+     * @return size_t
+     */
+    auto capacity() const noexcept -> size_t {
+        return mChan ? mChan->ring.size() : 0;
+    }
+
+    /**
+     * @brief Send a item to the channel.
+     * @note Cancellation: If the send is cancelled, the item will be lost.
+     *
+     * @param item The item to be sent.
+     * @return Result<void, T>, if the receiver is closed, return Err(item), else return {}.
+     */
+    [[nodiscard]]
+    auto send(T item) noexcept {
+        return detail::SendAwaiter<T> {mChan.get(), std::move(item)};
+    }
+
+    /**
+     * @brief Send all the items to the channel, it pushes as many items as the space allows, and wakes the receiver once for each push.
+     * @note Cancellation: The items not sent are left in the span.
+     *
+     * @param items The items will be moved from, it must be alive until the task is done
+     * @return Task<size_t> The num of items sent, less than the items.size() only when the receiver is closed
+     */
+    [[nodiscard]]
+    auto sendMany(std::span<T> items) -> Task<size_t> {
+        auto chan = mChan.get();
+        size_t sent = 0;
+        while (sent < items.size()) {
+            if (chan->receiverClosed.load(std::memory_order_acquire)) {
+                break;
+            }
+            auto rest = items.subspan(sent);
+            auto n = chan->ring.pushMany(rest.begin(), rest.size());
+            if (n != 0) {
+                sent += n;
+                chan->receiver.wakeupOne();
+                continue;
+            }
+            co_await detail::WritableAwaiter<T> {chan}; // Full, wait for the receiver
+        }
+        co_return sent;
+    }
+
+    /**
+     * @brief Try send a item to the channel.
+     *
+     * @param item The item to be sent.
+     * @return Result<void, TrySendErrorResult<T> >
+     */
+    [[nodiscard]]
+    auto trySend(T item) -> Result<void, TrySendErrorResult<T> > {
+        if (mChan->receiverClosed.load(std::memory_order_acquire)) {
+            return Err(TrySendErrorResult<T> { .item = std::move(item), .reason = TrySendError::Closed });
+        }
+        if (!mChan->ring.tryPush(item)) {
+            return Err(TrySendErrorResult<T> { .item = std::move(item), .reason = TrySendError::Full });
+        }
+
+        // Success to send, wakeup the receiver (if parked).
+        mChan->receiver.wakeupOne();
+        return {};
+    }
+
+    /**
+     * @brief Blocking send a item to the channel.
+     * @note It will ```BLOCK``` the thread, so it is not recommended to use it in the async context, use it in sync code
+     *
+     * @param item
+     * @return Result<void, T>, if the receiver is closed, return Err(item), else return {}.
+     */
+    [[nodiscard]]
+    auto blockingSend(T item) -> Result<void, T> {
+        Result<void, T> result {Err(std::move(item))}; // First put it to error as unsended.
+        mChan->sender.blockingWait([&]() { return mChan->trySendInternal(result); });
+        if (result) { // Success to send, wakeup the receiver.
+            mChan->receiver.wakeupOne();
+        }
+        return result;
+    }
+
+    auto operator =(const Sender &other) = delete;
+    auto operator =(Sender &&other) -> Sender & = default;
+
+    // Check the sender is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    explicit Sender(detail::Channel<T> *chan) : mChan(chan) {}
+
+    detail::ChanSender<T> mChan;
+template <Sendable U>
+friend auto channel(size_t capacity) -> Pair<U>;
+};
+
+/**
+ * @brief The spsc receiver class. This class is used to receive data from the channel. (only moveable)
+ *
+ * @tparam T The item type to be received.
+ */
+template <Sendable T>
+class Receiver final {
+public:
+    Receiver() = default;
+    Receiver(const Receiver &) = delete;
+    Receiver(Receiver &&) = default;
+    ~Receiver() = default;
+
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if the channel is closed. the sender can't send any more data
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return !mChan || mChan->senderClosed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the capacity of the channel.
+     *
+     * @return size_t
+     */
+    auto capacity() const noexcept -> size_t {
+        return mChan ? mChan->ring.size() : 0;
+    }
+
+    /**
+     * @brief Receive a item from the channel.
+     *
+     * @return std::optional<T>, nullopt on the channel is closed
+     */
+    [[nodiscard]]
+    auto recv() noexcept {
+        return detail::ReceiveAwaiter<T> {mChan.get()};
+    }
+
+    /**
+     * @brief Receive at least one item, at most max items from the channel, wake the sender once for the batch.
+     *
+     * @param out The items will be appended to it
+     * @param max The max num of the items
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::vector<T> &out, size_t max) noexcept {
+        ILIAS_ASSERT(max > 0, "The max of recvMany must be greater than 0.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, max};
+    }
+
+    /**
+     * @brief Receive at least one item, at most out.size() items from the channel
+     *
+     * @param out The items will be assigned from the begin
+     * @return size_t (awaitable) The num of the items received, 0 on the channel is closed
+     */
+    [[nodiscard]]
+    auto recvMany(std::span<T> out) noexcept {
+        ILIAS_ASSERT(!out.empty(), "The span of recvMany must not be empty.");
+        return detail::ReceiveManyAwaiter<T> {mChan.get(), out, out.size()};
+    }
+
+    /**
+     * @brief Try receive a item from the channel.
+     *
+     * @return Result<T, TryRecvError>
+     */
+    [[nodiscard]]
+    auto tryRecv() noexcept(std::is_nothrow_move_constructible_v<T>) -> Result<T, TryRecvError> {
+        std::optional<T> value {};
+        if (!mChan->tryRecvInternal(value)) {
+            return Err(TryRecvError::Empty);
+        }
+        if (!value) {
+            return Err(TryRecvError::Closed);
+        }
+
+        // Success to recv, wakeup the sender (if parked).
+        mChan->sender.wakeupOne();
+        return std::move(*value);
+    }
+
+    /**
+     * @brief Blocking Receive a item from the channel.
+     * @note It will ```BLOCK``` the thread, so it is not recommended to use it in the async context, use it in sync code
+     *
+     * @return std::optional<T>, nullopt on the channel is closed
+     */
+    [[nodiscard]]
+    auto blockingRecv() noexcept(std::is_nothrow_move_constructible_v<T>) -> std::optional<T> {
+        std::optional<T> value {};
+        mChan->receiver.blockingWait([&]() { return mChan->tryRecvInternal(value); });
+        if (value) { // Success to recv, wakeup the sender.
+            mChan->sender.wakeupOne();
+        }
+        return value;
+    }
+
+    auto operator =(const Receiver &other) = delete;
+    auto operator =(Receiver &&other) -> Receiver & = default;
+
+    // Check the receiver is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    explicit Receiver(detail::Channel<T> *chan) : mChan(chan) {}
+
+    detail::ChanReceiver<T> mChan;
+template <Sendable U>
+friend auto channel(size_t capacity) -> Pair<U>;
+};
+
+/**
+ * @brief Make a bounded channel for single producer and single consumer.
+ *
+ * @tparam T The item type to be sent and received. (must be moveable)
+ * @param capacity The capacity of the channel. (abort on 0), rounded up to the power of two
+ * @return Pair<T>
+ */
+template <Sendable T>
+inline auto channel(size_t capacity) -> Pair<T> {
+    ILIAS_ASSERT(capacity > 0, "The capacity of the channel must be greater than 0.");
+    auto ptr = new detail::Channel<T> {capacity};
+    return {
+        .sender = Sender<T> {ptr},
+        .receiver = Receiver<T> {ptr}
+    };
+}
+
+} // namespace spsc
+
+ILIAS_NS_END
@@ -0,0 +1,425 @@
+/**
+ * @file watch.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The watch channel, only keeps the latest value, for the config / state distribution.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/sync/detail/channel_core.hpp> // Sendable, ChanRef
+#include <ilias/sync/detail/queue.hpp> // WaitQueue
+#include <ilias/task/task.hpp>
+#include <shared_mutex> // std::shared_mutex, std::shared_lock
+#include <concepts> // std::invocable
+#include <memory> // std::shared_ptr
+#include <atomic> // std::atomic
+#include <mutex> // std::unique_lock
+
+ILIAS_NS_BEGIN
+
+namespace watch {
+
+// Re-import types
+using sync::Sendable;
+
+// Implementation
+namespace detail {
+
+// The version is bumped on each send, the receiver remembers the version it has seen, so the intermediate ones are skipped.
+template <Sendable T>
+class Channel final {
+public:
+    template <typename ...Args>
+    Channel(Args &&...args) : value(std::forward<Args>(args)...) {}
+    Channel(Channel &&) = delete;
+
+    // For sender
+    template <typename Fn>
+    auto modify(Fn &&fn) -> bool {
+        {
+            std::unique_lock locker {mutex};
+            if (!fn(value)) {
+                return false;
+            }
+            version.fetch_add(1, std::memory_order_release);
+        }
+        receivers.wakeupAll(); // Only touch the queue when someone is parked
+        return true;
+    }
+
+    auto onSenderClose() -> void {
+        closed.store(true, std::memory_order_release);
+        receivers.wakeupAll();
+    }
+
+    // For receiver
+    auto ready(uint64_t seen) const noexcept -> bool {
+        return version.load(std::memory_order_acquire) != seen || closed.load(std::memory_order_acquire);
+    }
+
+    T                        value;
+    std::shared_mutex        mutex; // Protect the value, readers borrow it under the shared lock
+    std::atomic<uint64_t>    version {1}; // The receivers start at version 0 (unseen) or the current one
+    std::atomic<size_t>      senderCount {0};
+    std::atomic<size_t>      receiverCount {0};
+    std::atomic<bool>        closed {false}; // All the senders are closed
+    sync::WaitQueue          receivers;
+};
+
+template <Sendable T>
+class ChangedAwaiter final : public sync::WaitAwaiter<ChangedAwaiter<T> > {
+public:
+    ChangedAwaiter(Channel<T> *c, uint64_t &seen) : sync::WaitAwaiter<ChangedAwaiter<T> >(c->receivers), mChan(c), mSeen(seen) {}
+    ChangedAwaiter(ChangedAwaiter &&) = default;
+
+    // Fast path, don't touch the queue if it is already changed
+    auto await_ready() const noexcept -> bool {
+        return mChan->ready(mSeen);
+    }
+
+    auto await_resume() -> bool {
+        auto version = mChan->version.load(std::memory_order_acquire);
+        if (version == mSeen) { // Not changed, so it is closed
+            return false;
+        }
+        mSeen = version; // Skip all the intermediate versions
+        return true;
+    }
+
+    auto onWakeup() -> bool {
+        return mChan->ready(mSeen);
+    }
+private:
+    Channel<T> *mChan;
+    uint64_t   &mSeen;
+};
+
+template <Sendable T>
+using ChanSender   = sync::ChanRef<Channel<T>, true>;
+
+template <Sendable T>
+using ChanReceiver = sync::ChanRef<Channel<T>, false>;
+
+} // namespace detail
+
+template <Sendable T>
+class Sender;
+
+template <Sendable T>
+class Receiver;
+
+template <Sendable T>
+struct Pair {
+    Sender<T>   sender;
+    Receiver<T> receiver;
+};
+
+/**
+ * @brief The borrowed reference to the value in the channel, it holds the shared lock
+ * @note Don't hold it across the suspend point (co_await), the senders are blocked until it is dropped
+ *
+ * @tparam T
+ */
+template <Sendable T>
+class Ref final {
+public:
+    Ref(Ref &&) = default;
+
+    /**
+     * @brief Check the borrowed value is newer than the version last seen by the receiver (before this borrow)
+     *
+     * @return true
+     * @return false
+     */
+    auto hasChanged() const noexcept -> bool {
+        return mChanged;
+    }
+
+    auto get() const noexcept -> const T & { return *mValue; }
+    auto operator *() const noexcept -> const T & { return *mValue; }
+    auto operator ->() const noexcept -> const T * { return mValue; }
+private:
+    Ref(detail::Channel<T> &chan, bool changed) : mLocker(chan.mutex), mValue(&chan.value), mChanged(changed) {}
+
+    std::shared_lock<std::shared_mutex> mLocker;
+    const T                            *mValue;
+    bool                                mChanged;
+template <Sendable U>
+friend class Sender;
+template <Sendable U>
+friend class Receiver;
+};
+
+/**
+ * @brief The watch receiver class. (copy & move able)
+ * @note The copy has the same seen version as the original one
+ *
+ * @tparam T
+ */
+template <Sendable T>
+class Receiver final {
+public:
+    Receiver() = default;
+    Receiver(const Receiver &) = default;
+    Receiver(Receiver &&) = default;
+    ~Receiver() = default;
+
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if all the senders are closed. (the last value is still borrowable)
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return !mChan || mChan->closed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check the value is changed since the version last seen
+     *
+     * @return true
+     * @return false
+     */
+    auto hasChanged() const noexcept -> bool {
+        return mChan->version.load(std::memory_order_acquire) != mSeen;
+    }
+
+    /**
+     * @brief Get the version last seen by the receiver
+     *
+     * @return uint64_t
+     */
+    auto version() const noexcept -> uint64_t {
+        return mSeen;
+    }
+
+    /**
+     * @brief Borrow the latest value without copy, the seen version is not changed
+     *
+     * @return Ref<T>
+     */
+    auto borrow() const -> Ref<T> {
+        auto ref = Ref<T> {*mChan, false};
+        ref.mChanged = mChan->version.load(std::memory_order_relaxed) != mSeen; // The version is bumped under the lock
+        return ref;
+    }
+
+    /**
+     * @brief Borrow the latest value without copy, and mark it as seen
+     *
+     * @return Ref<T>
+     */
+    auto borrowAndUpdate() -> Ref<T> {
+        auto ref = borrow();
+        mSeen = mChan->version.load(std::memory_order_relaxed);
+        return ref;
+    }
+
+    /**
+     * @brief Mark the current value as seen
+     *
+     */
+    auto markSeen() noexcept -> void {
+        mSeen = mChan->version.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Mark the current value as not seen, so the next changed() returns at once
+     *
+     */
+    auto markChanged() noexcept -> void {
+        mSeen = 0;
+    }
+
+    /**
+     * @brief Wait for the value newer than the seen version, and mark it as seen, the intermediate versions are skipped
+     * @note Use borrow() to read the value after it
+     *
+     * @return bool (awaitable), false on all the senders are closed
+     */
+    [[nodiscard]]
+    auto changed() noexcept {
+        return detail::ChangedAwaiter<T> {mChan.get(), mSeen};
+    }
+
+    /**
+     * @brief Blocking wait for the value newer than the seen version
+     * @note It will ```BLOCK``` the thread, so it is not recommended to use it in the async context, use it in sync code
+     *
+     * @return bool, false on all the senders are closed
+     */
+    auto blockingChanged() -> bool {
+        mChan->receivers.blockingWait([&]() { return mChan->ready(mSeen); });
+        auto version = mChan->version.load(std::memory_order_acquire);
+        if (version == mSeen) {
+            return false;
+        }
+        mSeen = version;
+        return true;
+    }
+
+    auto operator =(const Receiver &other) -> Receiver & = default;
+    auto operator =(Receiver &&other) -> Receiver & = default;
+
+    // Check the receiver is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    Receiver(std::shared_ptr<detail::Channel<T> > chan, uint64_t seen) : mChan(std::move(chan)), mSeen(seen) {}
+
+    detail::ChanReceiver<T> mChan;
+    uint64_t                mSeen = 0;
+template <Sendable U>
+friend class Sender;
+template <Sendable U, typename ...Args>
+friend auto channel(Args &&...args) -> Pair<U>;
+};
+
+/**
+ * @brief The watch sender class, it never waits for the receivers. (copy & move able)
+ *
+ * @tparam T
+ */
+template <Sendable T>
+class Sender final {
+public:
+    Sender() = default;
+    Sender(const Sender &) = default;
+    Sender(Sender &&) = default;
+    ~Sender() = default;
+
+    auto close() noexcept -> void {
+        mChan.reset();
+    }
+
+    /**
+     * @brief Check if all the receivers are closed
+     *
+     * @return true
+     * @return false
+     */
+    auto isClosed() const noexcept -> bool {
+        return receiverCount() == 0;
+    }
+
+    /**
+     * @brief Get the num of the receivers
+     *
+     * @return size_t
+     */
+    auto receiverCount() const noexcept -> size_t {
+        return mChan ? mChan->receiverCount.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Replace the value and notify the receivers, it never waits (only for the borrowers to drop their refs)
+     *
+     * @param value
+     */
+    auto send(T value) const -> void {
+        mChan->modify([&](T &cur) {
+            cur = std::move(value);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Replace the value and return the old one
+     *
+     * @param value
+     * @return T The old value
+     */
+    auto sendReplace(T value) const -> T {
+        mChan->modify([&](T &cur) {
+            std::swap(cur, value);
+            return true;
+        });
+        return value;
+    }
+
+    /**
+     * @brief Modify the value in place and notify the receivers
+     *
+     * @param fn The callback, called with T & under the lock
+     */
+    template <std::invocable<T &> Fn>
+    auto sendModify(Fn fn) const -> void {
+        mChan->modify([&](T &cur) {
+            fn(cur);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Modify the value in place, only notify the receivers if the callback returns true
+     *
+     * @param fn The callback, called with T & under the lock, return true if the value is modified
+     * @return bool The callback's result
+     */
+    template <std::invocable<T &> Fn>
+    auto sendIfModified(Fn fn) const -> bool {
+        return mChan->modify(fn);
+    }
+
+    /**
+     * @brief Borrow the current value without copy
+     *
+     * @return Ref<T>
+     */
+    auto borrow() const -> Ref<T> {
+        return Ref<T> {*mChan, false};
+    }
+
+    /**
+     * @brief Make a new receiver, the current value is marked as seen
+     *
+     * @return Receiver<T>
+     */
+    auto subscribe() const -> Receiver<T> {
+        return Receiver<T> {mChan.shared(), mChan->version.load(std::memory_order_acquire)};
+    }
+
+    auto operator =(const Sender &other) -> Sender & = default;
+    auto operator =(Sender &&other) -> Sender & = default;
+
+    // Check the sender is valid
+    explicit operator bool() const noexcept {
+        return bool(mChan);
+    }
+private:
+    explicit Sender(std::shared_ptr<detail::Channel<T> > chan) : mChan(std::move(chan)) {}
+
+    detail::ChanSender<T> mChan;
+template <Sendable U, typename ...Args>
+friend auto channel(Args &&...args) -> Pair<U>;
+};
+
+/**
+ * @brief Make a watch channel with the initial value, the initial value is marked as seen by the receiver
+ *
+ * @tparam T The value type
+ * @param args The args to construct the initial value
+ * @return Pair<T>
+ */
+template <Sendable T, typename ...Args>
+inline auto channel(Args &&...args) -> Pair<T> {
+    auto ptr = std::make_shared<detail::Channel<T> >(std::forward<Args>(args)...);
+    auto version = ptr->version.load(std::memory_order_relaxed);
+    return {
+        .sender = Sender<T> {ptr},
+        .receiver = Receiver<T> {ptr, version}
+    };
+}
+
+} // namespace watch
+
+ILIAS_NS_END
@@ -15,6 +15,8 @@
 #include <ilias/task/when_any.hpp>
 #include <ilias/task/thread.hpp>
 #include <ilias/task/spawn.hpp>
+#include <ilias/task/switch.hpp>
+#include <ilias/task/local.hpp>
 #include <ilias/task/utils.hpp>
 #include <ilias/task/task.hpp>
 #include <ilias/task/group.hpp>
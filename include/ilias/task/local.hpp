@@ -0,0 +1,146 @@
+/**
+ * @file local.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief The task local storage, the values are inherited by the children tasks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/local.hpp> // LocalStorage
+#include <ilias/runtime/coro.hpp> // CoroContext
+#include <ilias/task/task.hpp> // Task
+#include <memory> // std::shared_ptr
+#include <utility> // std::exchange
+
+#if defined(ILIAS_TASK_LOCAL)
+
+ILIAS_NS_BEGIN
+
+namespace task {
+
+using runtime::LocalStorage;
+
+// Restore the locals of the context on destruction
+class TaskLocalGuard final {
+public:
+    TaskLocalGuard(CoroContext &ctxt, LocalStorage::Ptr prev) : mCtxt(&ctxt), mPrev(std::move(prev)) {}
+    TaskLocalGuard(TaskLocalGuard &&other) noexcept : mCtxt(std::exchange(other.mCtxt, nullptr)), mPrev(std::move(other.mPrev)) {}
+    TaskLocalGuard(const TaskLocalGuard &) = delete;
+    ~TaskLocalGuard() {
+        if (mCtxt) {
+            mCtxt->setLocals(std::move(mPrev));
+        }
+    }
+private:
+    CoroContext      *mCtxt;
+    LocalStorage::Ptr mPrev;
+};
+
+// Replace the value of the slot in the current context
+class TaskLocalSetAwaiter : public this_coro::AwaiterBase {
+public:
+    TaskLocalSetAwaiter(size_t slot, LocalStorage::Value value) : mSlot(slot), mValue(std::move(value)) {}
+
+    auto await_resume() -> void {
+        mCtxt->setLocals(LocalStorage::with(mCtxt->locals(), mSlot, std::move(mValue)));
+    }
+protected:
+    size_t              mSlot;
+    LocalStorage::Value mValue;
+};
+
+// As same as the set, but return the guard to restore the previous one
+class TaskLocalScopeAwaiter final : public TaskLocalSetAwaiter {
+public:
+    using TaskLocalSetAwaiter::TaskLocalSetAwaiter;
+
+    auto await_resume() -> TaskLocalGuard {
+        auto prev = mCtxt->locals();
+        mCtxt->setLocals(LocalStorage::with(prev, mSlot, std::move(mValue)));
+        return {*mCtxt, std::move(prev)};
+    }
+};
+
+} // namespace task
+
+/**
+ * @brief The task local variable, like thread_local but for the task tree.
+ *
+ * The value is stored in the context of the task, the children tasks (spawn, whenAll, whenAny, TaskScope, TaskGroup, scheduleOn ...)
+ * inherit the values from the context which create them, and set a value in the child will not affect the parent.
+ * Lookup is O(1) by the slot index allocated at construction, so it should usually be declared as a global or static variable.
+ *
+ * @tparam T
+ *
+ * @code
+ *  static TaskLocal<std::string> traceId;
+ *
+ *  auto handle() -> Task<void> {
+ *      ILIAS_INFO("App", "TraceId {}", *traceId.get());
+ *      co_return;
+ *  }
+ *
+ *  co_await traceId.scope("1234", handle());
+ * @endcode
+ */
+template <typename T>
+class TaskLocal final {
+public:
+    TaskLocal() : mSlot(runtime::LocalStorage::allocateSlot()) {}
+    TaskLocal(const TaskLocal &) = delete;
+
+    /**
+     * @brief Get the value in the current running task
+     *
+     * @return T * (nullptr on not set or not in any task)
+     */
+    auto get() const noexcept -> T * {
+        auto ctxt = runtime::CoroContext::current();
+        if (!ctxt || !ctxt->locals()) {
+            return nullptr;
+        }
+        return static_cast<T *>(ctxt->locals()->get(mSlot));
+    }
+
+    /**
+     * @brief Set the value in the current task, the tasks created after it will see the new value
+     *
+     * @param value
+     * @return task::TaskLocalSetAwaiter
+     */
+    auto set(T value) const -> task::TaskLocalSetAwaiter {
+        return {mSlot, std::make_shared<T>(std::move(value))};
+    }
+
+    /**
+     * @brief Run the awaitable with the value set, the previous value will be restored after it completed
+     *
+     * @param value
+     * @param awaitable
+     * @return Task<AwaitableResult<U> >
+     */
+    template <Awaitable U>
+    auto scope(T value, U awaitable) const -> Task<AwaitableResult<U> > {
+        auto guard = co_await task::TaskLocalScopeAwaiter {mSlot, std::make_shared<T>(std::move(value))};
+        co_return co_await std::move(awaitable);
+    }
+
+    /**
+     * @brief Get the slot index of the task local
+     *
+     * @return size_t
+     */
+    auto slot() const noexcept -> size_t {
+        return mSlot;
+    }
+private:
+    size_t mSlot;
+};
+
+ILIAS_NS_END
+
+#endif // ILIAS_TASK_LOCAL
@@ -21,6 +21,14 @@
 
 ILIAS_NS_BEGIN
 
+/**
+ * @brief The options for spawn a task
+ * 
+ */
+struct SpawnOptions {
+    Option<runtime::Priority> priority; // The priority class of the task, nullopt on inherit from the spawner
+};
+
 namespace task {
 
 // Some containers
@@ -42,7 +50,7 @@ class TaskSpawnContextBase : public RefCounted<TaskSpawnContextBase>,
 {
 public:
     ILIAS_API
-    TaskSpawnContextBase(TaskHandle<> task, CaptureSource source);
+    TaskSpawnContextBase(TaskHandle<> task, CaptureSource source, SpawnOptions options = {});
     TaskSpawnContextBase(const TaskSpawnContextBase &) = delete;
 
     // Send the stop request of the spawn task
@@ -105,7 +113,7 @@ protected:
 template <typename T>
 class TaskSpawnContext final : public TaskSpawnContextBase {
 public:
-    TaskSpawnContext(TaskHandle<T> task, CaptureSource source) : TaskSpawnContextBase(task, source) {
+    TaskSpawnContext(TaskHandle<T> task, CaptureSource source, SpawnOptions options = {}) : TaskSpawnContextBase(task, source, options) {
         mManager = TaskSpawnContext::manager;
     }
 
@@ -314,7 +322,7 @@ private:
 
     task::Rc<task::TaskSpawnContextBase> mPtr;
 template <Awaitable U>
-friend auto spawn(U awaitale, runtime::CaptureSource source) -> WaitHandle<AwaitableResult<U> >;
+friend auto spawn(U awaitale, SpawnOptions options, runtime::CaptureSource source) -> WaitHandle<AwaitableResult<U> >;
 };
 
 /**
@@ -326,11 +334,25 @@ friend auto spawn(U awaitale, runtime::CaptureSource source) -> WaitHandle<Await
  */
 template <Awaitable T>
 inline auto spawn(T awaitable, runtime::CaptureSource source = {}) -> WaitHandle<AwaitableResult<T> > {
+    return spawn(std::move(awaitable), SpawnOptions {}, source);
+}
+
+/**
+ * @brief Spawn a task by using given awaitable and options, running on the current thread executor
+ * 
+ * @tparam T 
+ * @param awaitable The awaitable, (any awaitable object such as Task<T>, Fiber<T>)
+ * @param options The spawn options (priority, etc.)
+ * @return WaitHandle<AwaitableResult<T> > 
+ */
+template <Awaitable T>
+inline auto spawn(T awaitable, SpawnOptions options, runtime::CaptureSource source = {}) -> WaitHandle<AwaitableResult<T> > {
     using U = AwaitableResult<T>;
     return {
         new task::TaskSpawnContext<U> { // Create the context
             toTask(std::move(awaitable))._leak(), // Convert the awaitable to task and get the handle
-            source
+            source,
+            options
         }
     };
 }
@@ -343,14 +365,26 @@ inline auto spawn(T awaitable, runtime::CaptureSource source = {}) -> WaitHandle
  */
 template <std::invocable Fn>
 inline auto spawn(Fn fn, runtime::CaptureSource source = {}) -> WaitHandle<AwaitableResult<std::invoke_result_t<Fn> > > {
+    return spawn(std::move(fn), SpawnOptions {}, source);
+}
+
+/**
+ * @brief Spawn a task by using given callable and options, running on the current thread executor
+ * 
+ * @param fn The callable (it should return a awaitable)
+ * @param options The spawn options (priority, etc.)
+ * @return WaitHandle<AwaitableResult<std::invoke_result_t<Fn> > > 
+ */
+template <std::invocable Fn>
+inline auto spawn(Fn fn, SpawnOptions options, runtime::CaptureSource source = {}) -> WaitHandle<AwaitableResult<std::invoke_result_t<Fn> > > {
     if constexpr (std::is_function_v<Fn> || std::is_empty_v<Fn>) { // We didn't need to capture the function
-        return spawn(fn(), source);
+        return spawn(fn(), options, source);
     }
     else {
         auto wrapper = [](auto fn) -> std::invoke_result_t<Fn> {
             co_return co_await fn();
         };
-        return spawn(wrapper(std::move(fn)), source);
+        return spawn(wrapper(std::move(fn)), options, source);
     }
 }
 
@@ -0,0 +1,120 @@
+/**
+ * @file switch.hpp
+ * @author BusyStudent (fyw90mc@gmail.com)
+ * @brief Move the running coroutine to another executor, like this_coro::switchTo(ctxt)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#pragma once
+
+#include <ilias/runtime/executor.hpp>
+#include <ilias/runtime/coro.hpp>
+#include <vector> // std::vector
+#include <mutex> // std::mutex
+
+ILIAS_NS_BEGIN
+
+namespace task {
+
+using runtime::CoroContext;
+using runtime::CoroHandle;
+using runtime::Executor;
+
+class SwitchBatch;
+
+// MARK: Switch
+// Move the whole context (the caller and all coroutines awaiting it) to the target executor, by a single post
+class SwitchAwaiter {
+public:
+    SwitchAwaiter(Executor &target, SwitchBatch *batch = nullptr) : mTarget(target), mBatch(batch) {}
+
+    auto await_ready() const noexcept -> bool { // Already on the target, nothing to do
+        return &mCtxt->executor() == &mTarget;
+    }
+
+    ILIAS_API
+    auto await_suspend(CoroHandle caller) -> void;
+    auto await_resume() const noexcept -> void {}
+
+    auto setContext(CoroContext &ctxt) noexcept -> void {
+        mCtxt = &ctxt;
+    }
+private:
+    // Called in the target executor, resume the caller or enter the stopped state if stop requested during the hop
+    auto arrive() -> void;
+    static auto onArrive(void *self) -> void;
+
+    Executor    &mTarget;
+    SwitchBatch *mBatch = nullptr;
+    CoroContext *mCtxt = nullptr;
+    CoroHandle   mCaller;
+friend class SwitchBatch;
+};
+
+// MARK: SwitchBatch
+// Collect the coroutines switching to the same executor, and move them all by a single post
+class ILIAS_API SwitchBatch {
+public:
+    explicit SwitchBatch(Executor &target) : mTarget(target) {}
+    SwitchBatch(const SwitchBatch &) = delete;
+    ~SwitchBatch();
+
+    // Get the target executor of the batch
+    auto executor() const noexcept -> Executor & {
+        return mTarget;
+    }
+private:
+    // Add the awaiter into the pending list, post the drain if it is the first one (thread safe)
+    auto enqueue(SwitchAwaiter &awaiter) -> void;
+    static auto onDrain(void *self) -> void;
+
+    Executor                     &mTarget;
+    std::mutex                    mMutex;
+    std::vector<SwitchAwaiter *>  mPending; // Protected by mutex
+friend class SwitchAwaiter;
+};
+
+} // namespace task
+
+using task::SwitchBatch;
+
+namespace this_coro {
+
+/**
+ * @brief Move the current coroutine to the executor, the code after it runs on the executor (no-op on already there)
+ * @note The whole task (include the coroutines awaiting it) is moved, so the completion will also happen on the executor.
+ *       Switch back before return if the task is awaited on another thread (spawn, whenAll, whenAny ...)
+ * @note If the stop was requested, it will enter the stopped state instead of resuming
+ *
+ * @param executor The target executor (e.g. the IoContext in another thread)
+ * @return task::SwitchAwaiter
+ *
+ * @code
+ *  co_await this_coro::switchTo(shard);
+ *  auto n = co_await client.read(buffer); // On the shard thread
+ *  co_await this_coro::switchTo(home);
+ * @endcode
+ */
+[[nodiscard]]
+inline auto switchTo(runtime::Executor &executor) noexcept -> task::SwitchAwaiter {
+    return {executor};
+}
+
+/**
+ * @brief Move the current coroutine to the executor of the batch, all coroutines in the batch are moved by a single post
+ * @note The batch must outlive all the switches on it
+ *
+ * @param batch
+ * @return task::SwitchAwaiter
+ */
+[[nodiscard]]
+inline auto switchTo(task::SwitchBatch &batch) noexcept -> task::SwitchAwaiter {
+    return {batch.executor(), &batch};
+}
+
+} // namespace this_coro
+
+ILIAS_NS_END
@@ -252,10 +252,11 @@ public:
     TaskBlockingContext(const TaskBlockingContext &) = delete;
 
     auto enter() -> void {
+        auto &executor = this->executor(); // Get it before resume, the task may switch to another executor
         this->tracing().spawn(mSource); // TRACING: blocking wait is also spawn
         mTask.resume();
         if (!mTask.done()) {
-            executor().run(mStopExecutor.get_token());            
+            executor.run(mStopExecutor.get_token());            
         }
         ILIAS_ASSERT(mTask.done(), "??? INTERNAL BUG");
     }
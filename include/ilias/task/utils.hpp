@@ -43,8 +43,9 @@ public:
         }
         mCtxt.tracing().setParent(ctxt.tracing());
 #endif // defined(ILIAS_CORO_TRACE)
-        // We just need the executor info from the context
+        // We just need the executor info and the environment from the context
         mCtxt.setExecutor(ctxt.executor());
+        mCtxt.inherit(ctxt);
         mSource = sorce;
     }
 private:
@@ -102,15 +103,16 @@ public:
     ILIAS_API
     auto await_suspend(runtime::CoroHandle caller) -> void;
 
-    // TRACING: mark the await point is scheduleOn
-#if defined(ILIAS_CORO_TRACE)
     auto setContext(runtime::CoroContext &ctxt) {
+#if defined(ILIAS_CORO_TRACE)
+        // TRACING: mark the await point is scheduleOn
         if (auto frame = ctxt.tracing().topFrame(); frame) {
             frame->setMessage("scheduleOn");
         }
         this->tracing().setParent(ctxt.tracing());
-    }
 #endif // defined(ILIAS_CORO_TRACE)
+        this->inherit(ctxt); // Inherit the locals & priority from the caller
+    }
 
 protected:
     enum State : uint8_t {
@@ -165,6 +167,7 @@ public:
 #endif // defined(ILIAS_CORO_TRACE)
         mSource = source;
         mContext->setExecutor(ctxt.executor());
+        mContext->inherit(ctxt);
     }
 protected:
     // Virtual method ...
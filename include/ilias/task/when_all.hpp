@@ -78,6 +78,7 @@ public:
         for (auto &ctxt: mTasks) {
             ctxt.setUserdata(this);
             ctxt.setExecutor(mContext.executor());
+            ctxt.inherit(mContext);
             ctxt.setStoppedHandler(&onTaskCompleted);
             ctxt.task().setCompletionHandler(&onTaskCompleted);
 
@@ -91,6 +91,7 @@ public:
         for (auto &ctxt: mTasks) {
             ctxt.setUserdata(this);
             ctxt.setExecutor(mContext.executor());
+            ctxt.inherit(mContext);
             ctxt.setStoppedHandler(&onTaskCompleted);
             ctxt.task().setCompletionHandler(&onTaskCompleted);
 
@@ -134,6 +134,35 @@ async function fetchTasks() {
     catch (error) {
         console.error("Failed to fetch tasks:", error);
     }
+    fetchMetrics();
+}
+
+async function fetchMetrics() {
+    try {
+        // [
+        //     {
+        //         "name": "main",
+        //         "callbacks_per_tick": 1.5,
+        //         "poll_p99_us": 100,
+        //         "callback_p99_us": 10,
+        //         "queue_depth": [0, 1, 0],
+        //         ...
+        //     },
+        // ]
+        const response = await fetch('/api/metrics');
+        const data = await response.json();
+        document.getElementById('metrics').innerHTML = data.map(m =>
+            `<div>${escapeHtml(m.name)}: ` +
+            `ticks ${m.ticks} | cb/tick ${m.callbacks_per_tick} | ` +
+            `cb p50/p99/max ${m.callback_p50_us}/${m.callback_p99_us}/${m.callback_max_us} us | ` +
+            `poll p50/p99 ${m.poll_p50_us}/${m.poll_p99_us} us | ` +
+            `queue ${m.queue_depth.join('/')} | remote ${m.remote_posts} | ` +
+            `fds ${m.descriptors} | timers ${m.timers}</div>`
+        ).join('');
+    }
+    catch (error) {
+        console.error("Failed to fetch metrics:", error);
+    }
 }
 
 function escapeHtml(unsafe) {
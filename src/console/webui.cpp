@@ -8,6 +8,7 @@
 #include <ilias/io.hpp>
 
 #include <memory_resource>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
@@ -35,6 +36,33 @@ extern "C" {
 
 ILIAS_NS_BEGIN
 
+namespace {
+
+// Escape the string for the json string literal (quote, backslash and the control characters)
+auto jsonEscape(std::string_view str) -> std::string {
+    std::string ret;
+    ret.reserve(str.size());
+    for (auto ch : str) {
+        switch (ch) {
+            case '"': ret += "\\\""; break;
+            case '\\': ret += "\\\\"; break;
+            case '\n': ret += "\\n"; break;
+            case '\r': ret += "\\r"; break;
+            case '\t': ret += "\\t"; break;
+            default: {
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    fmtlib::format_to(std::back_inserter(ret), "\\u{:04x}", int(ch));
+                    break;
+                }
+                ret += ch;
+            }
+        }
+    }
+    return ret;
+}
+
+} // namespace
+
 // ═════════════════════════════════════════════════════════════════════
 // Implementation
 // ═════════════════════════════════════════════════════════════════════
@@ -70,6 +98,7 @@ struct TracingWebUi::Impl : public runtime::TracingSubscriber {
     auto snapshotJson() -> std::pmr::string;
     auto snapshotTask(std::pmr::string &out) -> void;
     auto snapshotStacktrace(intptr_t spanId) -> std::pmr::string;
+    auto snapshotMetrics() -> std::pmr::string;
 
     // ── HTTP server ─────────────────────────────────────────────────
     auto handleConnection(BufStream<TcpStream> stream) -> Task<void>;
@@ -82,6 +111,8 @@ struct TracingWebUi::Impl : public runtime::TracingSubscriber {
     WaitHandle<void>  mServeHandle;
     std::pmr::unsynchronized_pool_resource mPool;
     std::pmr::unordered_map<runtime::SpanId, TaskRecord> mIdMaps {&mPool}; // Mapping id to TaskRecord, used for snapshot
+    std::mutex        mContextsMutex;
+    std::vector<std::pair<std::string, IoContext *> > mContexts; // The contexts shown in the metrics panel, protected by mContextsMutex
 };
 
 TracingWebUi::Impl::Impl() {
@@ -193,6 +224,10 @@ auto TracingWebUi::Impl::handleRequest(BufStream<TcpStream> &stream, std::string
         auto json = snapshotJson();
         co_return co_await sendReply(stream, 200, "application/json; charset=utf-8", json);
     }
+    if (path == "/api/metrics") {
+        auto json = snapshotMetrics();
+        co_return co_await sendReply(stream, 200, "application/json; charset=utf-8", json);
+    }
     if (path.starts_with("/api/stacktrace/")) { // /api/stacktrace/<id>
         path.remove_prefix(16);
         intptr_t id = 0;
@@ -390,6 +425,67 @@ auto TracingWebUi::Impl::snapshotStacktrace(intptr_t id) -> std::pmr::string {
     return json;
 }
 
+auto TracingWebUi::Impl::snapshotMetrics() -> std::pmr::string {
+    // [
+    //     {
+    //         "name": "main",
+    //         "ticks": 100,
+    //         "callbacks": 1000,
+    //         ...
+    //         "queue_depth": [0, 1, 0] // High, Normal, Background
+    //     },
+    // ]
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::pmr::string json {&mPool};
+    std::lock_guard locker {mContextsMutex};
+    json += "[";
+    for (const auto &[name, ctxt] : mContexts) {
+        auto m = ctxt->metrics();
+        fmtlib::format_to(
+            std::back_inserter(json),
+            R"JSON({{
+                "name": "{}",
+                "ticks": {},
+                "callbacks": {},
+                "callbacks_per_tick": {:.2f},
+                "remote_posts": {},
+                "polls": {},
+                "poll_blocked_us": {},
+                "poll_p50_us": {},
+                "poll_p99_us": {},
+                "callback_p50_us": {},
+                "callback_p99_us": {},
+                "callback_max_us": {},
+                "descriptors": {},
+                "timers": {},
+                "queue_depth": [{}, {}, {}]
+            }},)JSON",
+            jsonEscape(name),
+            m.ticks,
+            m.callbacks,
+            m.callbacksPerTick(),
+            m.remotePosts,
+            m.polls,
+            duration_cast<microseconds>(m.pollBlocked).count(),
+            duration_cast<microseconds>(m.pollDuration.percentile(0.5)).count(),
+            duration_cast<microseconds>(m.pollDuration.percentile(0.99)).count(),
+            duration_cast<microseconds>(m.callbackDuration.percentile(0.5)).count(),
+            duration_cast<microseconds>(m.callbackDuration.percentile(0.99)).count(),
+            duration_cast<microseconds>(m.callbackDuration.max).count(),
+            m.descriptors,
+            m.timers,
+            m.queues[0].depth, m.queues[1].depth, m.queues[2].depth
+        );
+    }
+    if (!mContexts.empty()) {
+        json.pop_back(); // Remove trailing comma
+    }
+    json += "]";
+    return json;
+}
+
 // MARK: TracingWebUi
 TracingWebUi::TracingWebUi(std::string_view bind) : d(std::make_unique<Impl>()) {
     d->mBind.assign(bind);
@@ -402,6 +498,9 @@ auto TracingWebUi::install() -> bool {
     }
     if (!d->mServeHandle) {
         d->mServeHandle = spawn(d->serve());
+        if (auto ctxt = IoContext::currentThread(); ctxt) {
+            addContext("main", *ctxt);
+        }
     }
     ::fprintf(stderr, "[TracingWebUi] Web UI is available at %s\n", d->mBind.c_str());
     return true;
@@ -411,6 +510,11 @@ auto TracingWebUi::endpoint() const -> std::string_view {
     return d->mBind;
 }
 
+auto TracingWebUi::addContext(std::string_view name, IoContext &ctxt) -> void {
+    std::lock_guard locker {d->mContextsMutex};
+    d->mContexts.emplace_back(name, &ctxt);
+}
+
 ILIAS_NS_END
 
 #endif // ILIAS_TRACING_WEBUI
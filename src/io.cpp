@@ -1,12 +1,23 @@
 #include <ilias/io/system_error.hpp>
+#include <ilias/io/watchdog.hpp>
+#include <ilias/io/context.hpp>
 #include <ilias/io/duplex.hpp>
 #include <ilias/io/stream.hpp>
 #include <ilias/io/error.hpp>
+#include <ilias/io/ext.hpp>
+#include <ilias/net/msghdr.hpp>
+#include <ilias/log.hpp>
+#include <algorithm>
 #include <atomic>
 #include <array>
 #include <tuple>
 #include <mutex>
 
+#if defined(__linux__)
+    #include <unistd.h> // pipe2
+    #include <fcntl.h> // F_SETPIPE_SZ
+#endif // defined(__linux__)
+
 ILIAS_NS_BEGIN
 
 /**
@@ -246,6 +257,207 @@ auto SystemError::toIoError() const -> IoError {
     // clang-format on
 }
 
+// MARK: IoContext
+auto IoContext::metrics() const -> RuntimeMetrics {
+    auto metrics = RuntimeMetrics {};
+    for (size_t i = 0; i < runtime::PriorityCount; ++i) {
+        metrics.queues[i] = queueStats(static_cast<runtime::Priority>(i));
+    }
+    return metrics;
+}
+
+auto IoContext::sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    size_t sent = 0;
+    for (auto &msg : msgs) {
+        auto ret = co_await sendmsg(fd, msg.hdr, flags);
+        if (!ret) {
+            if (sent == 0) { // Report the error only if nothing is sent, like sendmmsg
+                co_return Err(ret.error());
+            }
+            break;
+        }
+        msg.len = *ret;
+        sent += 1;
+    }
+    co_return sent;
+}
+
+auto IoContext::recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    if (msgs.empty()) {
+        co_return 0;
+    }
+    ILIAS_CO_TRY(auto n, co_await recvmsg(fd, msgs[0].hdr, flags));
+    msgs[0].len = n;
+    co_return 1;
+}
+
+auto IoContext::spliceRead(IoDescriptor *, fd_t, size_t) -> IoTask<size_t> {
+    co_return Err(IoError::OperationNotSupported);
+}
+
+auto IoContext::spliceWrite(IoDescriptor *, fd_t, size_t) -> IoTask<size_t> {
+    co_return Err(IoError::OperationNotSupported);
+}
+
+auto IoContext::sendfile(IoDescriptor *, fd_t, uint64_t, size_t) -> IoTask<size_t> {
+    co_return Err(IoError::OperationNotSupported);
+}
+
+// MARK: SplicePipe
+#if defined(__linux__)
+SplicePipe::SplicePipe(SplicePipe &&other) noexcept : mReader(other.mReader), mWriter(other.mWriter) {
+    other.mOwned = false;
+}
+
+SplicePipe::~SplicePipe() {
+    if (!mOwned) {
+        return;
+    }
+    ::close(mReader);
+    ::close(mWriter);
+}
+
+auto SplicePipe::make() -> IoResult<SplicePipe> {
+    int fds[2];
+    if (::pipe2(fds, O_CLOEXEC) != 0) {
+        return Err(SystemError::fromErrno());
+    }
+    ::fcntl(fds[1], F_SETPIPE_SZ, int(Capacity)); // Best effort, it is limited by /proc/sys/fs/pipe-max-size
+    return SplicePipe {fds[0], fds[1]};
+}
+
+auto SplicePipe::isUnsupported(const std::error_code &ec) -> bool {
+    return ec == IoError::OperationNotSupported || ec == SystemError(EINVAL);
+}
+#else
+SplicePipe::SplicePipe(SplicePipe &&other) noexcept : mReader(other.mReader), mWriter(other.mWriter) {
+    other.mOwned = false;
+}
+
+SplicePipe::~SplicePipe() = default;
+
+auto SplicePipe::make() -> IoResult<SplicePipe> {
+    return Err(IoError::OperationNotSupported);
+}
+
+auto SplicePipe::isUnsupported(const std::error_code &) -> bool {
+    return true;
+}
+#endif // defined(__linux__)
+
+// MARK: Watchdog
+Watchdog::Watchdog(WatchdogOptions options) : mOptions(std::move(options)) {
+    mThread = std::thread([this]() { main(); });
+}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard locker {mMutex};
+        mQuit = true;
+    }
+    mCond.notify_one();
+    mThread.join();
+    for (auto &entry : mEntries) { // Cancel the pending capture
+        if (entry.stalled) {
+            entry.heartbeat->take(entry.stalled);
+        }
+    }
+}
+
+auto Watchdog::watch(IoContext &ctxt, std::string name) -> bool {
+    auto heartbeat = ctxt.heartbeat();
+    if (!heartbeat) {
+        return false;
+    }
+    std::lock_guard locker {mMutex};
+    mEntries.push_back(Entry {
+        .ctxt = &ctxt,
+        .heartbeat = heartbeat,
+        .name = std::move(name),
+    });
+    return true;
+}
+
+auto Watchdog::unwatch(IoContext &ctxt) -> void {
+    std::lock_guard locker {mMutex};
+    auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry &entry) { return entry.ctxt == &ctxt; });
+    if (it == mEntries.end()) {
+        return;
+    }
+    if (it->stalled) {
+        it->heartbeat->take(it->stalled);
+    }
+    mEntries.erase(it);
+}
+
+auto Watchdog::main() -> void {
+    auto interval = std::max<std::chrono::nanoseconds>(mOptions.threshold / 4, std::chrono::milliseconds(1));
+    std::unique_lock locker {mMutex};
+    while (!mCond.wait_for(locker, interval, [this]() { return mQuit; })) {
+        auto now = runtime::Heartbeat::Clock::now();
+        for (auto &entry : mEntries) {
+            check(entry, now);
+        }
+    }
+}
+
+auto Watchdog::check(Entry &entry, runtime::Heartbeat::Clock::time_point now) -> void {
+    auto heartbeat = entry.heartbeat;
+    if (entry.stalled) {
+        auto since = heartbeat->since();
+        if (since && heartbeat->sequence() == entry.stalled) { // Still stalled, already reported
+            return;
+        }
+        // The stalled callback returned, report it with the capture (if any)
+        auto capture = heartbeat->take(entry.stalled);
+        auto end = capture ? capture->when : now;
+        report({
+            .name = entry.name,
+            .duration = end - entry.since,
+            .finished = true,
+            .stacktrace = capture ? std::move(capture->stacktrace) : runtime::Stacktrace {},
+        });
+        entry.stalled = 0;
+    }
+
+    // Read the sequence twice, make sure the since belongs to it
+    auto sequence = heartbeat->sequence();
+    auto since = heartbeat->since();
+    if (!since || heartbeat->sequence() != sequence) {
+        return;
+    }
+    if (now - *since < mOptions.threshold) {
+        return;
+    }
+    entry.stalled = sequence;
+    entry.since = *since;
+    heartbeat->arm(sequence); // Ask the loop to capture the stacktrace of the one stalled it
+    mStalls.fetch_add(1, std::memory_order_relaxed);
+    report({
+        .name = entry.name,
+        .duration = now - *since,
+        .finished = false,
+        .stacktrace = {},
+    });
+}
+
+auto Watchdog::report(const StallReport &report) -> void {
+    if (mOptions.handler) {
+        mOptions.handler(report);
+        return;
+    }
+    [[maybe_unused]] auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(report.duration).count(); // Unused if the log is compiled out
+    if (!report.finished) {
+        ILIAS_WARN("Watchdog", "Loop {} is stalled by a callback for {}ms", report.name, ms);
+    }
+    else if (report.stacktrace.size() == 0) {
+        ILIAS_WARN("Watchdog", "Loop {} was stalled by a callback for {}ms", report.name, ms);
+    }
+    else {
+        ILIAS_WARN("Watchdog", "Loop {} was stalled by a callback for {}ms, in coroutine:\n{}", report.name, ms, report.stacktrace);
+    }
+}
+
 // MARK: DuplexStream
 
 struct ByteChannel {
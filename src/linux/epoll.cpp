@@ -9,6 +9,7 @@
 #include <ilias/net/msghdr.hpp>
 #include <ilias/net/sockfd.hpp>
 
+#include <sys/sendfile.h>
 #include <sys/timerfd.h>
 #include <sys/eventfd.h>
 #include <sys/epoll.h>
@@ -232,6 +233,10 @@ auto EpollContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<I
         ILIAS_WARN("Epoll", "Invalid file descriptor {}", fd);
         return Err(IoError::InvalidArgument);
     }
+    auto trusted = (type == IoDescriptor::Accepted); // By our accept4, the flags are already set
+    if (trusted) {
+        type = IoDescriptor::Socket;
+    }
     if (type == IoDescriptor::Unknown || type == IoDescriptor::Tty) { // If user give us a tty, it may redirect to something else, check it
         ILIAS_TRY(type, fd_utils::type(fd));
     }
@@ -252,10 +257,11 @@ auto EpollContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<I
             return Err(SystemError::fromErrno());
         }    
     }
-    if (::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK | O_CLOEXEC) == -1) {
+    if (!trusted && ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK | O_CLOEXEC) == -1) {
         ILIAS_WARN("Epoll", "Failed to set descriptor to non-blocking & clo-exec. error: {}", SystemError::fromErrno());
     }
     ILIAS_TRACE("Epoll", "Created new fd descriptor: {}, type: {}", fd, type);
+    mMetrics.onDescriptorAdded();
     return nfd.release();
 }
 
@@ -267,16 +273,21 @@ auto EpollContext::removeDescriptor(IoDescriptor *fd) -> IoResult<void> {
         }
     }
     delete nfd;
+    mMetrics.onDescriptorRemoved();
     return {};
 }
 
 auto EpollContext::post(void (*fn)(void *), void *args) -> void {
+    return postWithPriority(fn, args, runtime::Priority::Normal);
+}
+
+auto EpollContext::postWithPriority(void (*fn)(void *), void *args, runtime::Priority priority) -> void {
     ILIAS_TRACE("Epoll", "Post callback {} with args {}", reinterpret_cast<void*>(fn), args);
     ILIAS_ASSERT(fn, "Can't post nullptr callback");
 
     std::pair callback {fn, args};
     if (runtime::Executor::currentThread() == this) { // Same thread, just push to the queue
-        mCallbacks.emplace_back(callback);
+        mCallbacks.push(callback, priority);
         return;
     }
 
@@ -284,9 +295,10 @@ auto EpollContext::post(void (*fn)(void *), void *args) -> void {
     bool wakeup = false;
     {
         std::lock_guard locker {mMutex};
-        mPendingCallbacks.emplace_back(callback);
+        mPendingCallbacks.push(callback, priority);
         wakeup = !mWakePending.exchange(true, std::memory_order::relaxed); // There is no wakeup pending, need to set the eventfd
     }
+    mMetrics.onRemotePost();
     
     if (wakeup) {
         uint64_t data = 1; // Wakeup epoll
@@ -297,7 +309,26 @@ auto EpollContext::post(void (*fn)(void *), void *args) -> void {
     }
 }
 
+auto EpollContext::queueStats(runtime::Priority priority) const -> runtime::QueueStats {
+    auto stats = mCallbacks.stats(priority);
+    stats.depth += mPendingCallbacks.stats(priority).depth;
+    return stats;
+}
+
+auto EpollContext::metrics() const -> RuntimeMetrics {
+    auto metrics = mMetrics.snapshot();
+    for (size_t i = 0; i < runtime::PriorityCount; ++i) {
+        metrics.queues[i] = queueStats(static_cast<runtime::Priority>(i));
+    }
+    return metrics;
+}
+
+auto EpollContext::heartbeat() noexcept -> runtime::Heartbeat * {
+    return &mHeartbeat;
+}
+
 auto EpollContext::run(runtime::StopToken token) -> void {
+    auto scope = runtime::Heartbeat::Scope {mHeartbeat};
     auto running = true;
     auto cb = runtime::StopCallback(token, [&, this]() {
         schedule([&]() { running = false; });
@@ -314,12 +345,18 @@ auto EpollContext::sleep(std::chrono::nanoseconds ns) -> Task<void> {
 
 inline
 auto EpollContext::processCompletion(bool &running) -> void {
+    using Clock = runtime::MetricsRecorder::Clock;
+
+    mMetrics.onTick(mService.size());
     while (!mCallbacks.empty()) { // Process all callbacks in the current thread queue
-        auto cb = mCallbacks.front();
-        mCallbacks.pop_front();
+        auto cb = mCallbacks.pop();
+        auto begin = Clock::now(); // Right before the callback, the timers below are not part of it
+        mHeartbeat.beat(begin);
         cb.first(cb.second);
+        mMetrics.onCallback(Clock::now() - begin);
         mService.updateTimers(); // Update timers after each callback, TODO: Make an better way
     }
+    mHeartbeat.idle();
     // No callbacks available and non exit requested, process epoll events
     if (!running) {
         return;
@@ -329,7 +366,10 @@ auto EpollContext::processCompletion(bool &running) -> void {
     std::array<::epoll_event, 64> events;
     std::span view {events};
     // Wait forever until we got any events (callbacks, io, timer)
-    if (auto res = ::epoll_wait(mEpollFd.get(), view.data(), view.size(), -1); res > 0) { // Got any events
+    auto waitBegin = Clock::now();
+    auto res = ::epoll_wait(mEpollFd.get(), view.data(), view.size(), -1);
+    mMetrics.onPoll(Clock::now() - waitBegin);
+    if (res > 0) { // Got any events
         for (auto event : view.subspan(0, res)) {
             processEvent(event);
         }
@@ -340,13 +380,7 @@ inline
 auto EpollContext::pollCallbacks() -> void {
     std::lock_guard locker {mMutex};
     ILIAS_TRACE("Epoll", "Polling {} callbacks from different thread queue", mPendingCallbacks.size());
-    if (mCallbacks.empty()) { // Use swap to make it faster
-        mCallbacks.swap(mPendingCallbacks);
-    }
-    else {
-        mCallbacks.insert(mCallbacks.end(), mPendingCallbacks.begin(), mPendingCallbacks.end());
-        mPendingCallbacks.clear();
-    }
+    mCallbacks.splice(mPendingCallbacks);
 
     // Reset wakeup flag
     uint64_t data = 0; 
@@ -507,7 +541,7 @@ auto EpollContext::accept(IoDescriptor *fd, MutableEndpointView remoteEndpoint)
     auto nfd = static_cast<EpollDescriptor *>(fd);
     SocketView socket{nfd->fd};
     while (true) {
-        if (auto ret = socket.accept<socket_t>(remoteEndpoint); ret) {
+        if (auto ret = socket.accept<socket_t>(remoteEndpoint, SOCK_NONBLOCK | SOCK_CLOEXEC); ret) {
             co_return ret;
         }
         else if (auto err = ret.error(); err == SystemError(EINTR)) {
@@ -580,6 +614,100 @@ auto EpollContext::recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> I
     }
 }
 
+auto EpollContext::sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    auto nfd = static_cast<EpollDescriptor *>(fd);
+    if (msgs.empty()) { // The syscall returns 0, which would be taken as not ready
+        co_return 0;
+    }
+    auto vec = reinterpret_cast<::mmsghdr *>(msgs.data()); // Layout compatible, checked in msghdr.hpp
+    while (true) {
+        if (auto ret = ::sendmmsg(nfd->fd, vec, msgs.size(), flags | MSG_DONTWAIT | MSG_NOSIGNAL); ret > 0) {
+            co_return ret;
+        }
+        else if (auto err = errno; ret == -1 && (err != EINTR && err != EAGAIN && err != EWOULDBLOCK)) {
+            co_return Err(SystemError(err));
+        }
+        ILIAS_CO_TRYV(co_await poll(nfd, EPOLLOUT));
+    }
+}
+
+auto EpollContext::recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    auto nfd = static_cast<EpollDescriptor *>(fd);
+    if (msgs.empty()) { // The syscall returns 0, which would be taken as not ready
+        co_return 0;
+    }
+    auto vec = reinterpret_cast<::mmsghdr *>(msgs.data()); // Layout compatible, checked in msghdr.hpp
+    while (true) {
+        // Drain the datagrams already queued in one syscall, only wait when nothing is there
+        if (auto ret = ::recvmmsg(nfd->fd, vec, msgs.size(), flags | MSG_DONTWAIT | MSG_NOSIGNAL, nullptr); ret > 0) {
+            co_return ret;
+        }
+        else if (auto err = errno; ret == -1 && (err != EINTR && err != EAGAIN && err != EWOULDBLOCK)) {
+            co_return Err(SystemError::fromErrno());
+        }
+        ILIAS_CO_TRYV(co_await poll(nfd, EPOLLIN));
+    }
+}
+
+auto EpollContext::spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<EpollDescriptor *>(fd);
+    if (!nfd->pollable) {
+        co_return Err(IoError::OperationNotSupported);
+    }
+    while (true) {
+        // The caller drains the pipe before the next read, so EAGAIN means the descriptor is not ready
+        if (auto ret = ::splice(nfd->fd, nullptr, pipe, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK); ret >= 0) {
+            co_return ret;
+        }
+        else if (auto err = errno; err == EINTR) {
+            continue;
+        }
+        else if (err != EAGAIN && err != EWOULDBLOCK) {
+            co_return Err(SystemError(err));
+        }
+        ILIAS_CO_TRYV(co_await poll(nfd, EPOLLIN));
+    }
+}
+
+auto EpollContext::spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<EpollDescriptor *>(fd);
+    if (!nfd->pollable) {
+        co_return Err(IoError::OperationNotSupported);
+    }
+    while (true) {
+        if (auto ret = ::splice(pipe, nullptr, nfd->fd, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK); ret >= 0) {
+            co_return ret;
+        }
+        else if (auto err = errno; err == EINTR) {
+            continue;
+        }
+        else if (err != EAGAIN && err != EWOULDBLOCK) {
+            co_return Err(SystemError(err));
+        }
+        ILIAS_CO_TRYV(co_await poll(nfd, EPOLLOUT));
+    }
+}
+
+auto EpollContext::sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<EpollDescriptor *>(fd);
+    if (!nfd->pollable) {
+        co_return Err(IoError::OperationNotSupported);
+    }
+    while (true) {
+        auto off = ::off_t(offset);
+        if (auto ret = ::sendfile(nfd->fd, file, &off, len); ret >= 0) {
+            co_return ret;
+        }
+        else if (auto err = errno; err == EINTR) {
+            continue;
+        }
+        else if (err != EAGAIN && err != EWOULDBLOCK) {
+            co_return Err(SystemError(err));
+        }
+        ILIAS_CO_TRYV(co_await poll(nfd, EPOLLOUT));
+    }
+}
+
 // ----------------------------------------------------------------------------------------------------------------------
 /**
  * @brief wait a event for a descriptor
@@ -5,6 +5,7 @@
 #include <ilias/task/when_any.hpp>
 #include <ilias/task/task.hpp>
 #include <ilias/net/msghdr.hpp> // MsgHdr
+#include <ilias/io/ext.hpp> // SplicePipe
 #include <sys/eventfd.h>
 #include <sys/utsname.h>
 #include "uring_core.hpp"
@@ -61,7 +62,12 @@ UringContext::~UringContext() {
 
 auto UringContext::processCompletion() -> void {
     ::io_uring_cqe *cqe = nullptr;
-    if (::io_uring_wait_cqe(&mRing, &cqe) != 0 || cqe == nullptr) [[unlikely]] {
+    auto begin = runtime::MetricsRecorder::Clock::now();
+    auto ret = ::io_uring_wait_cqe(&mRing, &cqe);
+    auto end = runtime::MetricsRecorder::Clock::now();
+    mMetrics.onPoll(end - begin);
+    mHeartbeat.beat(end); // The completion may resume the coroutine directly
+    if (ret != 0 || cqe == nullptr) [[unlikely]] {
         ILIAS_ERROR("Uring", "io_uring_wait_cqe failed {}", SystemError(-errno));
         return;
     }
@@ -74,8 +80,7 @@ auto UringContext::processCompletion() -> void {
     }
     else { // Completion from the eventfd
         std::lock_guard locker {mMutex};
-        mCallbacks.insert(mCallbacks.end(), mPendingCallbacks.begin(), mPendingCallbacks.end());
-        mPendingCallbacks.clear();
+        mCallbacks.splice(mPendingCallbacks);
         uint64_t data = 0; // Reset wakeup flag
         if (::read(mEventFd, &data, sizeof(data)) != sizeof(data)) {
             // ? Why read failed?
@@ -95,16 +100,21 @@ auto UringContext::allocSqe() -> ::io_uring_sqe * {
 }
 
 auto UringContext::post(void (*fn)(void *), void *args) -> void {
+    return postWithPriority(fn, args, runtime::Priority::Normal);
+}
+
+auto UringContext::postWithPriority(void (*fn)(void *), void *args, runtime::Priority priority) -> void {
     auto cb = std::pair {fn, args};
     if (runtime::Executor::currentThread() == this) { // Same thread, just push to the queue
-        mCallbacks.emplace_back(cb);
+        mCallbacks.push(cb, priority);
         return;
     }
     // Different thread, push to the queue and wakeup the io uring
     {
         std::lock_guard locker {mMutex};
-        mPendingCallbacks.emplace_back(cb);
+        mPendingCallbacks.push(cb, priority);
     }
+    mMetrics.onRemotePost();
     uint64_t data = 1; // Wakeup
     if (::write(mEventFd, &data, sizeof(data)) != sizeof(data)) {
         // ? Why write failed?
@@ -112,7 +122,26 @@ auto UringContext::post(void (*fn)(void *), void *args) -> void {
     }
 }
 
+auto UringContext::queueStats(runtime::Priority priority) const -> runtime::QueueStats {
+    auto stats = mCallbacks.stats(priority);
+    stats.depth += mPendingCallbacks.stats(priority).depth;
+    return stats;
+}
+
+auto UringContext::metrics() const -> RuntimeMetrics {
+    auto metrics = mMetrics.snapshot();
+    for (size_t i = 0; i < runtime::PriorityCount; ++i) {
+        metrics.queues[i] = queueStats(static_cast<runtime::Priority>(i));
+    }
+    return metrics;
+}
+
+auto UringContext::heartbeat() noexcept -> runtime::Heartbeat * {
+    return &mHeartbeat;
+}
+
 auto UringContext::run(runtime::StopToken token) -> void {
+    auto scope = runtime::Heartbeat::Scope {mHeartbeat};
     auto reg = runtime::StopCallback(token, [this]() {
         // Alloc the noop sqe, let it wakeup the ring
         auto sqe = allocSqe();
@@ -122,14 +151,21 @@ auto UringContext::run(runtime::StopToken token) -> void {
     });
     while (!token.stop_requested()) {
         // Prcoess the callback queue
+        mMetrics.onTick();
+        auto begin = runtime::MetricsRecorder::Clock::now(); // Chain the timepoints, so only one clock read per callback
         while (!mCallbacks.empty()) {
-            auto cb = mCallbacks.front();
-            mCallbacks.pop_front();
+            auto cb = mCallbacks.pop();
+            mHeartbeat.beat(begin);
             cb.first(cb.second);
+            auto end = runtime::MetricsRecorder::Clock::now();
+            mMetrics.onCallback(end - begin);
+            begin = end;
         }
+        mHeartbeat.idle();
         ::io_uring_submit(&mRing); // Submit any pending requests
         if (!token.stop_requested()) {
             processCompletion();
+            mHeartbeat.idle();
         }
     }
 }
@@ -142,6 +178,7 @@ auto UringContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<I
     ILIAS_TRACE("Uring", "Adding fd {}", fd);
 
     nfd->fd = fd;
+    mMetrics.onDescriptorAdded();
     return nfd.release();
 }
 
@@ -149,6 +186,7 @@ auto UringContext::removeDescriptor(IoDescriptor *fd) -> IoResult<void> {
     auto nfd = static_cast<UringDescriptor*>(fd);
     ILIAS_TRACE("Uring", "Removing fd {}", nfd->fd);
     delete nfd;
+    mMetrics.onDescriptorRemoved();
     return {};
 }
 
@@ -219,6 +257,75 @@ auto UringContext::recvmsg(IoDescriptor *fd, MutableMsgHdr &msg, int flags) -> I
     co_return co_await UringRecvmsgAwaiter {mRing, nfd->fd, msg, flags};
 }
 
+auto UringContext::sendmmsg(IoDescriptor *fd, std::span<MMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    auto nfd = static_cast<UringDescriptor*>(fd);
+    auto vec = reinterpret_cast<::mmsghdr*>(msgs.data()); // Layout compatible, checked in msghdr.hpp
+    if (msgs.empty()) {
+        co_return 0;
+    }
+    // The socket buffer usually has room, send them all in one syscall, fallback to the sqe when it is full
+    if (auto ret = ::sendmmsg(nfd->fd, vec, msgs.size(), flags | MSG_DONTWAIT | MSG_NOSIGNAL); ret > 0) {
+        co_return ret;
+    }
+    else if (auto err = errno; ret == -1 && (err != EINTR && err != EAGAIN && err != EWOULDBLOCK)) {
+        co_return Err(SystemError(err));
+    }
+    ILIAS_CO_TRY(auto n, co_await UringSendmsgAwaiter {mRing, nfd->fd, msgs[0].hdr, flags});
+    msgs[0].len = n;
+    co_return 1;
+}
+
+auto UringContext::recvmmsg(IoDescriptor *fd, std::span<MutableMMsgHdr> msgs, int flags) -> IoTask<size_t> {
+    auto nfd = static_cast<UringDescriptor*>(fd);
+    if (msgs.empty()) {
+        co_return 0;
+    }
+    // Wait the first datagram by the sqe, then drain the queued ones in one syscall
+    ILIAS_CO_TRY(auto n, co_await UringRecvmsgAwaiter {mRing, nfd->fd, msgs[0].hdr, flags});
+    msgs[0].len = n;
+    auto rest = msgs.subspan(1);
+    if (rest.empty()) {
+        co_return 1;
+    }
+    auto ret = ::recvmmsg(nfd->fd, reinterpret_cast<::mmsghdr*>(rest.data()), rest.size(), flags | MSG_DONTWAIT, nullptr);
+    co_return 1 + (ret > 0 ? ret : 0); // The error (EAGAIN) of the rest is ignored, we already got one
+}
+
+auto UringContext::spliceRead(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<UringDescriptor*>(fd);
+    co_return co_await UringSpliceAwaiter {mRing, nfd->fd, -1, pipe, -1, len};
+}
+
+auto UringContext::spliceWrite(IoDescriptor *fd, fd_t pipe, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<UringDescriptor*>(fd);
+    co_return co_await UringSpliceAwaiter {mRing, pipe, -1, nfd->fd, -1, len};
+}
+
+auto UringContext::sendfile(IoDescriptor *fd, fd_t file, uint64_t offset, size_t len) -> IoTask<size_t> {
+    auto nfd = static_cast<UringDescriptor*>(fd);
+    if (mPipes.empty()) {
+        ILIAS_CO_TRY(auto pipe, SplicePipe::make());
+        mPipes.emplace_back(std::move(pipe));
+    }
+    // Take it out of the idle list, so the concurrent sendfile calls never share one
+    auto pipe = std::move(mPipes.back());
+    mPipes.pop_back();
+
+    // The file => pipe => socket, the pipe is drained before returning
+    ILIAS_CO_TRY(auto n, co_await UringSpliceAwaiter {mRing, file, int64_t(offset), pipe.writer(), -1, std::min(len, SplicePipe::Capacity)});
+    for (auto left = n; left > 0; ) {
+        ILIAS_CO_TRY(auto sent, co_await UringSpliceAwaiter {mRing, pipe.reader(), -1, nfd->fd, -1, left});
+        if (sent == 0) {
+            co_return Err(IoError::WriteZero);
+        }
+        left -= sent;
+    }
+    if (mPipes.size() < MaxIdlePipes) { // Drained, reuse it for the next chunk (dropped on error, it may still hold the data)
+        mPipes.emplace_back(std::move(pipe));
+    }
+    co_return n;
+}
+
 auto UringContext::poll(IoDescriptor *fd, uint32_t events) -> IoTask<uint32_t> {
     auto nfd = static_cast<UringDescriptor*>(fd);
     co_return co_await UringPollAwaiter {mRing, nfd->fd, events};
@@ -78,6 +78,37 @@ private:
     int       mFlags;
 };
 
+/**
+ * @brief Wrapping the splice, one of the fds must be a pipe
+ * 
+ */
+class UringSpliceAwaiter final : public UringAwaiter<UringSpliceAwaiter> {
+public:
+    UringSpliceAwaiter(::io_uring &ring, int in, int64_t inOffset, int out, int64_t outOffset, size_t len) :
+        UringAwaiter(ring), mIn(in), mOut(out), mInOffset(inOffset), mOutOffset(outOffset), mLen(len)
+    {
+
+    }
+
+    auto onSubmit() {
+        ILIAS_TRACE("Uring", "Prep splice from fd {} to fd {}", mIn, mOut);
+        ::io_uring_prep_splice(sqe(), mIn, mInOffset, mOut, mOutOffset, mLen, SPLICE_F_MOVE);
+    }
+
+    auto onComplete(int64_t ret) -> IoResult<size_t> {
+        if (ret < 0) {
+            return Err(SystemError(-ret));
+        }
+        return size_t(ret);
+    }
+private:
+    int     mIn;
+    int     mOut;
+    int64_t mInOffset; // -1 for the pipe or the current offset
+    int64_t mOutOffset;
+    size_t  mLen;
+};
+
 /**
  * @brief Wrapping the connect
  * 
@@ -121,7 +152,7 @@ public:
 
     auto onSubmit() {
         ILIAS_TRACE("Uring", "Prep accept for fd {}", mFd);
-        ::io_uring_prep_accept(sqe(), mFd, mAddr, &mLen, 0);
+        ::io_uring_prep_accept(sqe(), mFd, mAddr, &mLen, SOCK_CLOEXEC); // No blocking io on the ring, only the cloexec needed
     }
 
     auto onComplete(int64_t ret) -> IoResult<socket_t> {
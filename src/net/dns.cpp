@@ -0,0 +1,699 @@
+#include <ilias/net/addrinfo.hpp>
+#include <ilias/net/dns.hpp>
+#include <ilias/net/udp.hpp>
+#include <ilias/net/tcp.hpp>
+#include <ilias/sync/event.hpp>
+#include <ilias/task/when_all.hpp>
+#include <ilias/task/spawn.hpp>
+#include <ilias/task/utils.hpp> // timeout
+#include <ilias/io/ext.hpp> // readInt, writeInt
+#include <unordered_map>
+#include <algorithm> // std::find
+#include <charconv> // std::from_chars
+#include <fstream> // std::ifstream
+#include <random> // std::mt19937
+#include <cctype> // std::tolower
+#include <string>
+#include <array> // std::array
+#include <mutex> // std::mutex
+#include <list> // std::list
+
+ILIAS_NS_BEGIN
+
+// MARK: Message
+// The dns message (RFC 1035), only the parts used by the stub resolver
+namespace {
+
+enum : uint16_t {
+    TypeA    = 1,
+    TypeAAAA = 28,
+    TypeOpt  = 41,
+    ClassIn  = 1,
+};
+
+enum : uint16_t {
+    FlagResponse  = 0x8000,
+    FlagTruncated = 0x0200,
+    FlagRecursion = 0x0100,
+    RcodeMask     = 0x000F,
+};
+
+enum : uint16_t {
+    RcodeNoError  = 0,
+    RcodeNxDomain = 3,
+};
+
+constexpr size_t HeaderSize = 12;
+constexpr size_t UdpPayloadSize = 1232; // Advertised by EDNS(0), avoid the ip fragmentation
+
+struct DnsReply {
+    uint16_t                rcode = 0;
+    bool                    truncated = false;
+    std::vector<IPAddress>  addresses;
+    std::optional<uint32_t> ttl; // The min ttl of the records
+};
+
+auto putU16(std::vector<uint8_t> &buf, uint16_t value) -> void {
+    buf.push_back(uint8_t(value >> 8));
+    buf.push_back(uint8_t(value & 0xFF));
+}
+
+auto getU16(std::span<const uint8_t> buf, size_t pos) -> uint16_t {
+    return uint16_t((buf[pos] << 8) | buf[pos + 1]);
+}
+
+auto getU32(std::span<const uint8_t> buf, size_t pos) -> uint32_t {
+    return (uint32_t(getU16(buf, pos)) << 16) | getU16(buf, pos + 2);
+}
+
+// Encode the query, nullopt on the name can't be encoded
+auto encodeQuery(std::string_view name, uint16_t type, uint16_t id) -> std::optional<std::vector<uint8_t> > {
+    if (name.empty() || name.size() > 253) {
+        return std::nullopt;
+    }
+    auto buf = std::vector<uint8_t> {};
+    buf.reserve(HeaderSize + name.size() + 2 + 4 + 11);
+    putU16(buf, id);
+    putU16(buf, FlagRecursion);
+    putU16(buf, 1); // QDCOUNT
+    putU16(buf, 0); // ANCOUNT
+    putU16(buf, 0); // NSCOUNT
+    putU16(buf, 1); // ARCOUNT, the OPT record
+    while (!name.empty()) {
+        auto pos = name.find('.');
+        auto label = name.substr(0, pos);
+        if (label.empty() || label.size() > 63) {
+            return std::nullopt;
+        }
+        buf.push_back(uint8_t(label.size()));
+        buf.insert(buf.end(), label.begin(), label.end());
+        name = pos == std::string_view::npos ? std::string_view {} : name.substr(pos + 1);
+    }
+    buf.push_back(0);
+    putU16(buf, type);
+    putU16(buf, ClassIn);
+
+    // EDNS(0) OPT record, root name, the class is the udp payload size
+    buf.push_back(0);
+    putU16(buf, TypeOpt);
+    putU16(buf, UdpPayloadSize);
+    putU16(buf, 0);
+    putU16(buf, 0);
+    putU16(buf, 0);
+    return buf;
+}
+
+// Skip the (maybe compressed) name, false on malformed
+auto skipName(std::span<const uint8_t> buf, size_t &pos) -> bool {
+    while (pos < buf.size()) {
+        auto len = buf[pos];
+        if ((len & 0xC0) == 0xC0) { // The pointer ends the name
+            pos += 2;
+            return pos <= buf.size();
+        }
+        if (len & 0xC0) {
+            return false;
+        }
+        pos += 1 + len;
+        if (len == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Get the size of the question section of the query we encoded (one uncompressed name, type and class)
+auto questionSize(std::span<const uint8_t> query) -> size_t {
+    auto pos = size_t(HeaderSize);
+    while (query[pos] != 0) {
+        pos += 1 + query[pos];
+    }
+    return pos + 1 + 4 - HeaderSize;
+}
+
+// Decode the reply of the query, nullopt on malformed or not the reply of it (the id and the question must match, the name case-insensitively)
+auto decodeReply(std::span<const uint8_t> buf, std::span<const uint8_t> query) -> std::optional<DnsReply> {
+    if (buf.size() < HeaderSize || getU16(buf, 0) != getU16(query, 0)) {
+        return std::nullopt;
+    }
+    auto flags = getU16(buf, 2);
+    auto qdcount = getU16(buf, 4);
+    auto ancount = getU16(buf, 6);
+    if (!(flags & FlagResponse) || qdcount != 1) {
+        return std::nullopt;
+    }
+    // The question is echoed, the name is not compressed as it is the first one, so compare the bytes
+    auto question = query.subspan(HeaderSize, questionSize(query));
+    if (buf.size() < HeaderSize + question.size()) {
+        return std::nullopt;
+    }
+    auto echoed = buf.subspan(HeaderSize, question.size());
+    auto same = std::equal(question.begin(), question.end(), echoed.begin(), [](uint8_t a, uint8_t b) {
+        return std::tolower(a) == std::tolower(b); // The length bytes are < 64, never in the letters
+    });
+    if (!same) {
+        return std::nullopt;
+    }
+    auto type = getU16(question, question.size() - 4);
+    auto reply = DnsReply {
+        .rcode = uint16_t(flags & RcodeMask),
+        .truncated = bool(flags & FlagTruncated),
+        .addresses = {},
+        .ttl = std::nullopt,
+    };
+    if (reply.truncated) { // The rest is useless, query again by tcp
+        return reply;
+    }
+    auto pos = HeaderSize + question.size();
+    for (uint16_t i = 0; i < ancount; i++) { // The CNAME chain is followed by the recursive server, just pick the addresses
+        if (!skipName(buf, pos) || pos + 10 > buf.size()) {
+            return std::nullopt;
+        }
+        auto rtype = getU16(buf, pos);
+        auto rclass = getU16(buf, pos + 2);
+        auto ttl = getU32(buf, pos + 4);
+        auto rdlength = getU16(buf, pos + 8);
+        pos += 10;
+        if (pos + rdlength > buf.size()) {
+            return std::nullopt;
+        }
+        if (rclass == ClassIn && rtype == type && (rdlength == 4 || rdlength == 16)) {
+            if (auto addr = IPAddress::fromRaw(buf.data() + pos, rdlength); addr) {
+                reply.addresses.emplace_back(*addr);
+            }
+        }
+        reply.ttl = std::min(reply.ttl.value_or(ttl), ttl);
+        pos += rdlength;
+    }
+    return reply;
+}
+
+auto nextQueryId() -> uint16_t {
+    static thread_local auto engine = std::mt19937 {std::random_device {}()};
+    return uint16_t(engine());
+}
+
+auto toLower(std::string_view str) -> std::string {
+    auto out = std::string {str};
+    for (auto &ch : out) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return out;
+}
+
+auto readFile(const char *path) -> std::string {
+    auto stream = std::ifstream {path, std::ios::binary};
+    return std::string {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+// Split the line into the words, the comment (# or ;) is dropped
+auto splitWords(std::string_view line) -> std::vector<std::string_view> {
+    if (auto pos = line.find_first_of("#;"); pos != std::string_view::npos) {
+        line = line.substr(0, pos);
+    }
+    auto words = std::vector<std::string_view> {};
+    while (true) {
+        auto begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos) {
+            break;
+        }
+        line = line.substr(begin);
+        auto end = line.find_first_of(" \t\r");
+        words.emplace_back(line.substr(0, end));
+        if (end == std::string_view::npos) {
+            break;
+        }
+        line = line.substr(end);
+    }
+    return words;
+}
+
+template <typename Fn>
+auto forEachLine(std::string_view content, Fn fn) -> void {
+    while (!content.empty()) {
+        auto pos = content.find('\n');
+        fn(splitWords(content.substr(0, pos)));
+        content = pos == std::string_view::npos ? std::string_view {} : content.substr(pos + 1);
+    }
+}
+
+// Exchange the query with the server by udp, the replies not from the server or not matched are ignored
+auto exchangeUdp(IPEndpoint server, std::span<const uint8_t> query) -> IoTask<DnsReply> {
+    auto local = server.family() == AF_INET6 ? IPEndpoint(IPAddress6::any(), 0) : IPEndpoint(IPAddress4::any(), 0);
+    ILIAS_CO_TRY(auto sock, co_await UdpSocket::bind(local));
+    ILIAS_CO_TRYV(co_await sock.sendto(makeBuffer(query), server));
+    auto buf = std::array<uint8_t, UdpPayloadSize> {};
+    while (true) {
+        ILIAS_CO_TRY(auto res, co_await sock.recvfrom(makeBuffer(buf)));
+        auto [n, from] = res;
+        if (from != server) {
+            continue;
+        }
+        if (auto reply = decodeReply(std::span(buf).first(n), query); reply) {
+            co_return std::move(*reply);
+        }
+    }
+}
+
+// Exchange the query with the server by tcp, the message is prefixed by the 2 bytes length
+auto exchangeTcp(IPEndpoint server, std::span<const uint8_t> query) -> IoTask<DnsReply> {
+    ILIAS_CO_TRY(auto stream, co_await TcpStream::connect(server));
+    ILIAS_CO_TRYV(co_await io::writeInt<std::endian::big>(stream, uint16_t(query.size())));
+    ILIAS_CO_TRYV(co_await stream.writeAll(makeBuffer(query)));
+    ILIAS_CO_TRY(auto len, co_await io::readInt<std::endian::big, uint16_t>(stream));
+    auto buf = std::vector<uint8_t>(len);
+    ILIAS_CO_TRYV(co_await io::readAll(stream, makeBuffer(buf)));
+    auto reply = decodeReply(buf, query);
+    if (!reply || reply->truncated) {
+        co_return Err(GaiError::Fail);
+    }
+    co_return std::move(*reply);
+}
+
+} // namespace
+
+// MARK: Resolver
+DnsResolver::DnsResolver() : DnsResolver(systemConfig()) {}
+
+DnsResolver::DnsResolver(Config config) : mConfig(std::move(config)) {
+    if (mConfig.attempts == 0) {
+        mConfig.attempts = 1;
+    }
+}
+
+// Query one record type of the fully qualified name, over the nameservers in order, the empty answer is NODATA
+auto DnsResolver::query(std::string name, uint16_t type) const -> IoTask<DnsAnswer> {
+    auto id = nextQueryId();
+    auto message = encodeQuery(name, type, id);
+    if (!message) {
+        co_return Err(GaiError::NotFound);
+    }
+    for (size_t attempt = 0; attempt < mConfig.attempts; attempt++) {
+        for (const auto &server : mConfig.nameservers) {
+            auto reply = co_await timeout(exchangeUdp(server, *message), mConfig.timeout);
+            if (reply && *reply && (*reply)->truncated) { // Too large for udp, fall back to tcp
+                reply = co_await timeout(exchangeTcp(server, *message), mConfig.timeout);
+            }
+            if (!reply || !*reply) { // Timeout or the io error, try the next one
+                continue;
+            }
+            auto &res = **reply;
+            if (res.rcode == RcodeNxDomain) {
+                co_return Err(GaiError::NotFound);
+            }
+            if (res.rcode != RcodeNoError) { // SERVFAIL, REFUSED, ...
+                continue;
+            }
+            auto answer = DnsAnswer {.addresses = std::move(res.addresses), .ttl = std::nullopt};
+            if (res.ttl) {
+                answer.ttl = std::chrono::seconds(*res.ttl);
+            }
+            co_return answer;
+        }
+    }
+    co_return Err(GaiError::TryAgain); // No nameserver answered
+}
+
+// Query the name in the family, both the AAAA and A are sent at once for AF_UNSPEC
+auto DnsResolver::queryName(std::string name, int family) const -> IoTask<DnsAnswer> {
+    if (family == AF_INET || family == AF_INET6) {
+        co_return co_await query(std::move(name), family == AF_INET ? TypeA : TypeAAAA);
+    }
+    auto [v6, v4] = co_await whenAll(query(name, TypeAAAA), query(name, TypeA));
+    if (!v6 && !v4) {
+        co_return Err(v4.error());
+    }
+    if (!v6 || !v4) { // NXDOMAIN on one, believe it only if the other has nothing
+        auto &ok = v6 ? v6 : v4;
+        if (ok->addresses.empty()) {
+            co_return Err((v6 ? v4 : v6).error());
+        }
+        co_return std::move(*ok);
+    }
+    auto answer = std::move(*v6);
+    answer.addresses.insert(answer.addresses.end(), v4->addresses.begin(), v4->addresses.end());
+    if (v4->ttl) {
+        answer.ttl = std::min(answer.ttl.value_or(*v4->ttl), *v4->ttl);
+    }
+    co_return answer;
+}
+
+auto DnsResolver::resolve(std::string_view name, int family) const -> IoTask<DnsAnswer> {
+    if (auto addr = IPAddress::fromString(name); addr) {
+        if (family != AF_UNSPEC && addr->family() != family) {
+            co_return Err(GaiError::NotFound);
+        }
+        co_return DnsAnswer {.addresses = {*addr}, .ttl = std::nullopt};
+    }
+    auto absolute = name.ends_with('.');
+    auto host = toLower(absolute ? name.substr(0, name.size() - 1) : name);
+    if (auto it = mConfig.hosts.find(host); it != mConfig.hosts.end()) {
+        auto answer = DnsAnswer {};
+        for (const auto &addr : it->second) {
+            if (family == AF_UNSPEC || addr.family() == family) {
+                answer.addresses.emplace_back(addr);
+            }
+        }
+        if (!answer.addresses.empty()) {
+            co_return answer;
+        }
+    }
+
+    // The candidates by the search domains, like the resolver of libc
+    auto candidates = std::vector<std::string> {};
+    if (!absolute) {
+        auto dots = size_t(std::count(host.begin(), host.end(), '.'));
+        if (dots >= mConfig.ndots) {
+            candidates.emplace_back(host);
+        }
+        for (const auto &domain : mConfig.search) {
+            candidates.emplace_back(host + '.' + domain);
+        }
+        if (dots < mConfig.ndots) {
+            candidates.emplace_back(host);
+        }
+    }
+    else {
+        candidates.emplace_back(host);
+    }
+    for (auto &candidate : candidates) {
+        auto answer = co_await queryName(std::move(candidate), family);
+        if (answer && !answer->addresses.empty()) {
+            co_return answer;
+        }
+        if (!answer && answer.error() != GaiError::NotFound) { // The server failure, don't hide it by the next candidate
+            co_return Err(answer.error());
+        }
+    }
+    co_return Err(GaiError::NotFound);
+}
+
+auto DnsResolver::lookup(std::string_view name, uint16_t port, int family) const -> IoTask<std::vector<IPEndpoint> > {
+    ILIAS_CO_TRY(auto answer, co_await resolve(name, family));
+    auto endpoints = std::vector<IPEndpoint> {};
+    endpoints.reserve(answer.addresses.size());
+    for (const auto &addr : answer.addresses) {
+        endpoints.emplace_back(addr, port);
+    }
+    co_return endpoints;
+}
+
+auto DnsResolver::parseResolvConf(std::string_view content, Config &config) -> void {
+    forEachLine(content, [&](std::vector<std::string_view> words) {
+        if (words.size() < 2) {
+            return;
+        }
+        if (words[0] == "nameserver") {
+            if (auto addr = IPAddress::fromString(words[1]); addr) { // The scoped ipv6 (fe80::1%eth0) is not supported
+                config.nameservers.emplace_back(*addr, 53);
+            }
+        }
+        else if (words[0] == "search" || words[0] == "domain") { // The last one wins
+            config.search.clear();
+            for (auto domain : std::span(words).subspan(1)) {
+                config.search.emplace_back(toLower(domain.ends_with('.') ? domain.substr(0, domain.size() - 1) : domain));
+            }
+        }
+        else if (words[0] == "options") {
+            for (auto option : std::span(words).subspan(1)) {
+                auto sep = option.find(':');
+                if (sep == std::string_view::npos) {
+                    continue;
+                }
+                auto key = option.substr(0, sep);
+                auto value = size_t {};
+                auto str = option.substr(sep + 1);
+                if (std::from_chars(str.data(), str.data() + str.size(), value).ec != std::errc {}) {
+                    continue;
+                }
+                if (key == "ndots") {
+                    config.ndots = std::min<size_t>(value, 15);
+                }
+                else if (key == "timeout") {
+                    config.timeout = std::chrono::seconds(std::clamp<size_t>(value, 1, 30));
+                }
+                else if (key == "attempts") {
+                    config.attempts = std::clamp<size_t>(value, 1, 5);
+                }
+            }
+        }
+    });
+}
+
+auto DnsResolver::parseHosts(std::string_view content, Config &config) -> void {
+    forEachLine(content, [&](std::vector<std::string_view> words) {
+        if (words.size() < 2) {
+            return;
+        }
+        auto addr = IPAddress::fromString(words[0]);
+        if (!addr) {
+            return;
+        }
+        for (auto name : std::span(words).subspan(1)) {
+            auto &addresses = config.hosts[toLower(name)];
+            if (std::find(addresses.begin(), addresses.end(), *addr) == addresses.end()) {
+                addresses.emplace_back(*addr);
+            }
+        }
+    });
+}
+
+auto DnsResolver::systemConfig() -> Config {
+    auto config = Config {};
+
+#if defined(_WIN32)
+    parseHosts(readFile("C:\\Windows\\System32\\drivers\\etc\\hosts"), config);
+#else
+    parseResolvConf(readFile("/etc/resolv.conf"), config);
+    parseHosts(readFile("/etc/hosts"), config);
+#endif // defined(_WIN32)
+
+    if (config.nameservers.empty()) {
+        config.nameservers.emplace_back(IPAddress4::loopback(), 53);
+    }
+    return config;
+}
+
+// MARK: Cache
+using Clock = std::chrono::steady_clock;
+
+// The query in flight, the lookups of the same name wait on it
+struct DnsInflight {
+    Event                  done;
+    IoResult<DnsAnswer>    result {Err(GaiError::TryAgain)};
+};
+
+struct DnsEntry {
+    std::string             key;
+    std::vector<IPAddress>  addresses; // Empty on the cached failure
+    std::error_code         error;
+    Clock::time_point       expire;
+};
+
+struct DnsCache::Impl {
+    Config mConfig;
+
+    mutable std::mutex mMutex;
+    std::list<DnsEntry> mLru; // The most recently used at the front
+    std::unordered_map<std::string, std::list<DnsEntry>::iterator> mEntries;
+    std::unordered_map<std::string, std::shared_ptr<DnsInflight> > mInflight;
+    Stats mStats;
+
+    // Store the result of the query, must be called with the lock held
+    auto store(const std::string &key, const IoResult<DnsAnswer> &result) -> void;
+    auto erase(const std::string &key) -> void;
+
+    static auto query(std::shared_ptr<Impl> self, std::string key, std::string name, int family, std::shared_ptr<DnsInflight> inflight) -> Task<void>;
+};
+
+// The name is case insensitive, and the answers of each family are cached separately
+static auto makeKey(std::string_view name, int family) -> std::string {
+    auto key = toLower(name);
+    if (!key.empty() && key.back() == '.') { // The fully qualified name is the same one
+        key.pop_back();
+    }
+    key.push_back('/');
+    key += std::to_string(family);
+    return key;
+}
+
+// Only cache the failures saying the name doesn't exist, the temporary ones (TryAgain, system error) are retried at next lookup
+static auto isNegative(std::error_code ec) -> bool {
+
+#if defined(EAI_NODATA)
+    if (ec == GaiError(EAI_NODATA)) {
+        return true;
+    }
+#endif
+
+    return ec == GaiError::NotFound;
+}
+
+static auto defaultResolver(std::string_view name, int family) -> IoTask<DnsAnswer> {
+    auto hints = addrinfo_t {};
+    hints.ai_family = family;
+    hints.ai_socktype = SOCK_STREAM; // Only one entry per address
+    auto info = co_await AddressInfo::fromHostname(name, {}, hints);
+    if (!info) {
+        co_return Err(info.error());
+    }
+    auto answer = DnsAnswer {};
+    for (const auto &endpoint : info->endpoints()) {
+        auto addr = endpoint.address();
+        if (std::find(answer.addresses.begin(), answer.addresses.end(), addr) == answer.addresses.end()) {
+            answer.addresses.emplace_back(addr);
+        }
+    }
+    co_return answer; // getaddrinfo doesn't report the ttl, use the configured one
+}
+
+auto DnsCache::Impl::store(const std::string &key, const IoResult<DnsAnswer> &result) -> void {
+    auto entry = DnsEntry {.key = key, .addresses = {}, .error = {}, .expire = {}};
+    auto now = Clock::now();
+    if (result && !result->addresses.empty()) {
+        auto ttl = std::min(result->ttl.value_or(mConfig.ttl), mConfig.maxTtl);
+        if (ttl <= std::chrono::nanoseconds::zero()) {
+            return;
+        }
+        entry.addresses = result->addresses;
+        entry.expire = now + ttl;
+    }
+    else {
+        auto ec = result ? std::error_code(GaiError::NotFound) : result.error();
+        if (!isNegative(ec) || mConfig.negativeTtl <= std::chrono::nanoseconds::zero()) {
+            return;
+        }
+        entry.error = ec;
+        entry.expire = now + mConfig.negativeTtl;
+    }
+    erase(key);
+    mLru.emplace_front(std::move(entry));
+    mEntries.emplace(key, mLru.begin());
+    while (mLru.size() > mConfig.capacity) { // Evict the least recently used
+        mEntries.erase(mLru.back().key);
+        mLru.pop_back();
+    }
+}
+
+auto DnsCache::Impl::erase(const std::string &key) -> void {
+    if (auto it = mEntries.find(key); it != mEntries.end()) {
+        mLru.erase(it->second);
+        mEntries.erase(it);
+    }
+}
+
+// Run detached, so the query is finished even if the lookup started it is cancelled, the others are still waiting for it
+auto DnsCache::Impl::query(std::shared_ptr<Impl> self, std::string key, std::string name, int family, std::shared_ptr<DnsInflight> inflight) -> Task<void> {
+    auto result = co_await self->mConfig.resolver(name, family);
+    {
+        std::lock_guard locker {self->mMutex};
+        self->store(key, result);
+        self->mInflight.erase(key);
+    }
+    inflight->result = std::move(result);
+    inflight->done.set();
+}
+
+DnsCache::DnsCache(Config config) : d(std::make_shared<Impl>()) {
+    if (!config.resolver) {
+        config.resolver = defaultResolver;
+    }
+    if (config.capacity == 0) {
+        config.capacity = 1;
+    }
+    d->mConfig = std::move(config);
+}
+
+DnsCache::DnsCache() : DnsCache(Config {}) {}
+
+DnsCache::~DnsCache() = default;
+
+auto DnsCache::resolve(std::string_view name, int family) -> IoTask<std::vector<IPAddress> > {
+    if (auto addr = IPAddress::fromString(name); addr) { // The ip literal, no query
+        if (family != AF_UNSPEC && addr->family() != family) {
+            co_return Err(GaiError::NotFound);
+        }
+        co_return std::vector {*addr};
+    }
+
+    auto key = makeKey(name, family);
+    auto inflight = std::shared_ptr<DnsInflight> {};
+    auto leader = false;
+    {
+        std::lock_guard locker {d->mMutex};
+        if (auto it = d->mEntries.find(key); it != d->mEntries.end()) {
+            if (Clock::now() < it->second->expire) { // Hit, move it to the front
+                d->mLru.splice(d->mLru.begin(), d->mLru, it->second);
+                d->mStats.hits += 1;
+                if (it->second->error) {
+                    co_return Err(it->second->error);
+                }
+                co_return it->second->addresses;
+            }
+            d->erase(key); // Expired
+        }
+        if (auto it = d->mInflight.find(key); it != d->mInflight.end()) { // Join the query in flight
+            inflight = it->second;
+            d->mStats.coalesced += 1;
+        }
+        else {
+            inflight = std::make_shared<DnsInflight>();
+            d->mInflight.emplace(key, inflight);
+            d->mStats.misses += 1;
+            leader = true;
+        }
+    }
+    if (leader) {
+        auto _ = spawn(Impl::query(d, key, std::string {name}, family, inflight)); // Detach it
+    }
+    co_await inflight->done;
+
+    auto &result = inflight->result;
+    if (!result) {
+        co_return Err(result.error());
+    }
+    if (result->addresses.empty()) {
+        co_return Err(GaiError::NotFound);
+    }
+    co_return result->addresses;
+}
+
+auto DnsCache::lookup(std::string_view name, uint16_t port, int family) -> IoTask<std::vector<IPEndpoint> > {
+    auto addresses = co_await resolve(name, family);
+    if (!addresses) {
+        co_return Err(addresses.error());
+    }
+    auto endpoints = std::vector<IPEndpoint> {};
+    endpoints.reserve(addresses->size());
+    for (const auto &addr : *addresses) {
+        endpoints.emplace_back(addr, port);
+    }
+    co_return endpoints;
+}
+
+auto DnsCache::invalidate(std::string_view name) -> void {
+    std::lock_guard locker {d->mMutex};
+    for (auto family : {AF_UNSPEC, AF_INET, AF_INET6}) {
+        d->erase(makeKey(name, family));
+    }
+}
+
+auto DnsCache::clear() -> void {
+    std::lock_guard locker {d->mMutex};
+    d->mEntries.clear();
+    d->mLru.clear();
+}
+
+auto DnsCache::stats() const -> Stats {
+    std::lock_guard locker {d->mMutex};
+    auto stats = d->mStats;
+    stats.size = d->mLru.size();
+    return stats;
+}
+
+auto DnsCache::global() -> DnsCache & {
+    static DnsCache cache;
+    return cache;
+}
+
+ILIAS_NS_END
@@ -1,11 +1,14 @@
 #include <ilias/runtime/executor.hpp>
+#include <ilias/runtime/metrics.hpp>
 #include <ilias/runtime/tracing.hpp>
 #include <ilias/runtime/timer.hpp>
+#include <ilias/runtime/queue.hpp>
 #include <ilias/runtime/coro.hpp>
 #include <ilias/task/task.hpp>
 #include <condition_variable> // std::condition_variable
 #include <memory_resource> // std::pmr::memory_resource
 #include <system_error> // std::system_error
+#include <atomic> // std::atomic
 #include <thread> // std::thread
 #include <queue> // std::queue
 #include <mutex> // std::mutex
@@ -47,12 +50,18 @@ auto Executor::uninstall() -> void {
     }
 }
 
+auto Executor::postWithPriority(void (*fn)(void *), void *args, Priority) -> void {
+    return post(fn, args);
+}
+
+auto Executor::queueStats(Priority) const -> QueueStats {
+    return {};
+}
+
 // EventLoop
 struct EventLoop::Impl {
-    using Callback = std::pair<void (*)(void *), void *>;
-
-    std::queue<Callback> localQueue;
-    std::queue<Callback> sharedQueue; // The queue shared between threads, protected by mutex
+    ReadyQueue localQueue;
+    ReadyQueue sharedQueue; // The queue shared between threads, protected by mutex
     std::condition_variable cond;
     std::mutex mutex;
     TimerService service;
@@ -62,17 +71,27 @@ EventLoop::EventLoop() : d(std::make_unique<Impl>()) {}
 EventLoop::~EventLoop() = default;
 
 auto EventLoop::post(void (*fn)(void *), void *args) -> void {
+    return postWithPriority(fn, args, Priority::Normal);
+}
+
+auto EventLoop::postWithPriority(void (*fn)(void *), void *args, Priority priority) -> void {
     if (Executor::currentThread() == this) {
-        d->localQueue.emplace(fn, args);
+        d->localQueue.push({fn, args}, priority);
         return;
     }
     {
         std::lock_guard locker {d->mutex};
-        d->sharedQueue.emplace(fn, args);
+        d->sharedQueue.push({fn, args}, priority);
     }
     d->cond.notify_one();
 }
 
+auto EventLoop::queueStats(Priority priority) const -> QueueStats {
+    auto stats = d->localQueue.stats(priority);
+    stats.depth += d->sharedQueue.stats(priority).depth;
+    return stats;
+}
+
 auto EventLoop::run(StopToken token) -> void {
     auto callback = runtime::StopCallback(token, [&]() {
         d->cond.notify_one();
@@ -83,8 +102,7 @@ auto EventLoop::run(StopToken token) -> void {
     while (true) {
         // First process local queue
         while (!d->localQueue.empty()) {
-            auto fn = d->localQueue.front();
-            d->localQueue.pop();
+            auto fn = d->localQueue.pop();
             fn.first(fn.second);
         }
 
@@ -98,7 +116,7 @@ auto EventLoop::run(StopToken token) -> void {
         }
 
         ILIAS_ASSERT(d->localQueue.empty(), "Local queue should be empty after processing");
-        d->localQueue.swap(d->sharedQueue); // Collect all callbacks from shared queue
+        d->localQueue.splice(d->sharedQueue); // Collect all callbacks from shared queue
         if (d->localQueue.empty() && token.stop_requested()) { // Only quit after process all avaliable callbacks
             return;
         }
@@ -193,6 +211,36 @@ auto threadpool::submit(CallableRef &callable) -> void {
 }
 
 // CoroContext
+namespace {
+    thread_local constinit Heartbeat   *gHeartbeat {};
+    constinit std::atomic<size_t> gLocalSlots {0};
+}
+
+#if defined(_WIN32) && defined(ILIAS_DLL)
+auto CoroContext::runningSlot() noexcept -> CoroContext *& {
+    static thread_local constinit CoroContext *running = nullptr;
+    return running;
+}
+#endif // defined(_WIN32) && defined(ILIAS_DLL)
+
+auto CoroContext::captureHeartbeat() noexcept -> void {
+    if (auto heartbeat = gHeartbeat; heartbeat && heartbeat->wanted()) [[unlikely]] {
+        heartbeat->capture(mTraceContext.stacktrace());
+    }
+}
+
+auto Heartbeat::current() noexcept -> Heartbeat * {
+    return gHeartbeat;
+}
+
+auto Heartbeat::setCurrent(Heartbeat *heartbeat) noexcept -> Heartbeat * {
+    return std::exchange(gHeartbeat, heartbeat);
+}
+
+auto LocalStorage::allocateSlot() noexcept -> size_t {
+    return gLocalSlots.fetch_add(1, std::memory_order_relaxed);
+}
+
 auto CoroContext::stop() noexcept -> bool {
     return mStopSource.request_stop();
 }
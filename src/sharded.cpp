@@ -0,0 +1,198 @@
+#include <ilias/platform.hpp> // PlatformContext
+#include <ilias/sharded.hpp>
+#include <ilias/log.hpp>
+#include <algorithm> // std::max
+#include <utility> // std::exchange
+#include <string> // std::to_string
+
+#if defined(_WIN32)
+    #include <ilias/detail/win32defs.hpp>
+#else
+    #include <pthread.h> // pthread_setaffinity_np
+    #include <sched.h> // cpu_set_t
+#endif // _WIN32
+
+ILIAS_NS_BEGIN
+
+namespace {
+
+// Pin the current thread to the cpu, just warn on failure, it is only an optimization
+auto pinCurrentThread(int cpu) -> void {
+
+#if defined(_WIN32)
+    // Find the processor group of the cpu, each group has at most 64 cpus
+    auto affinity = ::GROUP_AFFINITY {};
+    auto index = cpu;
+    for (WORD group = 0; group < ::GetActiveProcessorGroupCount(); ++group) {
+        auto count = int(::GetActiveProcessorCount(group));
+        if (index < count) {
+            affinity.Group = group;
+            affinity.Mask = KAFFINITY(1) << index;
+            break;
+        }
+        index -= count;
+    }
+    if (affinity.Mask == 0) {
+        ILIAS_WARN("Sharded", "Failed to pin the shard to cpu {}: no such cpu", cpu);
+        return;
+    }
+    if (!::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr)) {
+        ILIAS_WARN("Sharded", "Failed to pin the shard to cpu {}: {}", cpu, SystemError::fromErrno());
+    }
+#else
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto err = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); err != 0) {
+        ILIAS_WARN("Sharded", "Failed to pin the shard to cpu {}: {}", cpu, SystemError(err));
+    }
+#endif // _WIN32
+
+}
+
+} // namespace
+
+// MARK: ShardedRuntime
+ShardedRuntime::ShardedRuntime(ShardedOptions options) : mOptions(options) {
+    auto cpus = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    auto count = mOptions.shards ? mOptions.shards : cpus;
+    mShards.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto cpu = mOptions.pinCpu ? int(i % cpus) : -1;
+        mShards.emplace_back(new Shard {*this, i, cpu});
+    }
+}
+
+ShardedRuntime::~ShardedRuntime() {
+    stop();
+    for (auto &shard : mShards) {
+        if (shard->mThread.joinable()) {
+            shard->mThread.join();
+        }
+    }
+}
+
+auto ShardedRuntime::start(Factory factory) -> void {
+    ILIAS_ASSERT(factory, "The factory must not be empty");
+    mFactory = std::move(factory);
+    mBindOrder.clear();
+    for (auto &shard : mShards) {
+        ILIAS_ASSERT(!shard->mThread.joinable(), "The runtime is already started");
+        shard->mThread = std::thread([this, shard = shard.get()]() {
+            main(*shard);
+        });
+    }
+}
+
+auto ShardedRuntime::blockingJoin() -> void {
+    for (auto &shard : mShards) {
+        if (shard->mThread.joinable()) {
+            shard->mThread.join();
+        }
+    }
+    mStopRequested = false; // All shards are done, so the runtime can be started again
+    for (auto &shard : mShards) {
+        auto exception = std::exchange(shard->mException, nullptr);
+        exception.rethrowIfAny();
+    }
+}
+
+auto ShardedRuntime::stop() -> void {
+    std::lock_guard locker {mMutex};
+    mStopRequested = true;
+    for (auto &shard : mShards) {
+        if (!shard->mContext) { // Not started or already done, the shard will check the mStopRequested on start
+            continue;
+        }
+        shard->mContext->schedule([shard = shard.get()]() { // The handle is only touched in the shard thread
+            if (shard->mHandle) {
+                shard->mHandle.stop();
+            }
+        });
+    }
+}
+
+auto ShardedRuntime::main(Shard &shard) -> void { // In the shard thread
+    if (shard.mCpu >= 0) {
+        pinCurrentThread(shard.mCpu);
+    }
+
+#if !defined(_WIN32)
+    auto name = "shard-" + std::to_string(shard.mIndex);
+    ::pthread_setname_np(::pthread_self(), name.c_str());
+#endif // _WIN32
+
+    auto context = PlatformContext {};
+    context.install();
+    ILIAS_TRY_EXCEPTION {
+        auto handle = spawn(mFactory(shard));
+        {
+            std::lock_guard locker {mMutex};
+            shard.mContext = &context;
+            shard.mHandle = handle.stopHandle();
+            if (mStopRequested) { // Stop requested before we started
+                shard.mHandle.stop();
+            }
+        }
+        handle.wait();
+    }
+    ILIAS_CATCH (...) {
+        shard.mException = runtime::ExceptionPtr::currentException();
+    }
+
+    std::lock_guard locker {mMutex};
+    shard.mContext = nullptr;
+    shard.mHandle = StopHandle {};
+}
+
+auto ShardedRuntime::bindReusePort(Shard &shard, IPEndpoint endpoint, int backlog) -> IoResult<Socket> {
+    ILIAS_TRY(auto sockfd, Socket::make(endpoint.family(), SOCK_STREAM, IPPROTO_TCP));
+    ILIAS_TRYV(sockfd.setOption(sockopt::ReuseAddress(true)));
+#if defined(SO_REUSEPORT)
+    ILIAS_TRYV(sockfd.setOption(sockopt::ReusePort(true)));
+#endif // defined(SO_REUSEPORT)
+
+    // Hold the lock, so the order of the reuseport group is as same as mBindOrder
+    std::lock_guard locker {mMutex};
+    ILIAS_TRYV(sockfd.bind(endpoint));
+    ILIAS_TRYV(sockfd.listen(backlog));
+
+    // Each endpoint is a group of its own, keyed by the bound one (the port 0 is resolved by the bind)
+    ILIAS_TRY(auto bound, sockfd.localEndpoint<IPEndpoint>());
+    auto &order = mBindOrder[bound];
+    if (std::find(order.begin(), order.end(), shard.mIndex) != order.end()) { // The index of the program is one socket per shard
+        ILIAS_WARN("Sharded", "The shard {} already bound {}", shard.mIndex, bound);
+        return Err(SystemError::AddressInUse);
+    }
+    order.push_back(shard.mIndex);
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    if (mOptions.cpuSteering && order.size() == mShards.size()) { // All shards joined the group, attach the program to it
+        // A = cpu; if (A == cpu of the k-th socket) return k; ... return A % N;
+        auto code = std::vector<::sock_filter> {};
+        code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, uint32_t(SKF_AD_OFF + SKF_AD_CPU)));
+        for (size_t k = 0; k < order.size(); ++k) {
+            auto cpu = mShards[order[k]]->mCpu;
+            if (cpu < 0) {
+                continue;
+            }
+            code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(cpu), 0, 1));
+            code.push_back(BPF_STMT(BPF_RET | BPF_K, uint32_t(k)));
+        }
+        code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, uint32_t(order.size())));
+        code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+        auto prog = ::sock_fprog {
+            .len = static_cast<unsigned short>(code.size()),
+            .filter = code.data(),
+        };
+        if (auto res = sockfd.setOption(sockopt::AttachReusePortCBPF(prog)); !res) {
+            ILIAS_WARN("Sharded", "Failed to attach the cpu steering program: {}", res.error());
+        }
+    }
+#endif // defined(SO_ATTACH_REUSEPORT_CBPF)
+
+    return sockfd;
+}
+
+ILIAS_NS_END
@@ -22,11 +22,15 @@ WaitQueue::~WaitQueue() {
 }
 
 auto WaitQueue::wakeupOne() -> void {
+    if (!hasParked()) { // Fast path, no one to wake, don't touch the lock
+        return;
+    }
     std::unique_lock locker {*this};
     for (auto it = mWaiters.begin(); it != mWaiters.end(); ++it) {
         auto &waiter = *it;
         if (waiter.onWakeupRaw()) { // Got one
             mWaiters.erase(it);
+            mParked.fetch_sub(1, std::memory_order_relaxed);
             locker.unlock();
 
             // Schedule the waiter
@@ -37,6 +41,9 @@ auto WaitQueue::wakeupOne() -> void {
 }
 
 auto WaitQueue::wakeupAll() -> void {
+    if (!hasParked()) {
+        return;
+    }
     intrusive::List<WaiterBase> ready {};
     {
         std::lock_guard locker {*this};
@@ -44,6 +51,7 @@ auto WaitQueue::wakeupAll() -> void {
             auto &waiter = *it;
             if (waiter.onWakeupRaw()) {
                 it = mWaiters.erase(it); // Move to next
+                mParked.fetch_sub(1, std::memory_order_relaxed);
                 ready.push_back(waiter); // Add to the ready list
             }
             else {
@@ -60,6 +68,89 @@ auto WaitQueue::wakeupAll() -> void {
     }
 }
 
+auto WaitQueue::wakeupInOrder() -> void {
+    if (!hasParked()) {
+        return;
+    }
+    intrusive::List<WaiterBase> ready {};
+    {
+        std::lock_guard locker {*this};
+        while (!mWaiters.empty()) {
+            auto &waiter = mWaiters.front();
+            if (!waiter.onWakeupRaw()) { // The head can't go, the rest must wait behind it
+                break;
+            }
+            mWaiters.pop_front();
+            mParked.fetch_sub(1, std::memory_order_relaxed);
+            ready.push_back(waiter);
+        }
+    }
+    while (!ready.empty()) {
+        auto &waiter = ready.front();
+        ready.pop_front();
+        waiter.resume();
+    }
+}
+
+auto WaitQueue::wakeupHead() -> void {
+    if (!hasParked()) {
+        return;
+    }
+    std::unique_lock locker {*this};
+    if (mWaiters.empty()) {
+        return;
+    }
+    auto &waiter = mWaiters.front();
+    if (!waiter.onWakeupRaw()) { // Barged by the newcomer, it will wake the head on release
+        return;
+    }
+    mWaiters.pop_front();
+    mParked.fetch_sub(1, std::memory_order_relaxed);
+    locker.unlock();
+
+    waiter.resume();
+}
+
+auto WaitQueue::handoffOne() -> bool {
+    if (!hasParked()) {
+        return false;
+    }
+    std::unique_lock locker {*this};
+    if (mWaiters.empty()) { // Someone is going to park, it will check the predicate by itself
+        return false;
+    }
+    auto &waiter = mWaiters.front();
+    mWaiters.pop_front();
+    mParked.fetch_sub(1, std::memory_order_relaxed);
+    std::atomic_ref {waiter.mWaiting}.store(false); // Wakeup win, the stop request will see it is unlinked
+    locker.unlock();
+
+    waiter.resume();
+    return true;
+}
+
+auto WaitQueue::handoffAll() -> void {
+    if (!hasParked()) {
+        return;
+    }
+    intrusive::List<WaiterBase> ready {};
+    {
+        std::lock_guard locker {*this};
+        while (!mWaiters.empty()) {
+            auto &waiter = mWaiters.front();
+            mWaiters.pop_front();
+            mParked.fetch_sub(1, std::memory_order_relaxed);
+            std::atomic_ref {waiter.mWaiting}.store(false);
+            ready.push_back(waiter);
+        }
+    }
+    while (!ready.empty()) {
+        auto &waiter = ready.front();
+        ready.pop_front();
+        waiter.resume();
+    }
+}
+
 auto WaitQueue::lock() -> void {
     mMutex.lock();
 }
@@ -95,10 +186,9 @@ auto AwaiterBase::await_suspend(runtime::CoroHandle caller) -> bool {
     mCaller = caller;
     {
         std::lock_guard locker {mQueue};
-        if (mOnWakeup(*this)) { // Check condition
+        if (!mQueue.park(*this)) { // Check condition, adding self to the queue's last position if not satisfied
             return false; // Condition is true, don't wait
         }
-        mQueue.mWaiters.push_back(*this); // Adding self to the queue's last position
     }
 
     // Enter race now.
@@ -118,6 +208,7 @@ auto AwaiterBase::onStopRequested() -> void {
             return;
         }
         unlink(); // Stop request win!
+        mQueue.mParked.fetch_sub(1, std::memory_order_relaxed);
         ref.store(false);
     }
     mCaller.setStopped();
@@ -12,7 +12,7 @@ ILIAS_NS_BEGIN
 using namespace task;
 
 // MARK: TaskSpawn
-TaskSpawnContextBase::TaskSpawnContextBase(TaskHandle<> task, CaptureSource source) : TaskContext(task) {
+TaskSpawnContextBase::TaskSpawnContextBase(TaskHandle<> task, CaptureSource source, SpawnOptions options) : TaskContext(task) {
     auto executor = runtime::Executor::currentThread();
     ILIAS_ASSERT(executor, "The current thread has no executor");
 
@@ -25,6 +25,14 @@ TaskSpawnContextBase::TaskSpawnContextBase(TaskHandle<> task, CaptureSource sour
     this->setStoppedHandler(handler);
     this->setExecutor(*executor);
 
+    // Inherit the locals & priority from the context which spawn us (if in coroutine)
+    if (auto parent = CoroContext::current(); parent) {
+        this->inherit(*parent);
+    }
+    if (options.priority) {
+        this->setPriority(*options.priority);
+    }
+
     // TRACING: trace the spawn point
     this->tracing().pushFrame("spawn", source);
     this->tracing().spawn(source);
@@ -396,6 +404,8 @@ auto FinallyAwaiterBase::onTaskCompletion() -> void {
 
         // Store the context info
         auto &executor = mContext->executor();
+        auto locals = mContext->locals();
+        auto priority = mContext->priority();
 #if defined(ILIAS_CORO_TRACE)
         auto parent = mContext->tracing().parent();
 #endif // ILIAS_CORO_TRACE
@@ -411,6 +421,8 @@ auto FinallyAwaiterBase::onTaskCompletion() -> void {
         mContext.emplace(handle, std::nostopstate);
         mContext->setUserdata(this);
         mContext->setExecutor(executor);
+        mContext->setLocals(std::move(locals));
+        mContext->setPriority(priority);
         handle.setContext(*mContext);
         handle.setCompletionHandler(finallyCallback);
 
@@ -453,6 +465,62 @@ auto StopTokenAwaiter::onRuntimeStopRequested() -> void {
     }
 }
 
+// MARK: SwitchAwaiter
+auto SwitchAwaiter::await_suspend(CoroHandle caller) -> void { // Currently in the source thread
+    ILIAS_TRACE("Task", "Switch to executor {}", static_cast<void*>(&mTarget));
+    mCaller = caller;
+    if (caller.isStopRequested()) { // Don't hop, just enter the stopped state here
+        return caller.setStopped();
+    }
+
+    // From now, the context belongs to the target, the caller may be resumed in another thread after the post
+    mCtxt->setExecutor(mTarget);
+    if (mBatch) {
+        return mBatch->enqueue(*this);
+    }
+    mTarget.postWithPriority(SwitchAwaiter::onArrive, this, mCtxt->priority());
+}
+
+auto SwitchAwaiter::arrive() -> void { // Currently in the target thread
+    if (mCaller.isStopRequested()) { // The stop was requested during the hop, as same as other suspend points
+        return mCaller.setStopped();
+    }
+    mCaller.resume();
+}
+
+auto SwitchAwaiter::onArrive(void *self) -> void {
+    static_cast<SwitchAwaiter *>(self)->arrive();
+}
+
+// MARK: SwitchBatch
+SwitchBatch::~SwitchBatch() {
+    ILIAS_ASSERT(mPending.empty(), "SwitchBatch destroyed with the pending switches");
+}
+
+auto SwitchBatch::enqueue(SwitchAwaiter &awaiter) -> void {
+    {
+        std::lock_guard locker {mMutex};
+        mPending.push_back(&awaiter);
+        if (mPending.size() != 1) { // The drain is already posted, just join it
+            return;
+        }
+    }
+    mTarget.postWithPriority(SwitchBatch::onDrain, this, awaiter.mCtxt->priority());
+}
+
+auto SwitchBatch::onDrain(void *_self) -> void { // Currently in the target thread
+    auto &self = *static_cast<SwitchBatch *>(_self);
+    auto running = std::vector<SwitchAwaiter *> {};
+    {
+        std::lock_guard locker {self.mMutex};
+        running.swap(self.mPending);
+    }
+    ILIAS_TRACE("Task", "Switch {} coroutines to executor {} in batch", running.size(), static_cast<void*>(&self.mTarget));
+    for (auto awaiter : running) { // The batch may be destroyed by the resumed one, don't touch self here
+        awaiter->arrive();
+    }
+}
+
 // MARK: Thread
 auto ThreadBase::start() -> void {
     if (!mInit) {
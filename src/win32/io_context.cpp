@@ -90,6 +90,7 @@ auto IocpContext::post(void (*fn)(void *), void *args) -> void {
         mCallbacks.emplace_back(fn, args);
         return;
     }
+    mMetrics.onRemotePost();
     ::PostQueuedCompletionStatus(
         mIocpFd.get(), 
         CALLBACK_MAGIC, 
@@ -98,7 +99,12 @@ auto IocpContext::post(void (*fn)(void *), void *args) -> void {
     );
 }
 
+auto IocpContext::heartbeat() noexcept -> runtime::Heartbeat * {
+    return &mHeartbeat;
+}
+
 auto IocpContext::run(runtime::StopToken token) -> void {
+    auto scope = runtime::Heartbeat::Scope {mHeartbeat};
     bool running = true;
     runtime::StopCallback calback(token, [&, this]() {
         schedule([&]() { running = false; });
@@ -115,12 +121,17 @@ auto IocpContext::run(runtime::StopToken token) -> void {
             mService.updateTimers();
         }
         // Drain the callback queue first
+        mMetrics.onTick(mService.size());
         while (!mCallbacks.empty()) {
             auto cb = mCallbacks.front();
             mCallbacks.pop_front();
+            auto begin = runtime::MetricsRecorder::Clock::now(); // Right before the callback, the timers below are not part of it
+            mHeartbeat.beat(begin);
             cb.first(cb.second);
+            mMetrics.onCallback(runtime::MetricsRecorder::Clock::now() - begin);
             mService.updateTimers();
         }
+        mHeartbeat.idle();
         if (!running) {
             break;
         }
@@ -132,7 +143,12 @@ auto IocpContext::run(runtime::StopToken token) -> void {
 
 auto IocpContext::processCompletion(DWORD timeout) -> void {
     if (mEntriesIdx >= mEntriesSize) { // We need more entries
-        if (!::GetQueuedCompletionStatusEx(mIocpFd.get(), mEntries.data(), mEntries.size(), &mEntriesSize, timeout, FALSE)) {
+        auto begin = runtime::MetricsRecorder::Clock::now();
+        auto ok = ::GetQueuedCompletionStatusEx(mIocpFd.get(), mEntries.data(), mEntries.size(), &mEntriesSize, timeout, FALSE);
+        auto end = runtime::MetricsRecorder::Clock::now();
+        mMetrics.onPoll(end - begin);
+        mHeartbeat.beat(end); // The completion may resume the coroutine directly
+        if (!ok) {
             mEntriesSize = 0;
             mEntriesIdx = 0;
             auto error = ::GetLastError();
@@ -258,6 +274,9 @@ auto IocpContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<Io
         ILIAS_ERROR("IOCP", "Invalid file descriptor in addDescriptor, fd = {}, type = {}", fd, type);
         return Err(IoError::InvalidArgument);
     }
+    if (type == IoDescriptor::Accepted) {
+        type = IoDescriptor::Socket;
+    }
     if (type == IoDescriptor::Unknown) {
         auto ret = fd_utils::type(fd);
         if (!ret) {
@@ -314,15 +333,25 @@ auto IocpContext::addDescriptor(fd_t fd, IoDescriptor::Type type) -> IoResult<Io
         }
     }
     ILIAS_TRACE("IOCP", "Adding fd: {} to completion port, type: {}", fd, type);
+    mMetrics.onDescriptorAdded();
     return nfd.release();
 }
 
 auto IocpContext::removeDescriptor(IoDescriptor *descriptor) -> IoResult<void> {
     auto nfd = static_cast<IocpDescriptor*>(descriptor);
     delete nfd;
+    mMetrics.onDescriptorRemoved();
     return {};
 }
 
+auto IocpContext::metrics() const -> RuntimeMetrics {
+    auto metrics = mMetrics.snapshot();
+    for (size_t i = 0; i < runtime::PriorityCount; ++i) {
+        metrics.queues[i] = queueStats(static_cast<runtime::Priority>(i));
+    }
+    return metrics;
+}
+
 // MARK: Fs
 auto IocpContext::read(IoDescriptor *fd, MutableBuffer buffer, std::optional<size_t> offset) -> IoTask<size_t> {
     auto nfd = static_cast<IocpDescriptor*>(fd);
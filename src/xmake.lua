@@ -83,6 +83,10 @@ target("ilias")
         set_configvar("ILIAS_USE_FIBER", 1)
     end
 
+    if has_config("task_local") then
+        set_configvar("ILIAS_TASK_LOCAL", 1)
+    end
+
     if has_config("io_uring") then
         add_packages("liburing", {public = true})
         set_configvar("ILIAS_USE_IO_URING", 1)
@@ -0,0 +1,96 @@
+#include <ilias/platform.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/io/watchdog.hpp>
+#include <ilias/task.hpp>
+#include <thread>
+#include <mutex>
+
+using namespace ilias;
+using namespace std::literals;
+
+TEST(Metrics, Histogram) {
+    using runtime::Histogram;
+    EXPECT_EQ(Histogram::bucketOf(0ns), 0);
+    EXPECT_EQ(Histogram::bucketOf(1ns), 1);
+    EXPECT_EQ(Histogram::bucketOf(3ns), 2);
+    EXPECT_EQ(Histogram::bucketOf(1024ns), 11);
+    EXPECT_EQ(Histogram::bucketOf(1h), Histogram::BucketCount - 1);
+
+    auto h = Histogram {};
+    EXPECT_EQ(h.percentile(0.99), 0ns);
+    EXPECT_EQ(h.mean(), 0ns);
+    for (int i = 0; i < 99; ++i) { // 99 samples in [512, 1024)
+        h.buckets[Histogram::bucketOf(600ns)] += 1;
+    }
+    h.buckets[Histogram::bucketOf(1ms)] += 1; // 1 sample in [2^19, 2^20)
+    h.count = 100;
+    h.sum = 99 * 600ns + 1ms;
+    h.max = 1ms;
+    EXPECT_EQ(h.percentile(0.5), 1024ns);
+    EXPECT_EQ(h.percentile(0.98), 1024ns);
+    EXPECT_EQ(h.percentile(1.0), 1ms); // Capped by the max
+    EXPECT_EQ(h.mean(), (99 * 600ns + 1ms) / 100);
+}
+
+ILIAS_TEST(Metrics, Context) {
+    auto &ctxt = *IoContext::currentThread();
+    auto prev = ctxt.metrics();
+
+    // Local callbacks & timers
+    co_await sleep(10ms);
+    for (int i = 0; i < 10; ++i) {
+        co_await this_coro::yield();
+    }
+
+    // Remote post
+    auto thread = std::thread([&]() {
+        ctxt.schedule([]() {});
+    });
+    thread.join();
+    co_await sleep(1ms);
+
+    auto now = ctxt.metrics();
+    EXPECT_GT(now.ticks, prev.ticks);
+    EXPECT_GE(now.callbacks, prev.callbacks + 10);
+    EXPECT_GE(now.remotePosts, prev.remotePosts + 1);
+    EXPECT_GT(now.polls, prev.polls);
+    EXPECT_GE(now.pollBlocked - prev.pollBlocked, 5ms);
+    EXPECT_EQ(now.callbackDuration.count, now.callbacks);
+    EXPECT_EQ(now.pollDuration.count, now.polls);
+    EXPECT_GT(now.callbacksPerTick(), 0.0);
+}
+
+ILIAS_TEST(Metrics, Watchdog) {
+    auto mutex = std::mutex {};
+    auto reports = std::vector<std::pair<bool, std::chrono::nanoseconds> > {};
+    auto watchdog = Watchdog { {
+        .threshold = 20ms,
+        .handler = [&](const StallReport &report) {
+            std::lock_guard locker {mutex};
+            EXPECT_EQ(report.name, "main");
+            reports.emplace_back(report.finished, report.duration);
+        }
+    } };
+    EXPECT_TRUE(watchdog.watch(*IoContext::currentThread(), "main"));
+
+    // Idle loop isn't a stall
+    co_await sleep(50ms);
+    EXPECT_EQ(watchdog.stalls(), 0);
+
+    // Block the loop
+    std::this_thread::sleep_for(100ms);
+    co_await this_coro::yield();
+    co_await sleep(50ms);
+    watchdog.unwatch(*IoContext::currentThread());
+
+    EXPECT_EQ(watchdog.stalls(), 1);
+    std::lock_guard locker {mutex};
+    EXPECT_EQ(reports.size(), 2);
+    if (reports.size() != 2) {
+        co_return;
+    }
+    EXPECT_FALSE(reports[0].first);
+    EXPECT_GE(reports[0].second, 20ms);
+    EXPECT_TRUE(reports[1].first);
+    EXPECT_GE(reports[1].second, 90ms);
+}
@@ -0,0 +1,352 @@
+#include <ilias/testing.hpp>
+#include <ilias/net/dns.hpp>
+#include <ilias/net/udp.hpp>
+#include <ilias/net/tcp.hpp>
+#include <ilias/task.hpp>
+#include <algorithm>
+#include <cctype>
+#include <set>
+using namespace ilias;
+using namespace std::literals;
+
+// The resolver counting the queries, example.test has 2 addresses, the others don't exist
+struct FakeResolver {
+    auto operator()(std::string_view name, [[maybe_unused]] int family) -> IoTask<DnsAnswer> {
+        *count += 1;
+        co_await sleep(10ms);
+        if (name == "unknown.test") {
+            co_return Err(GaiError::NotFound);
+        }
+        if (name == "fail.test") {
+            co_return Err(GaiError::TryAgain);
+        }
+        co_return DnsAnswer {
+            .addresses = {IPAddress("127.0.0.1"), IPAddress("::1")},
+            .ttl = name == "short.test" ? std::optional {20ms} : std::nullopt,
+        };
+    }
+
+    std::shared_ptr<int> count = std::make_shared<int>(0);
+};
+
+ILIAS_TEST(Dns, Cache) {
+    auto resolver = FakeResolver {};
+    auto cache = DnsCache({.resolver = resolver});
+    auto addresses = co_await cache.resolve("example.test");
+    EXPECT_TRUE(addresses);
+    EXPECT_EQ(addresses->size(), 2);
+    EXPECT_EQ(*resolver.count, 1);
+
+    // Hit, case insensitive
+    auto again = co_await cache.resolve("EXAMPLE.test.");
+    EXPECT_EQ(again, addresses);
+    EXPECT_EQ(*resolver.count, 1);
+
+    // With the port
+    auto endpoints = co_await cache.lookup("example.test", 80);
+    EXPECT_TRUE(endpoints);
+    EXPECT_EQ(endpoints->at(0), IPEndpoint("127.0.0.1:80"));
+    EXPECT_EQ(*resolver.count, 1);
+
+    // The ip literal never goes to the resolver
+    auto literal = co_await cache.resolve("10.0.0.1");
+    EXPECT_TRUE(literal && literal->size() == 1 && literal->at(0) == IPAddress("10.0.0.1"));
+    EXPECT_FALSE(co_await cache.resolve("10.0.0.1", AF_INET6));
+
+    cache.invalidate("example.test");
+    EXPECT_TRUE(co_await cache.resolve("example.test"));
+    EXPECT_EQ(*resolver.count, 2);
+    EXPECT_EQ(cache.stats().hits, 2);
+    EXPECT_EQ(cache.stats().misses, 2);
+}
+
+ILIAS_TEST(Dns, Expire) {
+    auto resolver = FakeResolver {};
+    auto cache = DnsCache({.ttl = 1h, .maxTtl = 1h, .negativeTtl = 30ms, .resolver = resolver});
+    EXPECT_TRUE(co_await cache.resolve("short.test")); // The ttl reported by the resolver is used
+    EXPECT_TRUE(co_await cache.resolve("short.test"));
+    EXPECT_EQ(*resolver.count, 1);
+    co_await sleep(30ms);
+    EXPECT_TRUE(co_await cache.resolve("short.test"));
+    EXPECT_EQ(*resolver.count, 2);
+
+    // Negative caching
+    auto res = co_await cache.resolve("unknown.test");
+    EXPECT_EQ(res.error(), GaiError::NotFound);
+    res = co_await cache.resolve("unknown.test");
+    EXPECT_EQ(res.error(), GaiError::NotFound);
+    EXPECT_EQ(*resolver.count, 3);
+    co_await sleep(40ms);
+    EXPECT_FALSE(co_await cache.resolve("unknown.test"));
+    EXPECT_EQ(*resolver.count, 4);
+
+    // The temporary failure is not cached
+    EXPECT_FALSE(co_await cache.resolve("fail.test"));
+    EXPECT_FALSE(co_await cache.resolve("fail.test"));
+    EXPECT_EQ(*resolver.count, 6);
+}
+
+ILIAS_TEST(Dns, Coalesce) {
+    auto resolver = FakeResolver {};
+    auto cache = DnsCache({.resolver = resolver});
+    auto fn = [&]() -> Task<bool> {
+        auto res = co_await cache.resolve("example.test");
+        co_return res && res->size() == 2;
+    };
+    auto [a, b, c] = co_await whenAll(fn(), fn(), fn());
+    EXPECT_TRUE(a && b && c);
+    EXPECT_EQ(*resolver.count, 1);
+    EXPECT_EQ(cache.stats().coalesced, 2);
+
+    // The waiters still get the answer if the one started the query is cancelled
+    cache.clear();
+    auto first = spawn(fn());
+    co_await this_coro::yield();
+    auto second = spawn(fn());
+    first.stop();
+    EXPECT_FALSE(co_await std::move(first));
+    EXPECT_TRUE(co_await std::move(second));
+    EXPECT_EQ(*resolver.count, 2);
+}
+
+ILIAS_TEST(Dns, Evict) {
+    auto resolver = FakeResolver {};
+    auto cache = DnsCache({.capacity = 2, .resolver = resolver});
+    EXPECT_TRUE(co_await cache.resolve("a.test"));
+    EXPECT_TRUE(co_await cache.resolve("b.test"));
+    EXPECT_TRUE(co_await cache.resolve("a.test")); // Now b is the least recently used
+    EXPECT_TRUE(co_await cache.resolve("c.test"));
+    EXPECT_EQ(cache.stats().size, 2);
+    EXPECT_EQ(*resolver.count, 3);
+
+    EXPECT_TRUE(co_await cache.resolve("a.test"));
+    EXPECT_EQ(*resolver.count, 3);
+    EXPECT_TRUE(co_await cache.resolve("b.test"));
+    EXPECT_EQ(*resolver.count, 4);
+}
+
+ILIAS_TEST(Dns, Default) {
+    auto cache = DnsCache {};
+    auto addresses = co_await cache.resolve("localhost", AF_INET);
+    EXPECT_TRUE(addresses);
+    if (addresses) {
+        EXPECT_EQ(addresses->at(0), IPAddress("127.0.0.1"));
+    }
+    EXPECT_TRUE(co_await cache.resolve("localhost", AF_INET));
+    EXPECT_EQ(cache.stats().hits, 1);
+}
+
+// MARK: Resolver
+// The stand-in dns server on 127.0.0.1, answer the A / AAAA queries by the table below, udp and tcp on the same port
+class StandInServer {
+public:
+    static auto make() -> IoTask<StandInServer> {
+        auto server = StandInServer {};
+        ILIAS_CO_TRY(server.mUdp, co_await UdpSocket::bind("127.0.0.1:0"));
+        ILIAS_CO_TRY(server.mEndpoint, server.mUdp.localEndpoint());
+        ILIAS_CO_TRY(server.mTcp, co_await TcpListener::bind(server.mEndpoint));
+        co_return server;
+    }
+
+    auto run() -> Task<void> {
+        auto tcp = spawn(serveTcp());
+        auto buf = std::array<uint8_t, 1500> {};
+        while (true) {
+            auto res = co_await mUdp.recvfrom(makeBuffer(buf));
+            if (!res) {
+                break;
+            }
+            auto [n, from] = *res;
+            *queries += 1;
+            auto reply = answer(std::span(buf).first(n), false);
+            if (!reply.empty()) {
+                (void) co_await mUdp.sendto(makeBuffer(reply), from);
+            }
+        }
+        tcp.stop();
+        co_await std::move(tcp);
+    }
+
+    auto endpoint() const -> IPEndpoint { return mEndpoint; }
+
+    std::shared_ptr<int> queries = std::make_shared<int>(0);
+private:
+    auto serveTcp() -> Task<void> {
+        while (true) {
+            auto res = co_await mTcp.accept();
+            if (!res) {
+                break;
+            }
+            auto stream = std::move(res->first);
+            auto len = co_await io::readInt<std::endian::big, uint16_t>(stream);
+            if (!len) {
+                continue;
+            }
+            auto query = std::vector<uint8_t>(*len);
+            (void) co_await io::readAll(stream, makeBuffer(query));
+            auto reply = answer(query, true);
+            (void) co_await io::writeInt<std::endian::big>(stream, uint16_t(reply.size()));
+            (void) co_await stream.writeAll(makeBuffer(reply));
+        }
+    }
+
+    auto answer(std::span<const uint8_t> query, bool tcp) -> std::vector<uint8_t> {
+        // Decode the question, the name is never compressed in the query
+        auto pos = size_t {12};
+        auto name = std::string {};
+        while (query[pos] != 0) {
+            if (!name.empty()) {
+                name += '.';
+            }
+            name.append(reinterpret_cast<const char *>(query.data()) + pos + 1, query[pos]);
+            pos += query[pos] + 1;
+        }
+        auto type = uint16_t((query[pos + 1] << 8) | query[pos + 2]);
+        auto questionEnd = pos + 5;
+
+        auto rcode = uint8_t {0};
+        auto truncated = false;
+        auto records = std::vector<std::pair<IPAddress, uint32_t> > {};
+        if (name == "example.test") {
+            records.emplace_back(type == 1 ? IPAddress("10.0.0.1") : IPAddress("fd00::1"), type == 1 ? 60 : 30);
+        }
+        else if (name == "v4.test" && type == 1) {
+            records.emplace_back(IPAddress("10.0.0.4"), 60);
+        }
+        else if (name == "host.lab.test" && type == 1) {
+            records.emplace_back(IPAddress("10.0.0.5"), 60);
+        }
+        else if (name == "big.test" && type == 1) { // Only the tcp gets the full answer
+            truncated = !tcp;
+            for (int i = 0; !truncated && i < 100; i++) {
+                records.emplace_back(IPAddress4::fromUint32(0x0A010000 + i), 60);
+            }
+        }
+        else if (name == "drop.test") { // Drop the first query of each type
+            if (mDropped.insert(type).second) {
+                return {};
+            }
+            records.emplace_back(type == 1 ? IPAddress("10.0.0.6") : IPAddress("fd00::6"), 60);
+        }
+        else if (name == "fail.test") {
+            rcode = 2; // SERVFAIL
+        }
+        else if ((name == "spoof.test" || name == "case.test") && type == 1) {
+            records.emplace_back(IPAddress("10.0.0.7"), 60);
+        }
+        else if (name != "v4.test" && name != "host.lab.test" && name != "big.test" && name != "spoof.test" && name != "case.test") {
+            rcode = 3; // NXDOMAIN
+        }
+
+        auto reply = std::vector<uint8_t>(query.begin(), query.begin() + questionEnd);
+        if (name == "spoof.test") { // The question doesn't match, "rpoof.test"
+            reply[13] = 'r';
+        }
+        if (name == "case.test") { // The question in the other case, "CASE.test", still the same name
+            std::transform(reply.begin() + 13, reply.begin() + 17, reply.begin() + 13, [](uint8_t ch) { return uint8_t(std::toupper(ch)); });
+        }
+        reply[2] = 0x81 | (truncated ? 0x02 : 0x00); // QR, RD, TC
+        reply[3] = 0x80 | rcode; // RA
+        reply[6] = 0;
+        reply[7] = uint8_t(records.size());
+        reply[8] = reply[9] = reply[10] = reply[11] = 0;
+        for (const auto &[addr, ttl] : records) {
+            auto bytes = addr.span();
+            auto header = std::array<uint8_t, 12> {
+                0xC0, 0x0C, // The pointer to the question name
+                0, uint8_t(type), 0, 1,
+                uint8_t(ttl >> 24), uint8_t(ttl >> 16), uint8_t(ttl >> 8), uint8_t(ttl),
+                0, uint8_t(bytes.size())
+            };
+            reply.insert(reply.end(), header.begin(), header.end());
+            for (auto byte : bytes) {
+                reply.push_back(uint8_t(byte));
+            }
+        }
+        return reply;
+    }
+
+    UdpSocket   mUdp;
+    TcpListener mTcp;
+    IPEndpoint  mEndpoint;
+    std::set<uint16_t> mDropped;
+};
+
+ILIAS_TEST(Dns, Resolver) {
+    auto server = (co_await StandInServer::make()).value();
+    auto handle = spawn(server.run());
+    auto config = DnsResolver::Config {
+        .nameservers = {server.endpoint()},
+        .search = {"lab.test"},
+        .timeout = 50ms,
+        .hosts = {},
+    };
+    DnsResolver::parseHosts("127.0.0.1 localhost # comment\n::1 localhost ip6-localhost\n", config);
+    auto resolver = DnsResolver {config};
+
+    // Both families, ipv6 first, the min ttl
+    auto answer = co_await resolver.resolve("example.test");
+    EXPECT_TRUE(answer);
+    if (answer) {
+        EXPECT_EQ(answer->addresses, (std::vector<IPAddress> {IPAddress("fd00::1"), IPAddress("10.0.0.1")}));
+        EXPECT_EQ(answer->ttl, std::chrono::seconds(30));
+    }
+    auto endpoints = co_await resolver.lookup("Example.Test.", 80, AF_INET);
+    EXPECT_TRUE(endpoints && endpoints->size() == 1 && endpoints->at(0) == IPEndpoint("10.0.0.1:80"));
+
+    // Only the A record
+    answer = co_await resolver.resolve("v4.test");
+    EXPECT_TRUE(answer && answer->addresses.size() == 1);
+    EXPECT_EQ((co_await resolver.resolve("v4.test", AF_INET6)).error(), GaiError::NotFound);
+
+    // The search domain
+    answer = co_await resolver.resolve("host", AF_INET);
+    EXPECT_TRUE(answer && answer->addresses.at(0) == IPAddress("10.0.0.5"));
+
+    // Fall back to tcp on the truncated reply
+    answer = co_await resolver.resolve("big.test", AF_INET);
+    EXPECT_TRUE(answer && answer->addresses.size() == 100);
+
+    // Retry on timeout
+    answer = co_await resolver.resolve("drop.test");
+    EXPECT_TRUE(answer && answer->addresses.size() == 2);
+
+    // The failures
+    EXPECT_EQ((co_await resolver.resolve("unknown.test")).error(), GaiError::NotFound);
+    EXPECT_EQ((co_await resolver.resolve("fail.test", AF_INET)).error(), GaiError::TryAgain);
+
+    // The reply must echo the question, the name case-insensitively
+    EXPECT_EQ((co_await resolver.resolve("spoof.test", AF_INET)).error(), GaiError::TryAgain);
+    answer = co_await resolver.resolve("case.test", AF_INET);
+    EXPECT_TRUE(answer && answer->addresses.size() == 1);
+
+    // The hosts never go to the server
+    auto queries = *server.queries;
+    answer = co_await resolver.resolve("LOCALHOST", AF_INET);
+    EXPECT_TRUE(answer && answer->addresses.size() == 1 && answer->addresses[0] == IPAddress("127.0.0.1"));
+    answer = co_await resolver.resolve("ip6-localhost");
+    EXPECT_TRUE(answer && answer->addresses.size() == 1);
+    EXPECT_EQ(*server.queries, queries);
+
+    handle.stop();
+    co_await std::move(handle);
+}
+
+TEST(Dns, ResolvConf) {
+    auto config = DnsResolver::Config {};
+    DnsResolver::parseResolvConf(
+        "# comment\n"
+        "nameserver 10.0.0.53\n"
+        "nameserver ::1 ; comment\n"
+        "nameserver fe80::1%eth0\n"
+        "domain old.test\n"
+        "search Lab.Test. corp.test\n"
+        "options ndots:2 timeout:3 attempts:4 rotate\n",
+        config
+    );
+    EXPECT_EQ(config.nameservers, (std::vector<IPEndpoint> {IPEndpoint("10.0.0.53:53"), IPEndpoint("[::1]:53")}));
+    EXPECT_EQ(config.search, (std::vector<std::string> {"lab.test", "corp.test"}));
+    EXPECT_EQ(config.ndots, 2);
+    EXPECT_EQ(config.timeout, 3s);
+    EXPECT_EQ(config.attempts, 4);
+}
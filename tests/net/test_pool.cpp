@@ -0,0 +1,164 @@
+#include <ilias/testing.hpp>
+#include <ilias/net/pool.hpp>
+#include <ilias/net/tcp.hpp>
+#include <ilias/sharded.hpp>
+#include <ilias/task.hpp>
+#include <vector>
+using namespace ilias;
+using namespace std::literals;
+
+// The upstream keeps the accepted streams, so the test can close them from the server side
+struct Upstream {
+    static auto make() -> IoTask<Upstream> {
+        auto upstream = Upstream {};
+        ILIAS_CO_TRY(upstream.listener, co_await TcpListener::bind("127.0.0.1:0"));
+        ILIAS_CO_TRY(upstream.endpoint, upstream.listener.localEndpoint());
+        co_return upstream;
+    }
+
+    auto run() -> Task<void> {
+        while (true) {
+            auto res = co_await listener.accept();
+            if (!res) {
+                break;
+            }
+            accepted->emplace_back(std::move(res->first));
+        }
+    }
+
+    TcpListener listener;
+    IPEndpoint  endpoint;
+    std::shared_ptr<std::vector<TcpStream> > accepted = std::make_shared<std::vector<TcpStream> >();
+};
+
+ILIAS_TEST(Pool, Reuse) {
+    auto upstream = (co_await Upstream::make()).value();
+    auto handle = spawn(upstream.run());
+    auto pool = ConnectionPool<TcpStream> {};
+    {
+        auto conn = co_await pool.acquire(upstream.endpoint);
+        EXPECT_TRUE(conn);
+        EXPECT_FALSE(conn->isReused());
+        EXPECT_EQ(pool.activeCount(upstream.endpoint), 1);
+    }
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 1);
+    {
+        auto conn = co_await pool.acquire(upstream.endpoint);
+        EXPECT_TRUE(conn && conn->isReused());
+        EXPECT_EQ(pool.idleCount(upstream.endpoint), 0);
+        conn->discard(); // The protocol state is unknown, don't reuse it
+    }
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 0);
+    EXPECT_EQ(pool.stats().created, 1);
+    EXPECT_EQ(pool.stats().reused, 1);
+
+    // The peer closed the idle one, the health check drops it
+    {
+        auto conn = co_await pool.acquire(upstream.endpoint);
+        EXPECT_TRUE(conn);
+    }
+    co_await sleep(10ms);
+    upstream.accepted->clear();
+    co_await sleep(10ms);
+    {
+        auto conn = co_await pool.acquire(upstream.endpoint);
+        EXPECT_TRUE(conn);
+        EXPECT_FALSE(conn->isReused());
+    }
+    EXPECT_EQ(pool.stats().evicted, 1);
+    EXPECT_EQ(pool.stats().created, 3);
+
+    // The connect error
+    auto closed = (co_await TcpListener::bind("127.0.0.1:0")).value().localEndpoint().value();
+    EXPECT_FALSE(co_await pool.acquire(closed));
+    EXPECT_EQ(pool.activeCount(closed), 0);
+
+    handle.stop();
+    co_await std::move(handle);
+}
+
+ILIAS_TEST(Pool, Limit) {
+    auto upstream = (co_await Upstream::make()).value();
+    auto handle = spawn(upstream.run());
+    auto pool = ConnectionPool<TcpStream> { {.maxPerHost = 2, .connector = {}, .healthCheck = {}} };
+    auto a = (co_await pool.acquire(upstream.endpoint)).value();
+    auto b = (co_await pool.acquire(upstream.endpoint)).value();
+    auto order = std::vector<int> {};
+    auto waiter = [&](int id) -> Task<void> {
+        auto conn = co_await pool.acquire(upstream.endpoint);
+        EXPECT_TRUE(conn && conn->isReused());
+        order.push_back(id);
+        co_await sleep(5ms);
+    };
+    auto first = spawn(waiter(1));
+    co_await this_coro::yield();
+    auto second = spawn(waiter(2));
+    co_await this_coro::yield();
+    EXPECT_TRUE(order.empty()); // Both are waiting for a slot
+    { auto _ = std::move(a); } // Give back one, the waiters are served in order by it
+    co_await std::move(first);
+    co_await std::move(second);
+    EXPECT_EQ(order, (std::vector {1, 2}));
+    EXPECT_EQ(pool.stats().created, 2);
+
+    // Cancel the waiting one
+    auto c = (co_await pool.acquire(upstream.endpoint)).value();
+    auto third = spawn(waiter(3));
+    auto fourth = spawn(waiter(4));
+    co_await this_coro::yield();
+    third.stop();
+    EXPECT_FALSE(co_await std::move(third));
+    { auto _ = std::move(c); }
+    co_await std::move(fourth);
+    EXPECT_EQ(order, (std::vector {1, 2, 4}));
+    EXPECT_EQ(pool.activeCount(upstream.endpoint), 1);
+    { auto _ = std::move(b); }
+    EXPECT_EQ(pool.activeCount(upstream.endpoint), 0);
+
+    handle.stop();
+    co_await std::move(handle);
+}
+
+ILIAS_TEST(Pool, IdleTimeout) {
+    auto upstream = (co_await Upstream::make()).value();
+    auto handle = spawn(upstream.run());
+    auto pool = ConnectionPool<TcpStream> { {.maxIdle = 1, .idleTimeout = 30ms, .connector = {}, .healthCheck = {}} };
+    {
+        auto a = (co_await pool.acquire(upstream.endpoint)).value();
+        auto b = (co_await pool.acquire(upstream.endpoint)).value();
+    }
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 1); // Over the maxIdle, one is closed
+    co_await sleep(60ms);
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 0); // Closed by the timer
+    EXPECT_EQ(pool.stats().evicted, 2);
+
+    // The timer starts again on the next release
+    {
+        auto conn = (co_await pool.acquire(upstream.endpoint)).value();
+    }
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 1);
+    co_await sleep(60ms);
+    EXPECT_EQ(pool.idleCount(upstream.endpoint), 0);
+
+    handle.stop();
+    co_await std::move(handle);
+}
+
+TEST(Pool, Sharded) {
+    auto runtime = ShardedRuntime { {.shards = 2, .pinCpu = false} };
+    auto pools = ShardedConnectionPool<TcpStream> {runtime.size()};
+    runtime.run([&](Shard &shard) -> Task<void> {
+        auto upstream = (co_await Upstream::make()).value();
+        auto handle = spawn(upstream.run());
+        auto &pool = pools.local(shard.index());
+        for (int i = 0; i < 4; i++) {
+            auto conn = co_await pool.acquire(upstream.endpoint);
+            EXPECT_TRUE(conn);
+        }
+        EXPECT_EQ(pool.stats().created, 1); // Each shard has its own pool
+        EXPECT_EQ(pool.stats().reused, 3);
+        pools.reset(shard.index());
+        handle.stop();
+        co_await std::move(handle);
+    });
+}
@@ -0,0 +1,121 @@
+#include <ilias/testing.hpp>
+#include <ilias/sharded.hpp>
+#include <ilias/platform.hpp>
+#include <ilias/net/tcp.hpp>
+#include <atomic>
+#include <set>
+using namespace ilias;
+using namespace std::literals;
+
+TEST(Sharded, Listen) {
+    auto runtime = ShardedRuntime { {.shards = 2, .pinCpu = false} };
+    auto port = std::atomic<uint16_t> {0};
+    auto accepted = std::atomic<size_t> {0};
+    auto ready = std::atomic<size_t> {0};
+    runtime.run([&](Shard &shard) -> Task<void> {
+        EXPECT_EQ(shard.count(), 2);
+        if (shard.index() == 0) { // Let the first shard pick the port, the other one join the group
+            auto listener = (co_await shard.bind("127.0.0.1:0")).value();
+            port = listener.localEndpoint().value().port();
+            ready += 1;
+            port.notify_all();
+            // Wait for the other shard, then connect as the client
+            while (ready != 2) {
+                co_await sleep(1ms);
+            }
+            for (int i = 0; i < 8; ++i) {
+                auto stream = co_await TcpStream::connect(IPEndpoint {"127.0.0.1", port});
+                EXPECT_TRUE(stream);
+            }
+            runtime.stop();
+            while (true) { // Accept until the stop
+                auto res = co_await listener.accept();
+                if (!res) {
+                    break;
+                }
+                accepted += 1;
+            }
+            co_return;
+        }
+        port.wait(0);
+        auto listener = (co_await shard.bind(IPEndpoint {"127.0.0.1", port})).value();
+        EXPECT_EQ(listener.localEndpoint().value().port(), port);
+        ready += 1;
+        while (true) {
+            auto res = co_await listener.accept();
+            if (!res) {
+                break;
+            }
+            accepted += 1;
+        }
+    });
+    EXPECT_LE(accepted, 8);
+}
+
+TEST(Sharded, ListenMany) {
+    auto runtime = ShardedRuntime { {.shards = 1, .pinCpu = false, .cpuSteering = true} };
+    runtime.run([&](Shard &shard) -> Task<void> {
+        // Each endpoint is a group of its own
+        auto first = (co_await shard.bind("127.0.0.1:0")).value();
+        auto second = (co_await shard.bind("127.0.0.1:0")).value();
+        for (auto &listener : {std::ref(first), std::ref(second)}) {
+            auto stream = co_await TcpStream::connect(listener.get().localEndpoint().value());
+            EXPECT_TRUE(stream);
+            auto accepted = co_await listener.get().accept();
+            EXPECT_TRUE(accepted);
+        }
+
+        // Only one listener per endpoint in a shard
+        auto again = co_await shard.bind(first.localEndpoint().value());
+        EXPECT_FALSE(again);
+        if (!again) {
+            EXPECT_EQ(again.error(), SystemError::AddressInUse);
+        }
+    });
+}
+
+TEST(Sharded, Mailbox) {
+    auto runtime = ShardedRuntime { {.shards = 4, .pinCpu = false} };
+    auto mailbox = ShardMailbox<size_t> {runtime.size()};
+    auto mutex = std::mutex {};
+    auto threads = std::set<std::thread::id> {};
+    runtime.run([&](Shard &shard) -> Task<void> {
+        {
+            std::lock_guard locker {mutex};
+            threads.insert(std::this_thread::get_id());
+        }
+        // Ring: send self index to the next shard, receive from the prev one
+        auto next = (shard.index() + 1) % shard.count();
+        auto prev = (shard.index() + shard.count() - 1) % shard.count();
+        EXPECT_TRUE(co_await mailbox.send(next, shard.index()));
+        auto msg = co_await mailbox.recv(shard.index());
+        EXPECT_EQ(msg, prev);
+    });
+    EXPECT_EQ(threads.size(), 4);
+}
+
+TEST(Sharded, Stop) {
+    auto runtime = ShardedRuntime { {.shards = 2, .pinCpu = false} };
+    runtime.start([&](Shard &) -> Task<void> {
+        co_await sleep(1h); // Forever, until the stop
+    });
+    std::this_thread::sleep_for(10ms);
+    runtime.stop();
+    runtime.blockingJoin();
+
+    // Stop before start, the factory should be stopped at the first suspend point
+    auto runtime2 = ShardedRuntime { {.shards = 2, .pinCpu = false} };
+    runtime2.stop();
+    runtime2.start([&](Shard &) -> Task<void> {
+        co_await sleep(1h);
+    });
+    runtime2.blockingJoin();
+}
+
+TEST(Sharded, Exception) {
+    auto runtime = ShardedRuntime { {.shards = 2, .pinCpu = false} };
+    EXPECT_THROW(runtime.run([&](Shard &) -> Task<void> {
+        throw std::runtime_error("boom");
+        co_return;
+    }), std::runtime_error);
+}
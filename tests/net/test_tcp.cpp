@@ -1,6 +1,9 @@
 #include <ilias/testing.hpp>
 #include <ilias/net.hpp>
 #include <ilias/io.hpp>
+#include <ilias/fs/file.hpp>
+#include <filesystem>
+#include <fstream>
 using namespace ilias;
 using namespace ilias::literals;
 using namespace std::literals;
@@ -62,6 +65,97 @@ ILIAS_TEST(Net, Tcp) {
     }
 }
 
+ILIAS_TEST(Net, TcpProxy) {
+    static_assert(Spliceable<TcpStream>);
+    auto backend = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto frontend = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto payload = std::string(1024 * 1024 * 4, 'x'); // Larger than the pipe
+    for (size_t i = 0; i < payload.size(); i += 4096) {
+        payload[i] = char('a' + (i / 4096) % 26);
+    }
+
+    // The proxy, relay frontend <=> backend
+    auto proxy = spawn([&]() -> IoTask<std::pair<size_t, size_t> > {
+        ILIAS_CO_TRY(auto accepted, co_await frontend.accept());
+        ILIAS_CO_TRY(auto upstream, co_await TcpStream::connect(backend.localEndpoint().value()));
+        co_return co_await io::copyBidirectional(accepted.first, upstream);
+    });
+    // The echo server
+    auto server = spawn([&]() -> IoTask<void> {
+        ILIAS_CO_TRY(auto accepted, co_await backend.accept());
+        auto &[peer, _] = accepted;
+        std::string content;
+        ILIAS_CO_TRYV(co_await peer.readToEnd(content));
+        ILIAS_CO_TRYV(co_await peer.writeAll(makeBuffer(content)));
+        ILIAS_CO_TRYV(co_await peer.shutdown());
+        co_return {};
+    });
+    auto client = (co_await TcpStream::connect(frontend.localEndpoint().value())).value();
+    auto reader = spawn([&]() -> IoTask<std::string> {
+        std::string content;
+        ILIAS_CO_TRYV(co_await client.readToEnd(content));
+        co_return content;
+    });
+    EXPECT_TRUE(co_await client.writeAll(makeBuffer(payload)));
+    EXPECT_TRUE(co_await client.shutdown());
+
+    auto echo = co_await std::move(reader);
+    EXPECT_TRUE(echo && *echo == payload);
+    EXPECT_TRUE(co_await std::move(server));
+    EXPECT_EQ(co_await std::move(proxy), std::pair(payload.size(), payload.size()));
+}
+
+ILIAS_TEST(Net, TcpProxyError) {
+    auto listener = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto endpoint = listener.localEndpoint().value();
+    auto resetter = (co_await TcpStream::connect(endpoint)).value();
+    auto [a, _] = (co_await listener.accept()).value();
+    auto idle = (co_await TcpStream::connect(endpoint)).value();
+    auto [b, _2] = (co_await listener.accept()).value();
+
+    // The peer of a resets the connection, the peer of b sends nothing, the relay must end with the error
+    auto relay = spawn(timeout(io::copyBidirectional(a, b), 1s));
+    co_await this_coro::yield();
+    EXPECT_TRUE(resetter.setOption(sockopt::Linger(::linger {.l_onoff = 1, .l_linger = 0})));
+    resetter.close();
+    auto res = (co_await std::move(relay)).value();
+    EXPECT_TRUE(res); // Not timed out
+    if (res) {
+        EXPECT_FALSE(*res);
+        EXPECT_NE(res->error(), IoError::Canceled); // The real error, not the cancellation of the idle direction
+    }
+}
+
+ILIAS_TEST(Net, TcpSendFile) {
+    auto path = std::filesystem::temp_directory_path() / "ilias_test_sendfile.bin";
+    auto content = std::string(1024 * 1024, 'x');
+    for (size_t i = 0; i < content.size(); i += 1000) {
+        content[i] = char('a' + (i / 1000) % 26);
+    }
+    std::ofstream(path, std::ios::binary) << content;
+
+    auto file = (co_await File::open(path)).value();
+    auto listener = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto client = (co_await TcpStream::connect(listener.localEndpoint().value())).value();
+    auto [peer, _] = (co_await listener.accept()).value();
+    auto reader = spawn([&]() -> IoTask<std::string> {
+        std::string received;
+        ILIAS_CO_TRYV(co_await peer.readToEnd(received));
+        co_return received;
+    });
+
+    // The range in the middle, then the range exceeds the end of the file
+    EXPECT_EQ(co_await client.sendFile(file, 1000, 500000), 500000);
+    EXPECT_EQ(co_await client.sendFile(file, content.size() - 100, 4096), 100);
+    EXPECT_TRUE(co_await client.shutdown());
+    EXPECT_EQ(co_await file.seek(0, SeekOrigin::Current), 0); // The offset of the file is not changed
+
+    auto received = co_await std::move(reader);
+    EXPECT_TRUE(received && *received == content.substr(1000, 500000) + content.substr(content.size() - 100));
+    file.close();
+    std::filesystem::remove(path);
+}
+
 ILIAS_RTEST(Net, Http) {
     ILIAS_CO_TRY(auto info, co_await AddressInfo::fromHostname("www.baidu.com", "http"));
     ILIAS_CO_TRY(auto client, co_await TcpStream::connect(info.endpoints().at(0)));
@@ -88,4 +182,166 @@ ILIAS_RTEST(Net, Http) {
         std::cout << std::string_view(buffer, size) << std::endl;
     }
     co_return {};
-}
\ No newline at end of file
+}
+
+ILIAS_TEST(Net, TcpHappyEyeballs) {
+    auto listener = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto good = listener.localEndpoint().value();
+    auto accept = spawn([&]() -> Task<void> {
+        while (true) {
+            auto res = co_await listener.accept();
+            if (!res) {
+                break;
+            }
+        }
+    });
+
+    // The blackholed address never answers, the connector hangs on it until cancelled
+    auto blackhole = IPEndpoint("192.0.2.1:1");
+    auto connector = [&](const IPEndpoint &endpoint) -> IoTask<TcpStream> {
+        if (endpoint == blackhole) {
+            co_await sleep(1h);
+            co_return Err(IoError::TimedOut);
+        }
+        co_return co_await TcpStream::connect(endpoint);
+    };
+
+    // The refused address, nothing listening on it
+    auto refused = (co_await TcpListener::bind("127.0.0.1:0")).value().localEndpoint().value();
+
+    {   // The next attempt starts after the delay, the blackholed one is cancelled
+        auto attempts = std::vector<TcpConnectAttempt> {};
+        auto endpoints = std::vector {blackhole, good};
+        auto stream = co_await TcpStream::connect(endpoints, {.attemptDelay = 50ms, .connector = connector, .attempts = &attempts});
+        EXPECT_TRUE(stream);
+        EXPECT_EQ(attempts.size(), 2);
+        if (attempts.size() == 2) {
+            EXPECT_EQ(attempts[0].error, IoError::Canceled);
+            EXPECT_GE(attempts[0].elapsed, 50ms);
+            EXPECT_GE(attempts[1].start, 50ms);
+            EXPECT_FALSE(attempts[1].error);
+        }
+    }
+    {   // The next attempt starts at once on the failure
+        auto attempts = std::vector<TcpConnectAttempt> {};
+        auto endpoints = std::vector {refused, good};
+        auto stream = co_await TcpStream::connect(endpoints, {.attemptDelay = 10s, .attempts = &attempts});
+        EXPECT_TRUE(stream);
+        EXPECT_EQ(attempts.size(), 2);
+        if (attempts.size() == 2) {
+            EXPECT_EQ(attempts[0].error, SystemError::ConnectionRefused);
+            EXPECT_LT(attempts[1].start, 1s);
+        }
+    }
+    {   // The failure of the later one doesn't drop the pending one
+        auto attempts = std::vector<TcpConnectAttempt> {};
+        auto endpoints = std::vector {blackhole, refused};
+        auto stream = co_await (TcpStream::connect(endpoints, {.attemptDelay = 10ms, .connector = connector, .attempts = &attempts}) | timeout(100ms));
+        EXPECT_FALSE(stream); // Timeout, still waiting for the blackholed one
+        EXPECT_EQ(attempts.size(), 0); // Not reported, the connect is cancelled
+    }
+    {   // All failed
+        auto endpoints = std::vector {refused, refused};
+        auto stream = co_await TcpStream::connect(endpoints);
+        EXPECT_EQ(stream.error(), SystemError::ConnectionRefused);
+    }
+    {   // The families are interleaved
+        auto attempts = std::vector<TcpConnectAttempt> {};
+        auto endpoints = std::vector {IPEndpoint("[::1]:1"), IPEndpoint("[::1]:2"), refused};
+        auto _ = co_await TcpStream::connect(endpoints, {.attempts = &attempts});
+        EXPECT_EQ(attempts.size(), 3);
+        if (attempts.size() == 3) {
+            EXPECT_EQ(attempts[1].endpoint, refused);
+        }
+    }
+    {   // By the hostname
+        auto stream = co_await TcpStream::connect("localhost", good.port());
+        EXPECT_TRUE(stream);
+        stream = co_await TcpStream::connect("127.0.0.1", good.port());
+        EXPECT_TRUE(stream);
+    }
+    accept.stop();
+    co_await std::move(accept);
+}
+
+ILIAS_TEST(Net, TcpAcceptMany) {
+    auto listener = (co_await TcpListener::bind("127.0.0.1:0")).value();
+    auto endpoint = listener.localEndpoint().value();
+    auto clients = std::vector<TcpStream> {};
+    for (int i = 0; i < 5; i++) {
+        auto client = co_await TcpStream::connect(endpoint);
+        EXPECT_TRUE(client);
+        if (client) {
+            clients.emplace_back(std::move(*client));
+        }
+    }
+
+    // All the 5 are pending, take them by 3 + 2
+    auto first = co_await listener.acceptMany(3);
+    EXPECT_TRUE(first);
+    EXPECT_EQ(first->size(), 3);
+    auto second = co_await listener.acceptMany(16);
+    EXPECT_TRUE(second);
+    EXPECT_EQ(second->size(), 2);
+    for (auto &[stream, peer] : *second) {
+        EXPECT_EQ(stream.remoteEndpoint().value(), peer);
+    }
+
+#if defined(__linux__)
+    // By accept4, the flags are set without fcntl
+    auto fd = fd_t(second->front().first.socket().get());
+    EXPECT_TRUE(::fcntl(fd, F_GETFL) & O_NONBLOCK);
+    EXPECT_TRUE(::fcntl(fd, F_GETFD) & FD_CLOEXEC);
+#endif // defined(__linux__)
+
+    // The first waits for the connection
+    auto accept = spawn(listener.acceptMany(16));
+    co_await this_coro::yield();
+    auto client = co_await TcpStream::connect(endpoint);
+    EXPECT_TRUE(client);
+    auto third = (co_await std::move(accept)).value();
+    EXPECT_TRUE(third);
+    EXPECT_EQ(third->size(), 1);
+}
+
+#if defined(__linux__)
+ILIAS_TEST(Net, TcpFastOpen) {
+    auto listener = co_await TcpBuilder {AF_INET}
+        .option(sockopt::ReuseAddress(true))
+        .option(sockopt::TcpFastOpen(16))
+        .option(sockopt::TcpDeferAccept(1))
+        .bind("127.0.0.1:0");
+    EXPECT_TRUE(listener);
+    auto endpoint = listener->localEndpoint().value();
+    EXPECT_EQ(int(listener->getOption<sockopt::TcpFastOpen>().value()), 16);
+
+    // The first one gets the cookie, the second one may carry the payload in the SYN, both must work in any case
+    for (int i = 0; i < 2; i++) {
+        auto client = co_await TcpBuilder {AF_INET}.connect(endpoint, makeBuffer("hello"sv));
+        EXPECT_TRUE(client);
+        auto accepted = co_await listener->accept();
+        EXPECT_TRUE(accepted);
+        char buffer[5] {};
+        auto n = co_await accepted->first.readAll(makeBuffer(buffer));
+        EXPECT_EQ(n, 5);
+        EXPECT_EQ(std::string_view(buffer, 5), "hello");
+    }
+
+    // The latency options on the stream
+    auto client = co_await TcpBuilder {AF_INET}.connect(endpoint, makeBuffer("ping"sv));
+    EXPECT_TRUE(client);
+    EXPECT_TRUE(client->setOption(sockopt::TcpQuickAck(true)));
+    EXPECT_TRUE(client->setOption(sockopt::TcpNotSentLowat(16384)));
+    EXPECT_EQ(int(client->getOption<sockopt::TcpNotSentLowat>().value()), 16384);
+    EXPECT_TRUE(client->setOption(sockopt::IncomingCpu(0)));
+
+    // The refused one fails on the connect, or on the first read if the payload was queued in the SYN
+    auto closed = (co_await TcpListener::bind("127.0.0.1:0")).value().localEndpoint().value();
+    auto refused = co_await TcpBuilder {AF_INET}.connect(closed, makeBuffer("hello"sv));
+    if (refused) {
+        char byte = 0;
+        auto n = co_await refused->read(makeBuffer(&byte, 1));
+        EXPECT_FALSE(n);
+    }
+}
+#endif // defined(__linux__)
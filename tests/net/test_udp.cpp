@@ -72,3 +72,102 @@ ILIAS_TEST(Net, Udp) {
     }
 }
 
+
+
+ILIAS_TEST(Net, UdpBatch) {
+    auto sender = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto receiver = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto endpoint = receiver.localEndpoint().value();
+    auto senderEndpoint = sender.localEndpoint().value();
+
+    UdpPacket packets [] = {
+        {"Hello"_bin, endpoint},
+        {", "_bin, endpoint},
+        {"World!"_bin, endpoint},
+    };
+    EXPECT_EQ(co_await sender.sendMany(packets), 3);
+
+    // Receive all of them, they are queued already
+    std::byte storage[4][64] {};
+    UdpPacketBuffer buffers [4] {};
+    for (size_t i = 0; i < 4; ++i) {
+        buffers[i].buffer = makeBuffer(storage[i]);
+    }
+    size_t received = 0;
+    while (received < 3) {
+        auto n = co_await receiver.recvMany(std::span(buffers).subspan(received));
+        EXPECT_TRUE(n);
+        if (!n) {
+            co_return;
+        }
+        received += *n;
+    }
+    EXPECT_EQ(received, 3);
+    EXPECT_EQ(buffers[0].size, 5);
+    EXPECT_EQ(buffers[1].size, 2);
+    EXPECT_EQ(buffers[2].size, 6);
+    EXPECT_EQ(buffers[2].endpoint, senderEndpoint);
+    EXPECT_EQ(std::string_view(reinterpret_cast<char *>(storage[2]), buffers[2].size), "World!");
+
+    // Test the cancel
+    auto handle = spawn(receiver.recvMany(buffers));
+    handle.stop();
+    EXPECT_FALSE((co_await std::move(handle)).has_value());
+}
+
+ILIAS_TEST(Net, UdpBatchEmpty) {
+    auto sender = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto receiver = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto endpoint = receiver.localEndpoint().value();
+    EXPECT_EQ(co_await sender.sendto("Hello"_bin, endpoint), 5); // Make the receiver readable
+
+    // The empty batch returns 0 at once, on the ready socket too
+    auto sent = co_await timeout(sender.sendMany({}), 200ms);
+    EXPECT_TRUE(sent);
+    if (sent) {
+        EXPECT_EQ(*sent, 0);
+    }
+    auto received = co_await timeout(receiver.recvMany({}), 200ms);
+    EXPECT_TRUE(received);
+    if (received) {
+        EXPECT_EQ(*received, 0);
+    }
+}
+
+#if defined(UDP_SEGMENT) && defined(UDP_GRO)
+ILIAS_TEST(Net, UdpSegments) {
+    auto sender = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto receiver = (co_await UdpSocket::bind("127.0.0.1:0")).value();
+    auto endpoint = receiver.localEndpoint().value();
+    EXPECT_TRUE(receiver.setOption(sockopt::UdpGro(true)));
+    EXPECT_TRUE(receiver.getOption<sockopt::UdpGro>().value());
+
+    // 3 full segments and a short tail
+    std::byte payload[350] {};
+    for (size_t i = 0; i < std::size(payload); ++i) {
+        payload[i] = std::byte(i / 100);
+    }
+    auto sent = co_await sender.sendSegments(payload, 100, endpoint);
+    if (!sent && sent.error() == SystemError(EIO)) { // No checksum offload on this device
+        co_return;
+    }
+    EXPECT_EQ(sent, 350);
+    EXPECT_EQ(co_await sender.sendSegments(payload, 0, endpoint), Err(IoError::InvalidArgument));
+    EXPECT_EQ(co_await sender.sendSegments(payload, 350 / (UdpSocket::MaxSegments + 1), endpoint), Err(IoError::InvalidArgument));
+
+    // Coalesced on GRO, or split into the datagrams
+    std::byte buffer[65536] {};
+    size_t received = 0;
+    while (received < 350) {
+        auto segments = co_await receiver.recvSegments(makeBuffer(buffer));
+        EXPECT_TRUE(segments);
+        if (!segments) {
+            co_return;
+        }
+        EXPECT_EQ(segments->segmentSize, std::min<size_t>(100, segments->size));
+        EXPECT_EQ(buffer[0], std::byte(received / 100));
+        received += segments->size;
+    }
+    EXPECT_EQ(received, 350);
+}
+#endif // defined(UDP_SEGMENT) && defined(UDP_GRO)
@@ -0,0 +1,144 @@
+#include <ilias/sync/broadcast.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/task.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ilias;
+using namespace std::literals;
+
+// MARK: Basic
+
+ILIAS_TEST(Broadcast, Basic) {
+    auto [sender, receiver] = broadcast::channel<std::string>(4);
+    auto receiver2 = sender.subscribe();
+    EXPECT_EQ(sender.receiverCount(), 2);
+    EXPECT_EQ(sender.send("Hello"), 2);
+    EXPECT_EQ(co_await receiver.recv(), "Hello");
+    EXPECT_EQ(co_await receiver2.recv(), "Hello");
+    EXPECT_EQ(receiver.tryRecv().error().reason, broadcast::RecvErrorKind::Empty);
+}
+
+ILIAS_TEST(Broadcast, Subscribe) {
+    auto [sender, receiver] = broadcast::channel<int>(4);
+    EXPECT_TRUE(sender.send(1));
+    auto late = sender.subscribe(); // Only the items after it
+    auto copy = receiver; // Same cursor as the original
+    EXPECT_EQ(sender.send(2), 3);
+    EXPECT_EQ(receiver.pending(), 2);
+    EXPECT_EQ(co_await receiver.recv(), 1);
+    EXPECT_EQ(co_await copy.recv(), 1);
+    EXPECT_EQ(co_await late.recv(), 2);
+    EXPECT_EQ(co_await copy.recv(), 2);
+    EXPECT_EQ(receiver.resubscribe().pending(), 0);
+}
+
+// MARK: Close
+
+ILIAS_TEST(Broadcast, Close) {
+    auto [sender, receiver] = broadcast::channel<int>(4);
+    EXPECT_TRUE(sender.send(1));
+    auto sender2 = sender;
+    sender.close();
+    EXPECT_FALSE(receiver.isClosed());
+    sender2.close();
+    EXPECT_TRUE(receiver.isClosed());
+    EXPECT_EQ(co_await receiver.recv(), 1); // Drain first
+    EXPECT_EQ((co_await receiver.recv()).error().reason, broadcast::RecvErrorKind::Closed);
+
+    // No receiver
+    auto [sender3, receiver3] = broadcast::channel<int>(4);
+    receiver3.close();
+    EXPECT_TRUE(sender3.isClosed());
+    EXPECT_EQ(sender3.send(42).error(), 42);
+}
+
+// MARK: Lagged
+
+ILIAS_TEST(Broadcast, Lagged) {
+    auto [sender, receiver] = broadcast::channel<int>(4);
+    for (int i = 0; i < 10; i++) { // The sender never waits
+        EXPECT_TRUE(sender.send(i));
+    }
+    auto res = receiver.tryRecv();
+    EXPECT_EQ(res.error().reason, broadcast::RecvErrorKind::Lagged);
+    EXPECT_EQ(res.error().lagged, 6);
+    for (int i = 6; i < 10; i++) { // Continue from the oldest one
+        EXPECT_EQ(co_await receiver.recv(), i);
+    }
+}
+
+// MARK: Wakeup
+
+ILIAS_TEST(Broadcast, WakeAll) {
+    auto [sender, receiver] = broadcast::channel<int>(16);
+    auto worker = [](broadcast::Receiver<int> receiver) -> Task<int> {
+        auto sum = 0;
+        while (true) {
+            auto res = co_await receiver.recv();
+            if (!res) {
+                EXPECT_EQ(res.error().reason, broadcast::RecvErrorKind::Closed);
+                break;
+            }
+            sum += *res;
+        }
+        co_return sum;
+    };
+    auto group = TaskGroup<int>();
+    for (int i = 0; i < 8; i++) {
+        group.spawn(worker(receiver));
+    }
+    receiver.close();
+    co_await this_coro::yield(); // Let all of them park
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_EQ(sender.send(i), 8);
+        co_await this_coro::yield();
+    }
+    sender.close();
+    auto results = co_await group.waitAll();
+    EXPECT_EQ(results.size(), 8);
+    for (auto sum : results) {
+        EXPECT_EQ(sum, 55);
+    }
+}
+
+ILIAS_TEST(Broadcast, CancelRecv) {
+    auto [sender, receiver] = broadcast::channel<int>(4);
+    auto handle = spawn([receiver]() mutable -> Task<void> {
+        auto _ = co_await receiver.recv();
+        ILIAS_TRAP();
+    });
+    handle.stop();
+    EXPECT_FALSE(co_await std::move(handle));
+}
+
+ILIAS_TEST(Broadcast, CrossThread) {
+    static constexpr auto N = 10000;
+    auto [sender, receiver] = broadcast::channel<int>(N); // Large enough, no lag
+    auto threads = std::vector<std::thread> {};
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([receiver]() mutable {
+            auto expected = 0;
+            while (true) {
+                auto res = receiver.blockingRecv();
+                if (!res) {
+                    EXPECT_EQ(res.error().reason, broadcast::RecvErrorKind::Closed);
+                    break;
+                }
+                EXPECT_EQ(*res, expected);
+                expected += 1;
+            }
+            EXPECT_EQ(expected, N);
+        });
+    }
+    receiver.close();
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(sender.send(i));
+    }
+    sender.close();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    co_return;
+}
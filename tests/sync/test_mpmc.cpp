@@ -397,6 +397,59 @@ ILIAS_TEST(Mpmc, ProducerConsumerPipeline) {
     EXPECT_TRUE(co_await std::move(handle));
 }
 
+// MARK: Batch
+
+ILIAS_TEST(Mpmc, Batch) {
+    auto [sender, receiver] = mpmc::channel<int>(4);
+    auto items = std::vector<int> {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // 10 items through the 4 slots, the sender waits on full
+    auto handle = spawn([sender = std::move(sender), &items]() mutable -> Task<void> {
+        EXPECT_EQ(co_await sender.sendMany(items), 10);
+        sender.close();
+    });
+    auto got = std::vector<int> {};
+    while (true) {
+        auto n = co_await receiver.recvMany(got, 3);
+        if (n == 0) {
+            break;
+        }
+        EXPECT_LE(n, 3);
+    }
+    EXPECT_TRUE(co_await std::move(handle));
+    EXPECT_EQ(got, items);
+}
+
+ILIAS_TEST(Mpmc, BatchSpan) {
+    auto [sender, receiver] = mpmc::channel<std::unique_ptr<int> >();
+    auto items = std::vector<std::unique_ptr<int> > {};
+    for (int i = 0; i < 5; i++) {
+        items.emplace_back(std::make_unique<int>(i));
+    }
+    EXPECT_EQ(co_await sender.sendMany(items), 5);
+    std::unique_ptr<int> buffer[4];
+    EXPECT_EQ(co_await receiver.recvMany(buffer), 4);
+    EXPECT_EQ(*buffer[3], 3);
+    EXPECT_EQ(co_await receiver.recvMany(buffer), 1);
+    EXPECT_EQ(*buffer[0], 4);
+    EXPECT_EQ(receiver.tryRecv(), Err(mpmc::TryRecvError::Empty));
+}
+
+ILIAS_TEST(Mpmc, BatchClosed) {
+    auto [sender, receiver] = mpmc::channel<int>(2);
+    auto items = std::vector<int> {1, 2, 3};
+    EXPECT_TRUE(co_await sender.send(0));
+    receiver.close();
+    EXPECT_EQ(co_await sender.sendMany(items), 0);
+
+    auto [sender2, receiver2] = mpmc::channel<int>(2);
+    EXPECT_TRUE(co_await sender2.send(1));
+    sender2.close();
+    auto got = std::vector<int> {};
+    EXPECT_EQ(co_await receiver2.recvMany(got, 8), 1);
+    EXPECT_EQ(co_await receiver2.recvMany(got, 8), 0);
+}
+
 // MARK: Cross thread
 
 ILIAS_TEST(Mpmc, BlockingSendCrossThread) {
@@ -443,3 +496,44 @@ ILIAS_TEST(Mpmc, CrossThreadMultiConsumer) {
     thread3.join();
     EXPECT_EQ(received.load(), 200);
 }
+
+ILIAS_TEST(Mpmc, StressCrossThread) {
+    constexpr auto Threads = 4;
+    constexpr auto Items = 10000;
+    auto [sender, receiver] = mpmc::channel<int>(7); // Not power of two, the capacity is still exact
+    auto sum = std::atomic<int64_t> {0};
+    auto count = std::atomic<int> {0};
+    auto threads = std::vector<std::thread> {};
+    for (int i = 0; i < Threads; i++) {
+        threads.emplace_back([sender]() {
+            for (int j = 0; j < Items; j++) {
+                if (j % 2 == 0) {
+                    EXPECT_TRUE(sender.blockingSend(j));
+                    continue;
+                }
+                while (true) { // Mix the try path, spin on full
+                    auto res = sender.trySend(j);
+                    if (res) {
+                        break;
+                    }
+                    EXPECT_EQ(res.error().reason, mpmc::TrySendError::Full);
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([receiver, &sum, &count]() mutable {
+            while (auto value = receiver.blockingRecv()) {
+                sum.fetch_add(*value, std::memory_order_relaxed);
+                count.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    EXPECT_EQ(sender.capacity(), 7);
+    sender.close(); // The consumers quit after the last producer thread drops its copy
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(count.load(), Threads * Items);
+    EXPECT_EQ(sum.load(), int64_t(Threads) * (int64_t(Items) * (Items - 1) / 2));
+    co_return;
+}
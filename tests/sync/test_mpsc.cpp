@@ -2,6 +2,7 @@
 #include <ilias/testing.hpp>
 #include <ilias/task.hpp>
 #include <set>
+#include <vector>
 
 using namespace ilias;
 using namespace std::literals;
@@ -296,6 +297,59 @@ ILIAS_TEST(Mpsc, ProducerConsumerPipeline) {
     EXPECT_TRUE(co_await std::move(handle));
 }
 
+// MARK: Batch
+
+ILIAS_TEST(Mpsc, Batch) {
+    auto [sender, receiver] = mpsc::channel<int>(4);
+    auto items = std::vector<int> {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // 10 items through the 4 slots, the sender waits on full
+    auto handle = spawn([sender = std::move(sender), &items]() mutable -> Task<void> {
+        EXPECT_EQ(co_await sender.sendMany(items), 10);
+        sender.close();
+    });
+    auto got = std::vector<int> {};
+    while (true) {
+        auto n = co_await receiver.recvMany(got, 3);
+        if (n == 0) {
+            break;
+        }
+        EXPECT_LE(n, 3);
+    }
+    EXPECT_TRUE(co_await std::move(handle));
+    EXPECT_EQ(got, items);
+}
+
+ILIAS_TEST(Mpsc, BatchSpan) {
+    auto [sender, receiver] = mpsc::channel<std::unique_ptr<int> >();
+    auto items = std::vector<std::unique_ptr<int> > {};
+    for (int i = 0; i < 5; i++) {
+        items.emplace_back(std::make_unique<int>(i));
+    }
+    EXPECT_EQ(co_await sender.sendMany(items), 5);
+    std::unique_ptr<int> buffer[4];
+    EXPECT_EQ(co_await receiver.recvMany(buffer), 4);
+    EXPECT_EQ(*buffer[3], 3);
+    EXPECT_EQ(co_await receiver.recvMany(buffer), 1);
+    EXPECT_EQ(*buffer[0], 4);
+    EXPECT_EQ(receiver.tryRecv(), Err(mpsc::TryRecvError::Empty));
+}
+
+ILIAS_TEST(Mpsc, BatchClosed) {
+    auto [sender, receiver] = mpsc::channel<int>(2);
+    auto items = std::vector<int> {1, 2, 3};
+    EXPECT_TRUE(co_await sender.send(0));
+    receiver.close();
+    EXPECT_EQ(co_await sender.sendMany(items), 0);
+
+    auto [sender2, receiver2] = mpsc::channel<int>(2);
+    EXPECT_TRUE(co_await sender2.send(1));
+    sender2.close();
+    auto got = std::vector<int> {};
+    EXPECT_EQ(co_await receiver2.recvMany(got, 8), 1);
+    EXPECT_EQ(co_await receiver2.recvMany(got, 8), 0);
+}
+
 // MARK: Cross thread
 
 ILIAS_TEST(Mpsc, BlockingSendCrossThread) {
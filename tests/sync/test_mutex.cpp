@@ -1,6 +1,7 @@
 #include <ilias/sync/mutex.hpp>
 #include <ilias/testing.hpp>
 #include <ilias/task.hpp>
+#include <vector>
 
 using namespace ilias;
 using namespace std::literals;
@@ -88,6 +89,27 @@ ILIAS_TEST(Sync, MutexCrossThread) {
     EXPECT_EQ(value, 300000);
 }
 
+ILIAS_TEST(Sync, MutexHandoff) {
+    Mutex mtx {sync::Fairness::Fifo};
+    std::vector<int> order;
+
+    auto lock = co_await mtx.lock();
+    auto group = TaskGroup<void>();
+    for (int i = 0; i < 8; ++i) {
+        group.spawn([&, i]() -> Task<void> {
+            auto _ = co_await mtx.lock();
+            order.push_back(i);
+        });
+    }
+    co_await this_coro::yield(); // Let all of them park
+    lock.unlock();
+    EXPECT_TRUE(mtx.isLocked()); // Handed to the head waiter, no one can barge in
+    EXPECT_FALSE(mtx.tryLock());
+    co_await group.waitAll();
+    EXPECT_EQ(order, (std::vector<int> {0, 1, 2, 3, 4, 5, 6, 7})); // FIFO
+    EXPECT_FALSE(mtx.isLocked());
+}
+
 // Locked
 ILIAS_TEST(Sync, Locked) {
     Locked<int> value {10};
@@ -0,0 +1,113 @@
+#include <ilias/sync/notify.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/task.hpp>
+#include <thread>
+#include <vector>
+
+using namespace ilias;
+using namespace std::literals;
+
+// MARK: Basic
+
+ILIAS_TEST(Notify, Permit) {
+    Notify notify;
+    EXPECT_FALSE(notify.tryNotified());
+    notify.notifyOne(); // No one waiting, keep the permit
+    notify.notifyOne(); // At most one
+    co_await notify.notified(); // Return at once
+    EXPECT_FALSE(notify.tryNotified());
+}
+
+ILIAS_TEST(Notify, NotifyOne) {
+    Notify notify;
+    std::vector<int> order;
+    auto group = TaskGroup<void>();
+    for (int i = 0; i < 4; ++i) {
+        group.spawn([&, i]() -> Task<void> {
+            co_await notify.notified();
+            order.push_back(i);
+        });
+    }
+    co_await this_coro::yield(); // Let all of them park
+    for (int i = 0; i < 4; ++i) {
+        notify.notifyOne();
+    }
+    EXPECT_FALSE(notify.tryNotified()); // All handed to the waiters
+    co_await group.waitAll();
+    EXPECT_EQ(order, (std::vector<int> {0, 1, 2, 3})); // FIFO
+}
+
+ILIAS_TEST(Notify, NotifyWaiters) {
+    Notify notify;
+    auto count = 0;
+    auto group = TaskGroup<void>();
+    for (int i = 0; i < 4; ++i) {
+        group.spawn([&]() -> Task<void> {
+            co_await notify.notified();
+            count += 1;
+        });
+    }
+    co_await this_coro::yield();
+    notify.notifyWaiters();
+    EXPECT_FALSE(notify.tryNotified()); // No permit kept
+    co_await group.waitAll();
+    EXPECT_EQ(count, 4);
+
+    // No one waiting, nothing happens
+    notify.notifyWaiters();
+    EXPECT_FALSE(notify.tryNotified());
+}
+
+ILIAS_TEST(Notify, NotifyWaitersBeforePark) {
+    Notify notify;
+    // The condition is checked, the awaiter is created, then the broadcast comes before it parks
+    auto awaiter = notify.notified();
+    notify.notifyWaiters();
+    co_await std::move(awaiter); // Return at once, the broadcast is not lost
+    EXPECT_FALSE(notify.tryNotified()); // No permit kept
+
+    // The awaiter created after the broadcast still waits
+    auto woken = false;
+    auto handle = spawn([&]() -> Task<void> {
+        co_await notify.notified();
+        woken = true;
+    });
+    co_await this_coro::yield();
+    EXPECT_FALSE(woken);
+    notify.notifyWaiters();
+    co_await std::move(handle);
+    EXPECT_TRUE(woken);
+}
+
+ILIAS_TEST(Notify, Cancel) {
+    Notify notify;
+    auto handle = spawn([&]() -> Task<void> {
+        co_await notify.notified();
+        ILIAS_TRAP(); // never reached
+    });
+    handle.stop();
+    EXPECT_FALSE(co_await std::move(handle));
+    notify.notifyOne(); // The cancelled one is gone, keep the permit
+    EXPECT_TRUE(notify.tryNotified());
+}
+
+// MARK: Cross thread
+
+ILIAS_TEST(Notify, CrossThread) {
+    static constexpr auto N = 10000;
+    Notify notify;
+    std::atomic<int> produced {0};
+    auto thread = std::thread([&]() {
+        for (int i = 0; i < N; ++i) {
+            produced.fetch_add(1, std::memory_order_release);
+            notify.notifyOne();
+        }
+    });
+    auto consumed = 0;
+    while (consumed < N) {
+        co_await notify.notified();
+        consumed = produced.load(std::memory_order_acquire); // Drain all of them, the wakeup is never lost
+    }
+    thread.join();
+    EXPECT_EQ(consumed, N);
+}
@@ -0,0 +1,155 @@
+#include <ilias/sync/rwlock.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/task.hpp>
+#include <thread>
+#include <vector>
+#include <map>
+
+using namespace ilias;
+using namespace std::literals;
+
+// MARK: Basic
+
+ILIAS_TEST(RwLock, Basic) {
+    RwMutex mtx;
+    auto r1 = co_await mtx.read();
+    auto r2 = co_await mtx.read(); // Readers share the lock
+    EXPECT_EQ(mtx.readerCount(), 2);
+    EXPECT_FALSE(mtx.tryWrite());
+
+    r1.unlock();
+    r2.unlock();
+    EXPECT_EQ(mtx.readerCount(), 0);
+
+    auto w = co_await mtx.write();
+    EXPECT_TRUE(mtx.isLocked());
+    EXPECT_FALSE(mtx.tryRead());
+    EXPECT_FALSE(mtx.tryWrite());
+    w.unlock();
+    EXPECT_FALSE(mtx.isLocked());
+    EXPECT_TRUE(mtx.tryRead());
+}
+
+ILIAS_TEST(RwLock, Value) {
+    RwLock<std::map<int, int> > table;
+    {
+        auto w = co_await table.write();
+        (*w)[1] = 42;
+    }
+    auto r1 = co_await table.read();
+    auto r2 = co_await table.read();
+    EXPECT_EQ(r1->at(1), 42);
+    EXPECT_EQ(r2->size(), 1);
+    EXPECT_FALSE(table.tryWrite());
+}
+
+// MARK: Preference
+
+ILIAS_TEST(RwLock, WriterPreference) {
+    RwMutex mtx;
+    auto order = std::vector<int> {};
+    auto reader = co_await mtx.read();
+    auto writer = spawn([&]() -> Task<void> {
+        auto _ = co_await mtx.write();
+        order.push_back(1);
+    });
+    co_await this_coro::yield(); // Let the writer wait
+    EXPECT_FALSE(mtx.tryRead()); // The new reader is blocked by the waiting writer
+    auto lateReader = spawn([&]() -> Task<void> {
+        auto _ = co_await mtx.read();
+        order.push_back(2);
+    });
+    co_await this_coro::yield();
+    EXPECT_TRUE(order.empty());
+    reader.unlock(); // Hand off to the writer, then the late reader
+    co_await std::move(writer);
+    co_await std::move(lateReader);
+    EXPECT_EQ(order, (std::vector<int> {1, 2}));
+}
+
+ILIAS_TEST(RwLock, CancelWrite) {
+    RwMutex mtx;
+    auto reader = co_await mtx.read();
+    auto handle = spawn([&]() -> Task<void> {
+        auto _ = co_await mtx.write();
+        ILIAS_TRAP(); // never reached
+    });
+    co_await this_coro::yield();
+    EXPECT_FALSE(mtx.tryRead());
+    handle.stop();
+    EXPECT_FALSE(co_await std::move(handle));
+    EXPECT_TRUE(mtx.tryRead()); // The readers are let in again
+}
+
+// MARK: Upgrade
+
+ILIAS_TEST(RwLock, Upgrade) {
+    RwMutex mtx;
+    auto upgradable = co_await mtx.upgradableRead();
+    EXPECT_FALSE(mtx.tryUpgradableRead()); // Only one at a time
+    auto reader = co_await mtx.read(); // But it shares with the readers
+    EXPECT_FALSE(upgradable.tryUpgrade());
+
+    auto handle = spawn([&]() -> Task<void> {
+        auto _ = co_await mtx.read();
+    });
+    auto upgrade = spawn([&]() -> Task<void> {
+        auto w = co_await upgradable.upgrade();
+        EXPECT_TRUE(mtx.isLocked());
+        EXPECT_EQ(mtx.readerCount(), 0);
+        auto r = w.downgrade(); // Back to the reader
+        EXPECT_FALSE(mtx.isLocked());
+        EXPECT_EQ(mtx.readerCount(), 1);
+    });
+    co_await this_coro::yield();
+    EXPECT_FALSE(mtx.tryRead()); // The new readers are blocked while upgrading
+    reader.unlock();
+    co_await std::move(upgrade);
+    co_await std::move(handle);
+    EXPECT_EQ(mtx.readerCount(), 0);
+    EXPECT_FALSE(mtx.isLocked());
+    EXPECT_TRUE(mtx.tryUpgradableRead()); // The upgradable guard is moved into the write guard
+}
+
+ILIAS_TEST(RwLock, UpgradeValue) {
+    RwLock<int> value {1};
+    auto guard = co_await value.upgradableRead();
+    EXPECT_EQ(*guard, 1);
+    auto w = co_await value.upgrade(guard);
+    *w = 2;
+    w.unlock();
+    EXPECT_EQ(*co_await value.read(), 2);
+}
+
+// MARK: Cross thread
+
+ILIAS_TEST(RwLock, CrossThread) {
+    static constexpr auto N = 20000;
+    RwLock<std::pair<int, int> > value; // The readers must always see first == second
+    auto threads = std::vector<std::thread> {};
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < N; j++) {
+                if ((i == 0 && j % 10 == 0) || (i == 1 && j % 100 == 0)) {
+                    auto w = value.blockingWrite();
+                    w->first += 1;
+                    w->second += 1;
+                    continue;
+                }
+                auto r = value.blockingRead();
+                EXPECT_EQ(r->first, r->second);
+            }
+        });
+    }
+    for (int j = 0; j < N / 10; j++) {
+        auto w = co_await value.write();
+        w->first += 1;
+        w->second += 1;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto r = co_await value.read();
+    EXPECT_EQ(r->first, N / 10 + N / 10 + N / 100);
+    EXPECT_EQ(r->second, r->first);
+}
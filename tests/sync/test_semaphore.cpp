@@ -1,5 +1,7 @@
+#include <ilias/sync/admission.hpp>
 #include <ilias/sync/semaphore.hpp>
 #include <ilias/testing.hpp>
+#include <vector>
 
 using namespace ilias;
 using namespace std::literals;
@@ -29,3 +31,124 @@ ILIAS_TEST(Sync, Semaphore) {
     auto _ = co_await whenAll(fn(), thread.join());
     EXPECT_EQ(sem.available(), 8);
 }
+
+ILIAS_TEST(Sync, SemaphoreHandoff) {
+    Semaphore sem(1, sync::Fairness::Fifo);
+    std::vector<int> order;
+
+    auto premit = co_await sem.acquire();
+    auto group = TaskGroup<void>();
+    for (int i = 0; i < 8; ++i) {
+        group.spawn([&, i]() -> Task<void> {
+            auto _ = co_await sem.acquire();
+            order.push_back(i);
+        });
+    }
+    co_await this_coro::yield(); // Let all of them park
+    { auto _ = std::move(premit); }
+    EXPECT_EQ(sem.available(), 0); // Handed to the head waiter, no one can barge in
+    EXPECT_FALSE(sem.tryAcquire());
+    co_await group.waitAll();
+    EXPECT_EQ(order, (std::vector<int> {0, 1, 2, 3, 4, 5, 6, 7})); // FIFO
+    EXPECT_EQ(sem.available(), 1);
+}
+
+// MARK: Weighted
+ILIAS_TEST(Sync, SemaphoreWeighted) {
+    Semaphore sem(10);
+    auto a = co_await sem.acquire(4);
+    EXPECT_EQ(a.count(), 4);
+    EXPECT_EQ(sem.available(), 6);
+    EXPECT_FALSE(sem.tryAcquire(7));
+    auto b = sem.tryAcquire(6);
+    EXPECT_TRUE(b);
+    EXPECT_EQ(sem.available(), 0);
+
+    // The heavy one at the head is not starved by the light ones behind it
+    std::vector<int> order;
+    auto group = TaskGroup<void>();
+    group.spawn([&]() -> Task<void> {
+        auto _ = co_await sem.acquire(8);
+        order.push_back(8);
+    });
+    co_await this_coro::yield();
+    group.spawn([&]() -> Task<void> {
+        auto _ = co_await sem.acquire(1);
+        order.push_back(1);
+    });
+    co_await this_coro::yield();
+    { auto _ = std::move(a); } // Not enough for the head one
+    EXPECT_EQ(sem.available(), 4);
+    EXPECT_TRUE(order.empty());
+    { auto _ = std::move(*b); }
+    co_await group.waitAll();
+    EXPECT_EQ(order, (std::vector<int> {8, 1}));
+    EXPECT_EQ(sem.available(), 10);
+}
+
+ILIAS_TEST(Sync, SemaphoreWeightedFifo) {
+    Semaphore sem(4, sync::Fairness::Fifo);
+    std::vector<int> order;
+    auto group = TaskGroup<void>();
+    group.spawn([&]() -> Task<void> {
+        auto _ = co_await sem.acquire(8);
+        order.push_back(8);
+    });
+    co_await this_coro::yield();
+
+    // The free permits are enough for the light newcomers, but they can't overtake the heavy one
+    EXPECT_FALSE(sem.tryAcquire(1));
+    group.spawn([&]() -> Task<void> {
+        auto _ = co_await sem.acquire(1);
+        order.push_back(1);
+    });
+    co_await this_coro::yield();
+    EXPECT_TRUE(order.empty());
+    EXPECT_EQ(sem.available(), 4);
+
+    sem.addPremits(4);
+    co_await group.waitAll();
+    EXPECT_EQ(order, (std::vector<int> {8, 1}));
+    EXPECT_EQ(sem.available(), 8);
+}
+
+ILIAS_TEST(Sync, SemaphoreTimed) {
+    Semaphore sem(2);
+    auto a = co_await sem.acquireFor(10ms, 2);
+    EXPECT_TRUE(a);
+    EXPECT_FALSE(co_await sem.acquireFor(10ms)); // Timeout
+    EXPECT_EQ(sem.available(), 0);
+    auto task = spawn([&]() -> Task<void> {
+        co_await sleep(5ms);
+        { auto _ = std::move(*a); }
+    });
+    auto b = co_await sem.acquireFor(1s);
+    EXPECT_TRUE(b);
+    co_await std::move(task);
+}
+
+// MARK: Admission
+ILIAS_TEST(Sync, AdmissionShed) {
+    AdmissionController controller({.capacity = 2, .target = 1ms, .interval = 10ms});
+    auto a = co_await controller.admit(2);
+    EXPECT_TRUE(a);
+    EXPECT_FALSE(controller.isOverloaded());
+
+    // The queue keeps standing, waits are above the target through the whole interval
+    for (int i = 0; i < 8 && !controller.isOverloaded(); i++) {
+        EXPECT_FALSE(co_await controller.admit());
+    }
+    EXPECT_TRUE(controller.isOverloaded());
+    EXPECT_GE(controller.shedCount(), 2);
+
+    // Overloaded, only wait up to the target, fail fast
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(co_await controller.admit());
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 10ms);
+
+    // Recover once the waits drop below the target
+    { auto _ = std::move(*a); }
+    co_await sleep(10ms);
+    EXPECT_TRUE(co_await controller.admit());
+    EXPECT_FALSE(controller.isOverloaded());
+}
@@ -0,0 +1,157 @@
+#include <ilias/sync/spsc.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/task.hpp>
+#include <numeric>
+#include <vector>
+
+using namespace ilias;
+using namespace std::literals;
+
+// MARK: Basic
+
+ILIAS_TEST(Spsc, Basic) {
+    auto [sender, receiver] = spsc::channel<int>(10);
+    EXPECT_TRUE(co_await sender.send(42));
+    EXPECT_EQ(co_await receiver.recv(), 42);
+}
+
+ILIAS_TEST(Spsc, Capacity) {
+    auto [sender, receiver] = spsc::channel<int>(3);
+    EXPECT_EQ(sender.capacity(), 4); // Rounded up to the power of two
+    EXPECT_EQ(receiver.capacity(), 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(sender.trySend(i));
+    }
+    EXPECT_EQ(sender.trySend(4).error().reason, spsc::TrySendError::Full);
+    EXPECT_EQ(co_await receiver.recv(), 0);
+    EXPECT_TRUE(sender.trySend(4));
+    for (int i = 1; i < 5; i++) {
+        EXPECT_EQ(co_await receiver.recv(), i);
+    }
+}
+
+ILIAS_TEST(Spsc, MoveOnly) {
+    auto [sender, receiver] = spsc::channel<std::unique_ptr<int> >(10);
+    EXPECT_TRUE(co_await sender.send(std::make_unique<int>(42)));
+    auto res = co_await receiver.recv();
+    EXPECT_TRUE(res);
+    EXPECT_EQ(**res, 42);
+}
+
+// MARK: Close
+
+ILIAS_TEST(Spsc, Close) {
+    {
+        auto [sender, receiver] = spsc::channel<int>(4);
+        EXPECT_TRUE(co_await sender.send(1));
+        sender.close();
+        EXPECT_TRUE(receiver.isClosed());
+        EXPECT_EQ(co_await receiver.recv(), 1); // The items sent before the close are still received
+        EXPECT_FALSE(co_await receiver.recv());
+        EXPECT_EQ(receiver.tryRecv(), Err(spsc::TryRecvError::Closed));
+    }
+    {
+        auto [sender, receiver] = spsc::channel<int>(4);
+        receiver.close();
+        EXPECT_TRUE(sender.isClosed());
+        auto res = co_await sender.send(42);
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error(), 42);
+        EXPECT_EQ(sender.trySend(42).error().reason, spsc::TrySendError::Closed);
+    }
+}
+
+ILIAS_TEST(Spsc, TryRecv) {
+    auto [sender, receiver] = spsc::channel<int>(1);
+    EXPECT_EQ(receiver.tryRecv(), Err(spsc::TryRecvError::Empty));
+    EXPECT_TRUE(sender.trySend(42));
+    EXPECT_EQ(receiver.tryRecv(), 42);
+    co_return;
+}
+
+// MARK: Backpressure
+
+ILIAS_TEST(Spsc, SendBlocksWhenFull) {
+    auto [sender, receiver] = spsc::channel<int>(1);
+    EXPECT_TRUE(co_await sender.send(1));
+    auto handle = spawn([sender = std::move(sender)]() mutable -> Task<void> {
+        EXPECT_TRUE(co_await sender.send(2));
+    });
+    co_await this_coro::yield();
+    EXPECT_EQ(co_await receiver.recv(), 1);
+    EXPECT_EQ(co_await receiver.recv(), 2);
+    EXPECT_TRUE(co_await std::move(handle));
+}
+
+ILIAS_TEST(Spsc, CancelRecv) {
+    auto [sender, receiver] = spsc::channel<int>(4);
+    auto handle = spawn([receiver = std::move(receiver)]() mutable -> Task<void> {
+        co_await receiver.recv();
+        ILIAS_TRAP();
+    });
+    handle.stop();
+    EXPECT_FALSE(co_await std::move(handle));
+}
+
+// MARK: Batch
+
+ILIAS_TEST(Spsc, Batch) {
+    auto [sender, receiver] = spsc::channel<int>(4);
+    auto items = std::vector<int>(10);
+    std::iota(items.begin(), items.end(), 0);
+
+    // 10 items through the 4 slots, the sender parks on full
+    auto handle = spawn([&sender, &items]() -> Task<void> {
+        EXPECT_EQ(co_await sender.sendMany(items), 10);
+        sender.close();
+    });
+    auto got = std::vector<int> {};
+    while (true) {
+        auto n = co_await receiver.recvMany(got, 3);
+        if (n == 0) {
+            break;
+        }
+        EXPECT_LE(n, 3);
+    }
+    EXPECT_TRUE(co_await std::move(handle));
+    EXPECT_EQ(got, items);
+}
+
+ILIAS_TEST(Spsc, SendManyOnClosed) {
+    auto [sender, receiver] = spsc::channel<int>(2);
+    auto items = std::vector<int> {1, 2, 3, 4};
+    auto handle = spawn([&]() -> Task<void> {
+        EXPECT_EQ(co_await receiver.recv(), 1);
+        co_await this_coro::yield(); // Let the sender fill the free slot
+        receiver.close();
+    });
+    EXPECT_EQ(co_await sender.sendMany(items), 3); // 2 filled, 1 after the receiver took one, then closed
+    EXPECT_TRUE(co_await std::move(handle));
+}
+
+// MARK: Cross thread
+
+ILIAS_TEST(Spsc, CrossThread) {
+    constexpr auto N = 100000;
+    auto [sender, receiver] = spsc::channel<int>(64);
+    auto thread = std::thread([sender = std::move(sender)]() mutable {
+        for (int i = 0; i < N; i++) {
+            EXPECT_TRUE(sender.blockingSend(i));
+        }
+    });
+    auto got = std::vector<int> {};
+    auto expected = 0;
+    while (true) {
+        got.clear();
+        auto n = co_await receiver.recvMany(got, 32);
+        if (n == 0) {
+            break;
+        }
+        for (auto v : got) {
+            EXPECT_EQ(v, expected);
+            expected += 1;
+        }
+    }
+    EXPECT_EQ(expected, N);
+    thread.join();
+}
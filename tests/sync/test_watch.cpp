@@ -0,0 +1,135 @@
+#include <ilias/sync/watch.hpp>
+#include <ilias/testing.hpp>
+#include <ilias/task.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ilias;
+using namespace std::literals;
+
+// MARK: Basic
+
+ILIAS_TEST(Watch, Basic) {
+    auto [sender, receiver] = watch::channel<std::string>("init");
+    EXPECT_FALSE(receiver.hasChanged()); // The initial value is seen
+    EXPECT_EQ(*receiver.borrow(), "init");
+
+    sender.send("v1");
+    EXPECT_TRUE(receiver.hasChanged());
+    EXPECT_TRUE(co_await receiver.changed());
+    EXPECT_FALSE(receiver.hasChanged());
+    {
+        auto ref = receiver.borrow(); // No copy
+        EXPECT_EQ(ref->size(), 2);
+        EXPECT_EQ(*ref, "v1");
+        EXPECT_FALSE(ref.hasChanged());
+    }
+    EXPECT_EQ(sender.sendReplace("v2"), "v1");
+    {
+        auto ref = receiver.borrowAndUpdate();
+        EXPECT_TRUE(ref.hasChanged());
+        EXPECT_EQ(*ref, "v2");
+    }
+    EXPECT_FALSE(receiver.hasChanged());
+}
+
+ILIAS_TEST(Watch, Modify) {
+    auto [sender, receiver] = watch::channel<std::vector<int> >();
+    sender.sendModify([](auto &vec) { vec.push_back(1); });
+    EXPECT_TRUE(receiver.hasChanged());
+    receiver.markSeen();
+    EXPECT_FALSE(sender.sendIfModified([](auto &) { return false; }));
+    EXPECT_FALSE(receiver.hasChanged());
+    EXPECT_TRUE(sender.sendIfModified([](auto &vec) { vec.push_back(2); return true; }));
+    EXPECT_TRUE(receiver.hasChanged());
+    EXPECT_EQ(sender.borrow()->size(), 2);
+    receiver.markSeen();
+    receiver.markChanged();
+    EXPECT_TRUE(co_await receiver.changed());
+}
+
+// MARK: Skip
+
+ILIAS_TEST(Watch, SkipIntermediate) {
+    auto [sender, receiver] = watch::channel<int>(0);
+    auto handle = spawn([receiver]() mutable -> Task<std::vector<int> > {
+        auto values = std::vector<int> {};
+        while (true) {
+            auto changed = co_await receiver.changed();
+            if (!changed) {
+                break;
+            }
+            values.push_back(*receiver.borrow());
+        }
+        co_return values;
+    });
+    co_await this_coro::yield();
+    for (int i = 1; i <= 100; i++) { // The sender never waits, the receiver only sees the latest one
+        sender.send(i);
+    }
+    co_await this_coro::yield();
+    sender.send(200);
+    sender.close();
+    auto values = co_await std::move(handle);
+    EXPECT_TRUE(values);
+    if (!values) {
+        co_return;
+    }
+    EXPECT_LE(values->size(), 3);
+    EXPECT_EQ(values->back(), 200);
+}
+
+// MARK: Lifetime
+
+ILIAS_TEST(Watch, Subscribe) {
+    auto [sender, receiver] = watch::channel<int>(1);
+    sender.send(2);
+    auto receiver2 = sender.subscribe(); // The current one is seen
+    EXPECT_EQ(sender.receiverCount(), 2);
+    EXPECT_TRUE(receiver.hasChanged());
+    EXPECT_FALSE(receiver2.hasChanged());
+    receiver.close();
+    receiver2.close();
+    EXPECT_TRUE(sender.isClosed());
+    sender.send(3); // Still stored
+    EXPECT_EQ(*sender.subscribe().borrow(), 3);
+    co_return;
+}
+
+ILIAS_TEST(Watch, Close) {
+    auto [sender, receiver] = watch::channel<int>(1);
+    auto handle = spawn([receiver]() mutable -> Task<bool> {
+        co_return co_await receiver.changed();
+    });
+    co_await this_coro::yield();
+    sender.close();
+    EXPECT_TRUE(receiver.isClosed());
+    EXPECT_EQ(co_await std::move(handle), false);
+    EXPECT_EQ(*receiver.borrow(), 1); // The last value is still there
+}
+
+ILIAS_TEST(Watch, CrossThread) {
+    auto [sender, receiver] = watch::channel<int>(0);
+    auto threads = std::vector<std::thread> {};
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([receiver]() mutable {
+            auto last = 0;
+            while (receiver.blockingChanged()) {
+                auto value = *receiver.borrow();
+                EXPECT_GE(value, last); // Monotonic
+                last = value;
+            }
+            EXPECT_EQ(*receiver.borrow(), 1000);
+        });
+    }
+    receiver.close();
+    for (int i = 1; i <= 1000; i++) {
+        sender.send(i);
+    }
+    sender.close();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    co_return;
+}
@@ -0,0 +1,125 @@
+#include <ilias/task/local.hpp>
+#include <ilias/task/group.hpp>
+#include <ilias/task/scope.hpp>
+#include <ilias/testing.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std::literals;
+using namespace ilias;
+
+#if defined(ILIAS_TASK_LOCAL)
+
+static TaskLocal<int> intLocal;
+static TaskLocal<std::string> strLocal;
+
+auto getInt() -> Task<int> {
+    auto value = intLocal.get();
+    co_return value ? *value : -1;
+}
+
+auto getIntAfterSleep() -> Task<int> {
+    co_await sleep(10ms);
+    co_return co_await getInt();
+}
+
+ILIAS_TEST(TaskLocal, Basic) {
+    EXPECT_EQ(intLocal.get(), nullptr);
+    co_await intLocal.set(42);
+    EXPECT_EQ(*intLocal.get(), 42);
+    EXPECT_EQ(strLocal.get(), nullptr);
+
+    co_await strLocal.set("Hello");
+    EXPECT_EQ(*strLocal.get(), "Hello");
+    EXPECT_EQ(*intLocal.get(), 42);
+
+    // Keep it after the suspend
+    co_await sleep(10ms);
+    EXPECT_EQ(*intLocal.get(), 42);
+    EXPECT_EQ(co_await getInt(), 42); // The task in the same context
+}
+
+ILIAS_TEST(TaskLocal, OutsideTask) {
+    co_await intLocal.set(1);
+
+    // The callback in the executor is not in any task
+    auto &executor = co_await this_coro::executor();
+    auto called = false;
+    auto value = &called;
+    executor.schedule([&]() {
+        value = intLocal.get() ? &called : nullptr;
+        called = true;
+    });
+    co_await sleep(10ms);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(value, nullptr);
+    EXPECT_EQ(*intLocal.get(), 1);
+}
+
+ILIAS_TEST(TaskLocal, Scope) {
+    EXPECT_EQ(co_await intLocal.scope(1, getInt()), 1);
+    EXPECT_EQ(intLocal.get(), nullptr); // Restored
+
+    co_await intLocal.set(2);
+    EXPECT_EQ(co_await intLocal.scope(3, getIntAfterSleep()), 3);
+    EXPECT_EQ(*intLocal.get(), 2);
+}
+
+ILIAS_TEST(TaskLocal, Spawn) {
+    co_await intLocal.set(10);
+    EXPECT_EQ(co_await spawn(getIntAfterSleep()), 10);
+
+    // Set in the child doesn't affect the parent
+    auto handle = spawn([]() -> Task<int> {
+        co_await intLocal.set(11);
+        co_await sleep(10ms);
+        co_return *intLocal.get();
+    });
+    EXPECT_EQ(co_await std::move(handle), 11);
+    EXPECT_EQ(*intLocal.get(), 10);
+}
+
+ILIAS_TEST(TaskLocal, WhenAllAny) {
+    co_await intLocal.set(20);
+    auto [a, b] = co_await whenAll(getInt(), getIntAfterSleep());
+    EXPECT_EQ(a, 20);
+    EXPECT_EQ(b, 20);
+
+    auto [c, d] = co_await whenAny(getIntAfterSleep(), sleep(1s));
+    EXPECT_EQ(*c, 20);
+}
+
+ILIAS_TEST(TaskLocal, ScopeAndGroup) {
+    co_await intLocal.set(30);
+    {
+        auto scope = TaskScope {};
+        scope.spawn([]() -> Task<void> {
+            EXPECT_EQ(co_await getIntAfterSleep(), 30);
+        });
+        co_await scope.waitAll();
+    }
+    {
+        auto group = TaskGroup<int> {};
+        group.spawn(getIntAfterSleep());
+        group.spawn(intLocal.scope(31, getIntAfterSleep()));
+        auto vec = co_await group.waitAll();
+        EXPECT_EQ(vec.size(), 2);
+        EXPECT_EQ(vec[0] + vec[1], 61);
+    }
+}
+
+ILIAS_TEST(TaskLocal, Interleave) {
+    // Each task should see its own value, even they are interleaved in the same thread
+    auto worker = [](int value) -> Task<void> {
+        co_await intLocal.set(value);
+        for (int i = 0; i < 10; i++) {
+            co_await this_coro::yield();
+            EXPECT_EQ(*intLocal.get(), value);
+            EXPECT_EQ(co_await getInt(), value);
+        }
+    };
+    co_await whenAll(worker(1), worker(2), worker(3));
+    EXPECT_EQ(intLocal.get(), nullptr);
+}
+
+#endif // ILIAS_TASK_LOCAL
@@ -2,9 +2,12 @@
 #include <ilias/task/group.hpp>
 #include <ilias/task/utils.hpp>
 #include <ilias/task/scope.hpp>
+#include <ilias/task/switch.hpp>
+#include <ilias/runtime/queue.hpp>
 #include <ilias/testing.hpp>
 #include <gtest/gtest.h>
 #include <ranges>
+#include <thread>
 #include "subscriber.hpp"
 
 using namespace std::literals;
@@ -287,4 +290,112 @@ ILIAS_TEST(Task, StopToken) {
         stopSource.request_stop();
         EXPECT_TRUE(co_await std::move(handle)); // This token is stopped
     }
-}
\ No newline at end of file
+}
+
+TEST(Task, ReadyQueue) {
+    auto queue = runtime::ReadyQueue {{4, 2, 1}};
+    auto fn = [](void *) {};
+    auto highs = 0;
+    for (int i = 0; i < 16; i++) {
+        queue.push({fn, &highs}, Priority::High);
+        queue.push({fn, nullptr}, Priority::Background);
+    }
+    EXPECT_EQ(queue.size(), 32);
+    EXPECT_EQ(queue.stats(Priority::High).depth, 16);
+    EXPECT_EQ(queue.stats(Priority::Background).depth, 16);
+
+    // Each round: 4 High, then 1 Background, so the Background can't be starved
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 4; i++) {
+            EXPECT_EQ(queue.pop().second, &highs);
+        }
+        EXPECT_EQ(queue.pop().second, nullptr);
+    }
+    EXPECT_EQ(queue.stats(Priority::High).count, 16);
+    EXPECT_EQ(queue.stats(Priority::High).depth, 0);
+    EXPECT_EQ(queue.stats(Priority::Background).count, 4);
+    while (!queue.empty()) {
+        EXPECT_EQ(queue.pop().second, nullptr);
+    }
+    EXPECT_EQ(queue.stats(Priority::Background).count, 16);
+}
+
+ILIAS_TEST(Task, Priority) {
+    auto order = std::vector<Priority> {};
+    auto worker = [&]() -> Task<void> {
+        order.push_back(co_await this_coro::priority());
+        co_return;
+    };
+    EXPECT_EQ(co_await this_coro::priority(), Priority::Normal);
+
+    // The higher priority should run first
+    auto h1 = spawn(worker(), {.priority = Priority::Background});
+    auto h2 = spawn(worker(), {.priority = Priority::Normal});
+    auto h3 = spawn(worker(), {.priority = Priority::High});
+    co_await std::move(h1);
+    co_await std::move(h2);
+    co_await std::move(h3);
+    EXPECT_EQ(order, (std::vector {Priority::High, Priority::Normal, Priority::Background}));
+
+    // Inherit from the spawner
+    co_await this_coro::setPriority(Priority::High);
+    EXPECT_EQ(co_await spawn([]() -> Task<Priority> {
+        co_return co_await this_coro::priority();
+    }), Priority::High);
+    EXPECT_EQ(std::get<0>(co_await whenAll(this_coro::priority())), Priority::High);
+    co_await this_coro::setPriority(Priority::Normal);
+}
+
+ILIAS_TEST(Task, SwitchTo) {
+    auto &home = co_await this_coro::executor();
+    auto loop = EventLoop {};
+    auto source = std::stop_source {};
+    auto thread = std::thread([&]() {
+        loop.install();
+        loop.run(source.get_token());
+        loop.uninstall();
+    });
+    auto id = thread.get_id();
+
+    // Normal
+    co_await this_coro::setPriority(Priority::High);
+    co_await this_coro::switchTo(loop);
+    EXPECT_EQ(std::this_thread::get_id(), id);
+    EXPECT_EQ(&co_await this_coro::executor(), &loop);
+    EXPECT_EQ(co_await this_coro::priority(), Priority::High); // The context is moved
+    co_await this_coro::switchTo(loop); // No-op on already there
+    EXPECT_EQ(std::this_thread::get_id(), id);
+    co_await this_coro::switchTo(home);
+    EXPECT_NE(std::this_thread::get_id(), id);
+    EXPECT_EQ(&co_await this_coro::executor(), &home);
+    co_await this_coro::setPriority(Priority::Normal);
+
+    // Stop before the switch, it should never arrive
+    auto arrived = false;
+    auto handle = spawn([&]() -> Task<void> {
+        co_await this_coro::switchTo(loop);
+        arrived = true;
+        co_await this_coro::switchTo(home);
+    });
+    handle.stop();
+    EXPECT_FALSE(co_await std::move(handle));
+    EXPECT_FALSE(arrived);
+
+    // Batch
+    {
+        auto batch = SwitchBatch {loop};
+        auto worker = [&](int value) -> Task<int> {
+            co_await this_coro::switchTo(batch);
+            EXPECT_EQ(std::this_thread::get_id(), id);
+            co_await this_coro::yield(); // Run on the loop
+            co_await this_coro::switchTo(home);
+            co_return value;
+        };
+        auto [a, b, c] = co_await whenAll(worker(1), worker(2), worker(3));
+        EXPECT_EQ(a + b + c, 6);
+    }
+    EXPECT_EQ(loop.queueStats(Priority::High).count, 1); // Only the first switch, with the priority of the context
+
+    source.request_stop();
+    thread.join();
+}
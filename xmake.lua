@@ -22,6 +22,7 @@ option("io_uring",   {default = false,     description = "Use io uring as platfo
 option("coro_trace", {default = false,     description = "Add coroutine trace for debug use"})
 option("tls",        {default = true,      description = "Enable tls support"})
 option("fiber",      {default = true,      description = "Enable stackful coroutine 'fiber' support"})
+option("task_local", {default = true,      description = "Enable task local storage, track the running coroutine on each suspend"})
 option("modules",    {default = false,     description = "Enable c++ modules support"})
 
 -- No-op Options (leave for compatibility)